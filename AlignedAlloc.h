@@ -0,0 +1,43 @@
+/**
+ * Filename: AlignedAlloc.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef ALIGNEDALLOC_H
+#define ALIGNEDALLOC_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+// alignment of the objects shared between threads, one cache line
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * To allocate a_size bytes starting on a multiple of a_alignment, a power of two. Plain new only
+ * guarantees the alignment of the largest standard type before C++17, not the alignas() of a type
+ * kept on its own cache line. Throws bad_alloc if there is no memory left.
+ */
+inline void* alignedAlloc(size_t a_size, size_t a_alignment = CACHE_LINE_SIZE) {
+	// the block returned by malloc is stored just before the aligned address
+	void* block = malloc(a_size + a_alignment + sizeof(void*));
+	if (block == NULL) throw bad_alloc();
+
+	uintptr_t address = ((uintptr_t)block + sizeof(void*) + a_alignment - 1) & ~(uintptr_t)(a_alignment - 1);
+	((void**)address)[-1] = block;
+	return (void*)address;
+}
+
+
+/**
+ * To free memory allocated by alignedAlloc().
+ */
+inline void alignedFree(void* a_pointer) {
+	if (a_pointer != NULL) free(((void**)a_pointer)[-1]);
+}
+
+#endif
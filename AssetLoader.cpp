@@ -0,0 +1,205 @@
+/**
+ * Filename: AssetLoader.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "AssetLoader.h"
+#include "chai3d.h"
+#include <chrono>
+
+using namespace chai3d;
+using namespace std;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+AssetLoader::AssetLoader() {
+	m_running = false;
+	m_finished.store(0);
+	m_done = 0;
+	m_total = 0;
+}
+
+
+AssetLoader::~AssetLoader() {
+	stop();
+}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To start up to a_threadCount worker threads, at most ASSET_MAX_THREADS. Returns the number started.
+ */
+unsigned int AssetLoader::start(unsigned int a_threadCount) {
+	stop();
+
+	m_running = true;
+	m_finished.store(0);
+	for (unsigned int i = 0; i < cMin(a_threadCount, ASSET_MAX_THREADS); i++) {
+		m_threads.push_back(new cThread());
+	}
+	for (unsigned int i = 0; i < m_threads.size(); i++) {
+		m_threads[i]->start(workerLoop, CTHREAD_PRIORITY_GRAPHICS, this);
+	}
+	return (unsigned int)m_threads.size();
+}
+
+
+/**
+ * To let the workers finish the loads still queued and stop them.
+ */
+void AssetLoader::stop() {
+	if (m_threads.empty()) return;
+
+	{
+		lock_guard<mutex> lock(m_lock);
+		m_running = false;
+	}
+	m_wakeup.notify_all();
+	while (m_finished.load() < m_threads.size()) { cSleepMs(1); }
+
+	for (unsigned int i = 0; i < m_threads.size(); i++) delete m_threads[i];
+	m_threads.clear();
+}
+
+
+/**
+ * To queue a load for the workers. The future holds what a_load returned once it has run, or false
+ * if it threw. Without workers the load runs before this returns.
+ */
+shared_future<bool> AssetLoader::load(const string& a_name, const function<bool()>& a_load) {
+	Job job;
+	job.name = a_name;
+	job.load = a_load;
+	job.result = make_shared<promise<bool>>();
+	shared_future<bool> result = job.result->get_future().share();
+
+	{
+		lock_guard<mutex> lock(m_lock);
+		m_total++;
+		if (m_running && !m_threads.empty()) {
+			m_jobs.push_back(job);
+			m_wakeup.notify_one();
+			return result;
+		}
+	}
+
+	finish(job);
+	return result;
+}
+
+
+/**
+ * To queue a task for the render thread, run by runRenderTasks() once every load in a_after is done.
+ * Tasks run in the order they were posted among those that are ready. Any thread.
+ */
+void AssetLoader::post(const function<void()>& a_task, const vector<shared_future<bool>>& a_after) {
+	RenderTask task;
+	task.task = a_task;
+	task.after = a_after;
+
+	lock_guard<mutex> lock(m_renderLock);
+	m_renderTasks.push_back(task);
+}
+
+
+/**
+ * To run the render tasks whose loads are done. Returns the number of tasks run. Render thread only.
+ */
+unsigned int AssetLoader::runRenderTasks() {
+	vector<function<void()>> ready;
+	{
+		lock_guard<mutex> lock(m_renderLock);
+		for (auto it = m_renderTasks.begin(); it != m_renderTasks.end();) {
+			bool done = true;
+			for (const shared_future<bool>& result : it->after) done = done && isReady(result);
+
+			if (done) {
+				ready.push_back(it->task);
+				it = m_renderTasks.erase(it);
+			}
+			else ++it;
+		}
+	}
+
+	// run without the lock, a task may post more tasks
+	for (const function<void()>& task : ready) task();
+	return (unsigned int)ready.size();
+}
+
+
+/**
+ * To wait until every load submitted so far is done.
+ */
+void AssetLoader::wait() {
+	unique_lock<mutex> lock(m_lock);
+	m_idle.wait(lock, [this] { return m_done == m_total; });
+}
+
+
+/**
+ * To get the number of loads done.
+ */
+unsigned int AssetLoader::getDoneCount() {
+	lock_guard<mutex> lock(m_lock);
+	return m_done;
+}
+
+
+/**
+ * To get the number of loads submitted.
+ */
+unsigned int AssetLoader::getTotalCount() {
+	lock_guard<mutex> lock(m_lock);
+	return m_total;
+}
+
+
+/**
+ * To know if a load is done without waiting for it.
+ */
+bool AssetLoader::isReady(const shared_future<bool>& a_result) {
+	return a_result.valid() && (a_result.wait_for(chrono::seconds(0)) == future_status::ready);
+}
+
+
+/**
+ * To take loads off the queue and run them until the loader is stopped and the queue is empty.
+ */
+void AssetLoader::workerLoop(void* a_loader) {
+	AssetLoader* loader = (AssetLoader*)a_loader;
+
+	while (true) {
+		Job job;
+		{
+			unique_lock<mutex> lock(loader->m_lock);
+			loader->m_wakeup.wait(lock, [loader] { return !loader->m_jobs.empty() || !loader->m_running; });
+			if (loader->m_jobs.empty()) break;
+			job = loader->m_jobs.front();
+			loader->m_jobs.pop_front();
+		}
+		loader->finish(job);
+	}
+
+	loader->m_finished.fetch_add(1);
+}
+
+
+/**
+ * To run a load, fulfil its future and report it.
+ */
+void AssetLoader::finish(Job& a_job) {
+	bool success = false;
+	try {
+		success = a_job.load();
+	}
+	catch (...) {
+		success = false;
+	}
+	a_job.result->set_value(success);
+
+	// reported under the lock, so the callback is never called from two threads at once
+	lock_guard<mutex> lock(m_lock);
+	m_done++;
+	if (m_progress) m_progress(m_done, m_total, a_job.name, success);
+	m_idle.notify_all();
+}
@@ -0,0 +1,96 @@
+/**
+ * Filename: AssetLoader.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include "chai3d.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace chai3d;
+using namespace std;
+
+// most worker threads the loader starts
+constexpr unsigned int ASSET_MAX_THREADS = 8;
+
+// called once per finished load with the number of loads done, submitted, the name of the load and if it succeeded
+typedef function<void(unsigned int a_done, unsigned int a_total, const string& a_name, bool a_success)> AssetProgress;
+
+/**
+ * Loads assets on a pool of worker threads. Each load is a function parsing a model, decoding an
+ * image or generating data into an object nobody else touches yet, and the caller gets a future
+ * telling when it is done and if it succeeded. What has to happen on the render thread, attaching
+ * the results to the scene graph so their GL buffers and textures are created there, is posted as
+ * a render task that runs once the loads it depends on are ready, from runRenderTasks(). Without
+ * worker threads every load runs right away on the thread submitting it.
+ */
+class AssetLoader {
+// Public functions
+public:
+	AssetLoader();
+	~AssetLoader();
+
+	unsigned int start(unsigned int a_threadCount); // 0 runs every load on the submitting thread
+	void stop();
+	unsigned int getThreadCount() const { return (unsigned int)m_threads.size(); }
+
+	void setProgressCallback(const AssetProgress& a_progress) { m_progress = a_progress; }
+
+	shared_future<bool> load(const string& a_name, const function<bool()>& a_load);
+	void post(const function<void()>& a_task, const vector<shared_future<bool>>& a_after = vector<shared_future<bool>>());
+	unsigned int runRenderTasks(); // render thread only
+	void wait();
+
+	unsigned int getDoneCount();
+	unsigned int getTotalCount();
+
+	static bool isReady(const shared_future<bool>& a_result);
+
+// Private types
+private:
+	struct Job {
+		string name; // shown by the progress callback
+		function<bool()> load; // does the work, returns if it succeeded
+		shared_ptr<promise<bool>> result; // set once the load is done
+	};
+
+	struct RenderTask {
+		function<void()> task; // run on the render thread
+		vector<shared_future<bool>> after; // loads that must be done first
+	};
+
+// Private functions
+private:
+	static void workerLoop(void* a_loader);
+	void finish(Job& a_job);
+
+// Private variables
+private:
+	vector<cThread*> m_threads; // worker threads
+	deque<Job> m_jobs; // loads not yet started
+	mutex m_lock; // guards the jobs and the counts
+	condition_variable m_wakeup; // signalled when a job is queued or the workers must stop
+	condition_variable m_idle; // signalled when a load is done
+	bool m_running; // cleared to stop the workers once the jobs are done
+	atomic<unsigned int> m_finished; // worker threads that have exited
+	unsigned int m_done; // loads done
+	unsigned int m_total; // loads submitted
+
+	mutex m_renderLock; // guards the render tasks
+	deque<RenderTask> m_renderTasks; // tasks waiting for the render thread
+
+	AssetProgress m_progress; // told about every finished load
+};
+
+#endif
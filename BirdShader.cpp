@@ -0,0 +1,72 @@
+/**
+ * Filename: BirdShader.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "BirdShader.h"
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+// lights each vertex from the first light the way the fixed pipeline lights a chai3d material, front and
+// back as with the two sided light model chai3d turns on, so the bird looks the same as without a shader
+static const char* BIRD_VERTEX_SHADER =
+	"#version 120\n"
+	"attribute vec3 aPosition;\n"
+	"attribute vec3 aNormal;\n"
+	"varying vec4 v_front;\n"
+	"varying vec4 v_back;\n"
+	"vec4 shade(vec3 n, vec3 l, vec3 h, vec4 scene, vec4 ambient, vec4 diffuse, vec4 specular, float shininess, float alpha) {\n"
+	"	vec4 c = scene + ambient;\n"
+	"	float nl = dot(n, l);\n"
+	"	if (nl > 0.0) c += nl * diffuse + pow(max(dot(n, h), 0.0), shininess) * specular;\n"
+	"	return vec4(clamp(c.rgb, 0.0, 1.0), alpha);\n"
+	"}\n"
+	"void main() {\n"
+	"	vec4 eye = gl_ModelViewMatrix * vec4(aPosition, 1.0);\n"
+	"	vec3 n = normalize(gl_NormalMatrix * aNormal);\n"
+	"	vec3 l = normalize(gl_LightSource[0].position.xyz - eye.xyz * gl_LightSource[0].position.w);\n"
+	"	vec3 h = normalize(l + vec3(0.0, 0.0, 1.0));\n"
+	"	v_front = shade(n, l, h, gl_FrontLightModelProduct.sceneColor, gl_FrontLightProduct[0].ambient, gl_FrontLightProduct[0].diffuse,\n"
+	"		gl_FrontLightProduct[0].specular, gl_FrontMaterial.shininess, gl_FrontMaterial.diffuse.a);\n"
+	"	v_back = shade(-n, l, h, gl_BackLightModelProduct.sceneColor, gl_BackLightProduct[0].ambient, gl_BackLightProduct[0].diffuse,\n"
+	"		gl_BackLightProduct[0].specular, gl_BackMaterial.shininess, gl_BackMaterial.diffuse.a);\n"
+	"	gl_Position = gl_ProjectionMatrix * eye;\n"
+	"}\n";
+
+static const char* BIRD_FRAGMENT_SHADER =
+	"#version 120\n"
+	"varying vec4 v_front;\n"
+	"varying vec4 v_back;\n"
+	"void main() {\n"
+	"	gl_FragColor = gl_FrontFacing ? v_front : v_back;\n"
+	"}\n";
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To build the shader program the bird is drawn with. The meshes of the bird are lit by their
+ * material and a single directional light, which is all the shader reproduces. Returns nullptr if the
+ * program does not link, in which case the bird is left to the fixed pipeline. Needs the display
+ * context.
+ */
+cShaderProgramPtr createBirdShader() {
+	cShaderProgramPtr program = cShaderProgram::create(BIRD_VERTEX_SHADER, BIRD_FRAGMENT_SHADER);
+	if (!program->linkProgram()) return nullptr;
+	return program;
+}
+
+
+/**
+ * To draw every mesh of a_model with a_shader. Meshes with a shader are drawn from vertex buffers,
+ * here a single buffer of floats per mesh with the vertex properties interleaved instead of one double
+ * precision buffer per property. Graphics thread only.
+ */
+void setInterleavedRendering(cMultiMesh* a_model, cShaderProgramPtr a_shader) {
+	for (int i = 0; i < a_model->getNumMeshes(); i++) {
+		a_model->getMesh(i)->m_vertices->setUseInterleavedBuffer(true);
+	}
+	a_model->setShaderProgram(a_shader);
+}
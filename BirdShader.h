@@ -0,0 +1,22 @@
+/**
+ * Filename: BirdShader.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef BIRDSHADER_H
+#define BIRDSHADER_H
+
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+// shader program lighting the bird like the fixed pipeline, nullptr if the context has no shaders
+cShaderProgramPtr createBirdShader();
+
+// draws every mesh of a model with the shader from one interleaved vertex buffer per mesh
+void setInterleavedRendering(cMultiMesh* a_model, cShaderProgramPtr a_shader);
+
+#endif
@@ -11,6 +11,23 @@
 using namespace chai3d;
 using namespace std;
 
+// radius of the sphere the bird collides as
+constexpr double BIRD_RADIUS = 0.025;
+
+// distance over which the rumble fades in and out at the edges of a turbulence region
+constexpr double TURBULENCE_FADE = 0.05;
+
+// movement along an axis below which a sweep treats the bird as standing still on that axis
+constexpr double SWEEP_EPSILON = 1e-12;
+
+// to find when a point moving from a_from by a_delta enters the box [a_xMin, a_xMax] x [a_zMin, a_zMax]
+static bool sweepBox(const cVector3d& a_from, const cVector3d& a_delta, double a_xMin, double a_xMax, double a_zMin, double a_zMax,
+					 double& a_time, cVector3d& a_normal);
+
+// to find when a point moving from a_from by a_delta comes within a_radius of a_center in the x-z plane
+static bool sweepCircle(const cVector3d& a_from, const cVector3d& a_delta, double a_centerX, double a_centerZ, double a_radius,
+						double& a_time, cVector3d& a_normal);
+
 /////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
 Body::Body(cVector3d a_velocity,
 		   cVector3d a_wingNaturalPos,
@@ -21,6 +38,8 @@ Body::Body(cVector3d a_velocity,
 		   double a_minBound) {
 	m_mass = a_mass > 0.0 ? a_mass : 0.0; // if 0, not initialized
 	m_velocity = a_velocity;
+	m_position = cVector3d(0, 0, 0);
+	m_contactNormal = cVector3d(1, 0, 0);
 	m_leftWing = new Wing(-a_wingNaturalPos, a_area, a_drag, a_maxBound, a_minBound);
 	m_rightWing = new Wing(a_wingNaturalPos, a_area, a_drag, a_maxBound, a_minBound);
 }
@@ -42,19 +61,19 @@ void Body::calculateBounds(Wing* a_wing, cVector3d a_devicePos) {
 	double wingNaturalDistance;
 	double wingMaxLength = 0.0;
 	double wingMinLength = 0.0;
-	cVector3d globalNaturalWingPos = this->body->getLocalPos() + a_wing->m_initialPos;
+	cVector3d globalNaturalWingPos = this->m_position + a_wing->m_initialPos;
 	cVector3d force(0, 0, 0);
 
 	// get max and min length magnitudes for bounding
-	wingNaturalDistance = cDistance(this->body->getLocalPos(), globalNaturalWingPos);
+	wingNaturalDistance = cDistance(this->m_position, globalNaturalWingPos);
 	wingMaxLength = wingNaturalDistance + a_wing->m_maxBound;
 	wingMinLength = wingNaturalDistance + a_wing->m_minBound;
 
 	// calculate vector of wing pos according to device
 	cVector3d globalWingPos = globalNaturalWingPos + a_devicePos;
 	
-	wingDistance = cDistance(this->body->getLocalPos(), globalWingPos); // magnitude of device global position
-	globalWingPos = globalWingPos - this->body->getLocalPos();
+	wingDistance = cDistance(this->m_position, globalWingPos); // magnitude of device global position
+	globalWingPos = globalWingPos - this->m_position;
 
 	a_wing->m_currentLength = globalWingPos.length();
 	globalWingPos.normalize(); // update vector normalized vector
@@ -140,14 +159,14 @@ void Body::updateForces(cVector3d a_devicePosRight,
 }
 
 /**
- * To calculate the turublance force and add it to the force accumulator.
+ * To calculate the turublance force and add it to the force accumulator. The rumble is looked up in
+ * the table baked for the region and faded in and out over the edges of the region.
  */
-void Body::applyTurbulence(double a_currentTime, unsigned int a_periodRange, unsigned int a_amplitudeRange) {
+void Body::applyTurbulence(double a_currentTime, const turbulence& a_region, const TurbulenceWave& a_wave) {
 	cVector3d turbulence;
-	
-	double period = (rand() % a_periodRange + 1);
-	double amplitude = (rand() % a_amplitudeRange + 1);
-	turbulence = (amplitude * sin(period * M_PI * a_currentTime)) * cVector3d(0.0, 0.0, 1.0);
+
+	double fade = cClamp(cMin(a_region.begin - this->m_position.x(), this->m_position.x() - a_region.end) / TURBULENCE_FADE, 0.0, 1.0);
+	turbulence = (fade * a_wave.sample(a_currentTime)) * cVector3d(0.0, 0.0, 1.0);
 
 	// update wing net forces
 	this->m_rightWing->m_F_net += turbulence;
@@ -156,29 +175,205 @@ void Body::applyTurbulence(double a_currentTime, unsigned int a_periodRange, uns
 
 
 /**
- * To detect a collision with the bird and a pipe.
+ * To move the bird forward by a_dt under a constant acceleration, in a_substeps equal steps of
+ * semi-implicit Euler, keeping it between the floor and the ceiling. The path of every substep is
+ * swept against the pipes of a_level, and the bird stops where it first touches one, with the
+ * contact normal kept in m_contactNormal. Returns true on a collision.
  */
-bool Body::collisionDetector(cShapeCylinder* a_pipe) {
-	double xLength;
-	double zLength;
-	double minxDist;
-	double minzDist;
-	double cornerDist;
-	double avatarRadius = 0.025;
-
-	cVector3d adjustedPipeCenter = a_pipe->getLocalPos() + cVector3d(0, 0, a_pipe->getHeight() / 2);
-
-	xLength = abs(this->body->getLocalPos().x() - adjustedPipeCenter.x());
-	zLength = abs(this->body->getLocalPos().z() - adjustedPipeCenter.z());
-
-	minxDist = a_pipe->getBaseRadius() + avatarRadius;
-	minzDist = a_pipe->getHeight() / 2 + avatarRadius;
-
-	if ((xLength > minxDist) || (zLength > minzDist)) return false;
-	else if ((xLength <= a_pipe->getBaseRadius() / 2) || ((zLength <= a_pipe->getHeight() / 2))) return true;
-	else {
-		cornerDist = pow(xLength - a_pipe->getBaseRadius(), 2) + pow(zLength - a_pipe->getHeight() / 2, 2);
-		if (cornerDist <= avatarRadius * avatarRadius) return true;
+bool Body::integrate(const cVector3d& a_acceleration, double a_dt, unsigned int a_substeps, double a_floor, double a_ceiling,
+					 const LevelModel* a_level) {
+	unsigned int substeps = cMax(a_substeps, 1u);
+	double h = a_dt / substeps;
+
+	for (unsigned int i = 0; i < substeps; i++) {
+		cVector3d newVelocity = this->m_velocity + a_acceleration * h;
+		cVector3d newPos = this->m_position + newVelocity * h;
+
+		if ((newPos.z() >= a_ceiling) || (newPos.z() <= a_floor)) {
+			// stop climbing or falling at the ceiling and floor
+			newVelocity = cVector3d(newVelocity.x(), 0, 0);
+			newPos = cVector3d(newPos.x(), 0, cClamp(newPos.z(), a_floor, a_ceiling));
+		}
+
+		SweepHit hit;
+		if ((a_level != NULL) && sweep(this->m_position, newPos, *a_level, hit)) {
+			this->m_position = hit.position;
+			this->m_contactNormal = hit.normal;
+			return true;
+		}
+
+		this->m_velocity = newVelocity;
+		this->m_position = newPos;
 	}
 	return false;
-}
\ No newline at end of file
+}
+
+
+/**
+ * To sweep the bird from a_from to a_to against every pipe of a level that overlaps the swept range
+ * of x. Returns true if the bird touches a pipe on the way, with the first contact in a_hit.
+ */
+bool Body::sweep(const cVector3d& a_from, const cVector3d& a_to, const LevelModel& a_level, SweepHit& a_hit) {
+	a_level.findPipes(cMin(a_from.x(), a_to.x()) - BIRD_RADIUS, cMax(a_from.x(), a_to.x()) + BIRD_RADIUS, m_nearbyPipes);
+
+	bool found = false;
+	a_hit.time = 1.0;
+	for (unsigned int i : m_nearbyPipes) {
+		cVector3d topPos, bottomPos;
+		double topHeight, bottomHeight;
+		a_level.getPipeGeometry(i, topPos, topHeight, bottomPos, bottomHeight);
+
+		double radius = a_level.getPipe(i).radius;
+		double time;
+		cVector3d normal;
+		if (sweepPipe(a_from, a_to, topPos, radius, topHeight, time, normal) && (!found || (time < a_hit.time))) {
+			a_hit.time = time;
+			a_hit.normal = normal;
+			a_hit.pipe = i;
+			found = true;
+		}
+		if (sweepPipe(a_from, a_to, bottomPos, radius, bottomHeight, time, normal) && (!found || (time < a_hit.time))) {
+			a_hit.time = time;
+			a_hit.normal = normal;
+			a_hit.pipe = i;
+			found = true;
+		}
+	}
+
+	if (found) a_hit.position = a_from + a_hit.time * (a_to - a_from);
+	return found;
+}
+
+
+/**
+ * To sweep the bird from a_from to a_to against an upright pipe given by the centre of its base,
+ * its radius and its height. In the x-z plane the pipe is a rectangle, and the bird touches it when
+ * its centre enters the rectangle grown by the bird radius with rounded corners. That shape is two
+ * boxes and four circles, and the time of impact is the earliest time the centre enters any of
+ * them. Returns true if the bird touches the pipe, with the fraction of the path travelled in
+ * a_time and the contact normal in a_normal.
+ */
+bool Body::sweepPipe(const cVector3d& a_from, const cVector3d& a_to, const cVector3d& a_pipeBase, double a_pipeRadius,
+					 double a_pipeHeight, double& a_time, cVector3d& a_normal) {
+	cVector3d delta = a_to - a_from;
+	double x0 = a_pipeBase.x() - a_pipeRadius;
+	double x1 = a_pipeBase.x() + a_pipeRadius;
+	double z0 = a_pipeBase.z();
+	double z1 = a_pipeBase.z() + a_pipeHeight;
+
+	bool found = false;
+	double time;
+	cVector3d normal;
+
+	// the sides, then the top and bottom
+	if (sweepBox(a_from, delta, x0 - BIRD_RADIUS, x1 + BIRD_RADIUS, z0, z1, time, normal)) {
+		a_time = time;
+		a_normal = normal;
+		found = true;
+	}
+	if (sweepBox(a_from, delta, x0, x1, z0 - BIRD_RADIUS, z1 + BIRD_RADIUS, time, normal) && (!found || (time < a_time))) {
+		a_time = time;
+		a_normal = normal;
+		found = true;
+	}
+
+	// the corners
+	const double cornerX[4] = { x0, x1, x0, x1 };
+	const double cornerZ[4] = { z0, z0, z1, z1 };
+	for (int i = 0; i < 4; i++) {
+		if (sweepCircle(a_from, delta, cornerX[i], cornerZ[i], BIRD_RADIUS, time, normal) && (!found || (time < a_time))) {
+			a_time = time;
+			a_normal = normal;
+			found = true;
+		}
+	}
+
+	// the bird started out overlapping a box, push it out the way it is nearest to leaving the pipe
+	if (found && (a_normal.lengthsq() == 0.0)) {
+		cVector3d closest(cClamp(a_from.x(), x0, x1), 0.0, cClamp(a_from.z(), z0, z1));
+		a_normal = cVector3d(a_from.x(), 0.0, a_from.z()) - closest;
+		if (a_normal.lengthsq() == 0.0) a_normal = (a_from.x() < a_pipeBase.x()) ? cVector3d(-1, 0, 0) : cVector3d(1, 0, 0);
+		a_normal.normalize();
+	}
+	return found;
+}
+
+
+/**
+ * To find when a point moving from a_from by a_delta enters the box [a_xMin, a_xMax] x [a_zMin,
+ * a_zMax], with slabs along x and z. The normal is that of the face it enters through, zero if the
+ * point starts inside.
+ */
+static bool sweepBox(const cVector3d& a_from, const cVector3d& a_delta, double a_xMin, double a_xMax, double a_zMin, double a_zMax,
+					 double& a_time, cVector3d& a_normal) {
+	const double from[2] = { a_from.x(), a_from.z() };
+	const double delta[2] = { a_delta.x(), a_delta.z() };
+	const double low[2] = { a_xMin, a_zMin };
+	const double high[2] = { a_xMax, a_zMax };
+
+	double enter = 0.0;
+	double exit = 1.0;
+	cVector3d normal(0, 0, 0);
+
+	for (int axis = 0; axis < 2; axis++) {
+		if (fabs(delta[axis]) < SWEEP_EPSILON) {
+			if ((from[axis] < low[axis]) || (from[axis] > high[axis])) return false;
+			continue;
+		}
+
+		double t0 = (low[axis] - from[axis]) / delta[axis];
+		double t1 = (high[axis] - from[axis]) / delta[axis];
+		double side = -1.0; // entering through the low face
+		if (t0 > t1) {
+			swap(t0, t1);
+			side = 1.0;
+		}
+
+		if (t0 > enter) {
+			enter = t0;
+			normal = (axis == 0) ? cVector3d(side, 0, 0) : cVector3d(0, 0, side);
+		}
+		exit = cMin(exit, t1);
+		if (enter > exit) return false;
+	}
+
+	a_time = enter;
+	a_normal = normal;
+	return true;
+}
+
+
+/**
+ * To find when a point moving from a_from by a_delta comes within a_radius of (a_centerX, a_centerZ)
+ * in the x-z plane. The normal points from the centre to the point.
+ */
+static bool sweepCircle(const cVector3d& a_from, const cVector3d& a_delta, double a_centerX, double a_centerZ, double a_radius,
+						double& a_time, cVector3d& a_normal) {
+	double mx = a_from.x() - a_centerX;
+	double mz = a_from.z() - a_centerZ;
+	double dx = a_delta.x();
+	double dz = a_delta.z();
+
+	double c = mx * mx + mz * mz - a_radius * a_radius;
+	if (c <= 0.0) {
+		// starts inside
+		a_time = 0.0;
+		a_normal = cVector3d(mx, 0.0, mz);
+		if (a_normal.lengthsq() > 0.0) a_normal.normalize();
+		return true;
+	}
+
+	double a = dx * dx + dz * dz;
+	if (a < SWEEP_EPSILON * SWEEP_EPSILON) return false;
+
+	double b = mx * dx + mz * dz;
+	double discriminant = b * b - a * c;
+	if ((b >= 0.0) || (discriminant < 0.0)) return false; // moving away or passing by
+
+	double t = (-b - sqrt(discriminant)) / a;
+	if (t > 1.0) return false;
+
+	a_time = t;
+	a_normal = cVector3d(mx + t * dx, 0.0, mz + t * dz) / a_radius;
+	return true;
+}
@@ -9,11 +9,21 @@
 #define BODY_H
 
 #include "Wing.h"
+#include "LevelModel.h"
 #include "chai3d.h"
+#include <vector>
 
 using namespace chai3d;
 using namespace std;
 
+// first contact found by sweeping the bird along a path
+typedef struct SweepHit {
+	double time; // fraction of the path travelled when the bird touches, 0 if it overlapped from the start
+	cVector3d position; // position of the bird at the time of impact
+	cVector3d normal; // unit normal of the contact, pointing from the pipe towards the bird
+	unsigned int pipe; // index of the pair of pipes that was hit
+} SweepHit;
+
 class Body {
 // Public functions
 public:
@@ -36,9 +46,13 @@ public:
 					  cVector3d a_deviceVelLeft, 
 					  cVector3d a_deviceVelRight,
 					  double a_airDensity = 0.038);
-	void applyTurbulence(double a_currentTime, unsigned int a_periodRange, unsigned int a_amplitudeRange);
+	void applyTurbulence(double a_currentTime, const turbulence& a_region, const TurbulenceWave& a_wave);
+	bool integrate(const cVector3d& a_acceleration, double a_dt, unsigned int a_substeps, double a_floor, double a_ceiling,
+				   const LevelModel* a_level);
 
-	bool collisionDetector(cShapeCylinder* a_pipe);
+	bool sweep(const cVector3d& a_from, const cVector3d& a_to, const LevelModel& a_level, SweepHit& a_hit);
+	static bool sweepPipe(const cVector3d& a_from, const cVector3d& a_to, const cVector3d& a_pipeBase, double a_pipeRadius,
+						  double a_pipeHeight, double& a_time, cVector3d& a_normal);
 
 // Public varibles
 public:
@@ -46,12 +60,17 @@ public:
 	cMultiMesh *leftWing; // pointer to the mesh of the left wing for the body
 	cMultiMesh *rightWing; // pointer to the mesh of the right wing for the body
 	cVector3d m_velocity; // current velocity of bird
+	cVector3d m_position; // current position of bird (owned by the haptics thread, the mesh is moved by the graphics thread)
+	cVector3d m_contactNormal; // normal of the last collision, pointing from the pipe towards the bird
 
 	double m_mass; // mass of the bird
 	
 	Wing *m_leftWing; // pointer to the left wing storage class
 	Wing *m_rightWing; // pointer to the right wing storage class
 
+// Private variables
+private:
+	vector<unsigned int> m_nearbyPipes; // pipes found by the last collision check, kept to reuse its memory
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,207 @@
+/**
+ * Filename: DeviceIO.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "DeviceIO.h"
+#include "chai3d.h"
+#include <chrono>
+#include <thread>
+#if defined(LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace chai3d;
+using namespace std;
+
+// number of times a waiting thread polls the barrier before it starts sleeping between polls
+constexpr unsigned int BARRIER_SPINS = 1000;
+
+// time a waiting thread sleeps between polls once it has spun for a while [us]
+constexpr unsigned int BARRIER_SLEEP_US = 20;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+TickBarrier::TickBarrier() {
+	m_count = 1;
+	m_waiting.store(0);
+	m_phase.store(0);
+}
+
+
+DeviceIO::DeviceIO() {
+	m_running.store(false);
+	m_finished.store(0);
+	m_pinned.store(0);
+	m_pinCores = false;
+}
+
+
+DeviceIO::~DeviceIO() {
+	stop();
+}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To wait until every thread taking part has called wait() for the current phase.
+ */
+void TickBarrier::wait() {
+	unsigned int phase = m_phase.load(memory_order_acquire);
+
+	// the last thread to arrive opens the barrier for everyone
+	if (m_waiting.fetch_add(1, memory_order_acq_rel) + 1 == m_count) {
+		m_waiting.store(0, memory_order_relaxed);
+		m_phase.store(phase + 1, memory_order_release);
+		return;
+	}
+
+	// a yield would not let lower priority threads onto the core of a real-time thread, so long
+	// waits sleep instead
+	for (unsigned int spins = 0; m_phase.load(memory_order_acquire) == phase; spins++) {
+		if (spins >= BARRIER_SPINS) this_thread::sleep_for(chrono::microseconds(BARRIER_SLEEP_US));
+	}
+}
+
+
+/**
+ * To start one I/O thread for each of the opened devices. The haptic thread has to call sample()
+ * and commit() once per tick from then on.
+ */
+bool DeviceIO::start(const vector<cGenericHapticDevicePtr>& a_devices) {
+	stop();
+	if (a_devices.empty()) return false;
+
+	m_running.store(true);
+	m_finished.store(0);
+	m_pinned.store(0);
+	m_barrier.setCount((unsigned int)a_devices.size() + 1); // the I/O threads and the haptic thread
+	m_pinCores = (thread::hardware_concurrency() >= a_devices.size() + 1);
+
+	for (unsigned int i = 0; i < a_devices.size(); i++) {
+		Channel* channel = new Channel();
+		channel->io = this;
+		channel->index = i;
+		channel->device = a_devices[i];
+		channel->thread = new cThread();
+		m_channels.push_back(channel);
+	}
+	for (unsigned int i = 0; i < m_channels.size(); i++) {
+		m_channels[i]->thread->start(ioLoop, CTHREAD_PRIORITY_HAPTICS, m_channels[i]);
+	}
+	return true;
+}
+
+
+/**
+ * To stop the I/O threads. Must not be called while the haptic thread is still running ticks.
+ */
+void DeviceIO::stop() {
+	if (m_channels.empty()) return;
+
+	// release the threads waiting for the next tick, they see the flag and exit
+	m_running.store(false);
+	m_barrier.wait();
+	while (m_finished.load() < m_channels.size()) { cSleepMs(1); }
+
+	for (unsigned int i = 0; i < m_channels.size(); i++) {
+		delete m_channels[i]->thread;
+		delete m_channels[i];
+	}
+	m_channels.clear();
+}
+
+
+/**
+ * To read every device at the same time. Returns once all of them have been read, so the states
+ * form a consistent snapshot of one tick. A state that could not be read keeps its last value.
+ */
+void DeviceIO::sample(vector<cHapticDeviceState>& a_states) {
+	m_barrier.wait(); // the I/O threads start reading
+	m_barrier.wait(); // every state is in its queue
+
+	if (a_states.size() < m_channels.size()) a_states.resize(m_channels.size());
+	for (unsigned int i = 0; i < m_channels.size(); i++) {
+		m_channels[i]->states.pop(a_states[i]);
+	}
+}
+
+
+/**
+ * To set the force of a device. It is written by the I/O thread of the device once the tick is
+ * committed. If several forces are set in one tick only the last one is written.
+ */
+void DeviceIO::setForce(unsigned int a_device, const cVector3d& a_force, const cVector3d& a_torque, double a_gripperForce) {
+	if (a_device >= m_channels.size()) return;
+
+	DeviceCommand command;
+	command.force = a_force;
+	command.torque = a_torque;
+	command.gripperForce = a_gripperForce;
+	m_channels[a_device]->commands.publish(command);
+}
+
+
+/**
+ * To release the I/O threads to write the forces queued this tick, all at the same time.
+ */
+void DeviceIO::commit() {
+	m_barrier.wait();
+}
+
+
+/**
+ * To pin the calling haptic thread to core 0, which is kept free of I/O threads. Does nothing and
+ * returns false when there are not enough cores to pin every thread.
+ */
+bool DeviceIO::pinSimulationThread() {
+	return m_pinCores && pinCurrentThread(0);
+}
+
+
+/**
+ * Body of an I/O thread. Reads its device when a tick is sampled and writes the latest force set
+ * when the tick is committed.
+ */
+void DeviceIO::ioLoop(void* a_channel) {
+	Channel* channel = (Channel*)a_channel;
+	DeviceIO* io = channel->io;
+
+	// keep the thread on a core of its own, core 0 is left to the haptic thread
+	if (io->m_pinCores && pinCurrentThread(channel->index + 1)) io->m_pinned.fetch_add(1);
+
+	cHapticDeviceState state;
+	DeviceCommand command;
+	while (true) {
+		io->m_barrier.wait(); // next tick
+		if (!io->m_running.load()) break;
+
+		state.m_userSwitches = 0;
+		channel->device->getState(state);
+		channel->states.push(state);
+		io->m_barrier.wait(); // all devices have been read
+
+		io->m_barrier.wait(); // forces of the tick are committed
+		if (channel->commands.consume(command)) channel->device->setForceAndTorqueAndGripperForce(command.force, command.torque, command.gripperForce);
+	}
+
+	io->m_finished.fetch_add(1);
+}
+
+
+/**
+ * To pin the calling thread to a core. Returns false where the platform has no way to do it.
+ */
+bool DeviceIO::pinCurrentThread(unsigned int a_cpu) {
+#if defined(WIN32) | defined(WIN64)
+	return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << a_cpu) != 0;
+#elif defined(LINUX)
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	CPU_SET(a_cpu, &cpus);
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+	return false; // macOS only takes affinity hints
+#endif
+}
@@ -0,0 +1,188 @@
+/**
+ * Filename: DeviceIO.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef DEVICEIO_H
+#define DEVICEIO_H
+
+#include "AlignedAlloc.h"
+#include "chai3d.h"
+#include <atomic>
+#include <vector>
+
+using namespace chai3d;
+using namespace std;
+
+// number of values a device queue can hold (power of two)
+constexpr size_t DEVICE_QUEUE_CAPACITY = 8;
+
+/**
+ * Lock-free queue between exactly one producer thread and one consumer thread.
+ */
+template <typename T>
+class SpscQueue {
+// Public functions
+public:
+	SpscQueue() { m_head.store(0); m_tail.store(0); }
+
+	/**
+	 * To add a value at the back of the queue. Returns false if the queue is full. Producer only.
+	 */
+	bool push(const T& a_value) {
+		size_t head = m_head.load(memory_order_relaxed);
+		if (head - m_tail.load(memory_order_acquire) >= DEVICE_QUEUE_CAPACITY) return false;
+		m_items[head & (DEVICE_QUEUE_CAPACITY - 1)] = a_value;
+		m_head.store(head + 1, memory_order_release);
+		return true;
+	}
+
+	/**
+	 * To take the value at the front of the queue. Returns false if the queue is empty. Consumer only.
+	 */
+	bool pop(T& a_value) {
+		size_t tail = m_tail.load(memory_order_relaxed);
+		if (m_head.load(memory_order_acquire) == tail) return false;
+		a_value = m_items[tail & (DEVICE_QUEUE_CAPACITY - 1)];
+		m_tail.store(tail + 1, memory_order_release);
+		return true;
+	}
+
+// Private variables
+private:
+	T m_items[DEVICE_QUEUE_CAPACITY]; // values in the queue
+	alignas(64) atomic<size_t> m_head; // next slot the producer writes
+	alignas(64) atomic<size_t> m_tail; // next slot the consumer reads
+};
+
+/**
+ * Triple buffer holding the latest value written by one producer thread for one consumer thread.
+ * A new value replaces the one not yet read, so the consumer only ever sees the newest.
+ */
+template <typename T>
+class LatestValue {
+// Public functions
+public:
+	LatestValue() { m_writeIndex = 0; m_middle.store(1); m_readIndex = 2; }
+
+	/**
+	 * To replace the latest value. Producer only.
+	 */
+	void publish(const T& a_value) {
+		m_items[m_writeIndex] = a_value;
+		unsigned int previous = m_middle.exchange(m_writeIndex | FRESH_BIT, memory_order_acq_rel);
+		m_writeIndex = previous & INDEX_MASK;
+	}
+
+	/**
+	 * To take the latest value. Returns false and leaves a_value alone if nothing was published
+	 * since the last call. Consumer only.
+	 */
+	bool consume(T& a_value) {
+		if ((m_middle.load(memory_order_relaxed) & FRESH_BIT) == 0) return false;
+		unsigned int previous = m_middle.exchange(m_readIndex, memory_order_acq_rel);
+		m_readIndex = previous & INDEX_MASK;
+		a_value = m_items[m_readIndex];
+		return true;
+	}
+
+// Private variables
+private:
+	static constexpr unsigned int INDEX_MASK = 0x3;
+	static constexpr unsigned int FRESH_BIT = 0x4;
+
+	T m_items[3]; // values being written, exchanged and read
+	alignas(64) unsigned int m_writeIndex; // item owned by the producer
+	alignas(64) unsigned int m_readIndex; // item owned by the consumer
+	alignas(64) atomic<unsigned int> m_middle; // item being exchanged, plus the fresh bit
+};
+
+/**
+ * Reusable barrier for a fixed number of threads. Threads spin for a short while before they start
+ * sleeping, since most waits are a small fraction of a haptic tick.
+ */
+class TickBarrier {
+// Public functions
+public:
+	TickBarrier();
+
+	void setCount(unsigned int a_count) { m_count = a_count; }
+	void wait();
+
+// Private variables
+private:
+	unsigned int m_count; // threads taking part
+	alignas(64) atomic<unsigned int> m_waiting; // threads that have arrived in the current phase
+	alignas(64) atomic<unsigned int> m_phase; // incremented each time every thread has arrived
+};
+
+/**
+ * Force sent to a device by the haptic thread.
+ */
+struct DeviceCommand {
+	cVector3d force;
+	cVector3d torque;
+	double gripperForce;
+};
+
+/**
+ * Talks to every haptic device from its own I/O thread so the devices are read and written in
+ * parallel instead of one after the other. When there is a core for the haptic thread and one for
+ * each I/O thread, the haptic thread is pinned to core 0 with pinSimulationThread() and each I/O
+ * thread to a core of its own, otherwise no thread is pinned. Each tick the haptic thread calls
+ * sample(), which releases all I/O threads to read their device at the same time and returns once
+ * every state is in, then commit(), which releases them to write the forces queued with setForce().
+ * States and forces are passed through single producer/single consumer queues, the phases are
+ * separated by a barrier shared by the I/O threads and the haptic thread.
+ */
+class DeviceIO {
+// Public functions
+public:
+	DeviceIO();
+	~DeviceIO();
+
+	bool start(const vector<cGenericHapticDevicePtr>& a_devices);
+	void stop();
+	bool isRunning() const { return !m_channels.empty(); }
+
+	void sample(vector<cHapticDeviceState>& a_states); // haptics thread only
+	void setForce(unsigned int a_device, const cVector3d& a_force, const cVector3d& a_torque, double a_gripperForce); // haptics thread only
+	void commit(); // haptics thread only
+	bool pinSimulationThread(); // haptics thread only
+
+	unsigned int getDeviceCount() const { return (unsigned int)m_channels.size(); }
+	unsigned int getPinnedCount() const { return m_pinned.load(); }
+
+// Private types
+private:
+	struct Channel {
+		DeviceIO* io; // owner of the channel
+		unsigned int index; // number of the device
+		cGenericHapticDevicePtr device; // device served by the channel
+		cThread* thread; // I/O thread of the device
+		SpscQueue<cHapticDeviceState> states; // states read by the I/O thread
+		LatestValue<DeviceCommand> commands; // latest force set by the haptic thread
+
+		// the queues are kept on their own cache lines, which plain new does not guarantee
+		static void* operator new(size_t a_size) { return alignedAlloc(a_size); }
+		static void operator delete(void* a_pointer) { alignedFree(a_pointer); }
+	};
+
+// Private functions
+private:
+	static void ioLoop(void* a_channel);
+	static bool pinCurrentThread(unsigned int a_cpu);
+
+// Private variables
+private:
+	vector<Channel*> m_channels; // one per device
+	TickBarrier m_barrier; // shared by the I/O threads and the haptic thread
+	atomic<bool> m_running; // cleared to stop the I/O threads
+	atomic<unsigned int> m_finished; // I/O threads that have exited
+	atomic<unsigned int> m_pinned; // I/O threads that could be pinned to a core
+	bool m_pinCores; // there are enough cores to give every thread its own
+};
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ * Filename: FramePipeline.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "FramePipeline.h"
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+// longest single wait on a fence before checking again, in nanoseconds
+constexpr GLuint64 FRAME_FENCE_TIMEOUT = 100000000;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+FramePipeline::FramePipeline() {
+	m_fenceSupported = false;
+	m_timerSupported = false;
+	m_maxFramesInFlight = 2;
+
+	for (unsigned int i = 0; i < FRAME_PIPELINE_MAX_DEPTH; i++) {
+		m_frames[i].fence = 0;
+		m_frames[i].query = 0;
+	}
+	m_head = 0;
+	m_tail = 0;
+
+	m_submitStart = 0.0;
+	m_lastPresent = 0.0;
+}
+
+
+FramePipeline::~FramePipeline() {}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To find out which of fence syncs and timer queries the display context supports and create the
+ * timer queries.
+ */
+void FramePipeline::init() {
+#ifdef GLEW_VERSION
+	m_fenceSupported = (GLEW_VERSION_3_2 || GLEW_ARB_sync) ? true : false;
+	m_timerSupported = (GLEW_VERSION_3_3 || GLEW_ARB_timer_query) ? true : false;
+#endif
+
+	if (m_timerSupported) {
+		for (unsigned int i = 0; i < FRAME_PIPELINE_MAX_DEPTH; i++) glGenQueries(1, &m_frames[i].query);
+	}
+	m_head = 0;
+	m_tail = 0;
+	m_lastPresent = 0.0;
+}
+
+
+/**
+ * To wait for the frames still in flight and delete the fences and queries.
+ */
+void FramePipeline::release() {
+	while (retireOldest(true)) {}
+
+	if (m_timerSupported) {
+		for (unsigned int i = 0; i < FRAME_PIPELINE_MAX_DEPTH; i++) glDeleteQueries(1, &m_frames[i].query);
+	}
+	m_fenceSupported = false;
+	m_timerSupported = false;
+}
+
+
+/**
+ * To set how many frames the CPU may run ahead of the GPU, from 1 to FRAME_PIPELINE_MAX_DEPTH.
+ * Takes effect at the next frame.
+ */
+void FramePipeline::setMaxFramesInFlight(unsigned int a_frames) {
+	m_maxFramesInFlight = cClamp(a_frames, 1u, FRAME_PIPELINE_MAX_DEPTH);
+}
+
+
+/**
+ * To start a frame. Frames the GPU has already finished are collected, then the CPU waits for the
+ * oldest frame only while the pipeline is full.
+ */
+void FramePipeline::beginFrame() {
+	double start = cPrecisionClock::getCPUTimeSeconds();
+
+	while (retireOldest(false)) {}
+	while ((m_head - m_tail >= m_maxFramesInFlight) && retireOldest(true)) {}
+
+	m_submitStart = cPrecisionClock::getCPUTimeSeconds();
+	m_waitTimes.record(m_submitStart - start);
+
+	if (m_timerSupported) glBeginQuery(GL_TIME_ELAPSED, m_frames[m_head % FRAME_PIPELINE_MAX_DEPTH].query);
+}
+
+
+/**
+ * To end a frame once all its commands have been issued.
+ */
+void FramePipeline::endFrame() {
+	Frame &frame = m_frames[m_head % FRAME_PIPELINE_MAX_DEPTH];
+
+	if (m_timerSupported) glEndQuery(GL_TIME_ELAPSED);
+
+	if (m_fenceSupported) {
+		frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	} else {
+		// no way to tell when the GPU is done, finish the frame here
+		glFinish();
+	}
+	m_head++;
+
+	m_submitTimes.record(cPrecisionClock::getCPUTimeSeconds() - m_submitStart);
+
+	// without fences the frame is already complete
+	if (!m_fenceSupported) retireOldest(true);
+}
+
+
+/**
+ * To time the interval since the previous present.
+ */
+void FramePipeline::framePresented() {
+	double now = cPrecisionClock::getCPUTimeSeconds();
+	if (m_lastPresent > 0.0) m_presentIntervals.record(now - m_lastPresent);
+	m_lastPresent = now;
+}
+
+
+/**
+ * To retire the oldest frame in flight, reading its GPU time. If a_wait is false the frame is only
+ * retired if the GPU has already finished it. Returns false if no frame was retired.
+ */
+bool FramePipeline::retireOldest(bool a_wait) {
+	if (m_tail == m_head) return false;
+
+	Frame &frame = m_frames[m_tail % FRAME_PIPELINE_MAX_DEPTH];
+	if (m_fenceSupported && (frame.fence != 0)) {
+		GLenum status = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, a_wait ? FRAME_FENCE_TIMEOUT : 0);
+		while (a_wait && (status == GL_TIMEOUT_EXPIRED)) {
+			status = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, FRAME_FENCE_TIMEOUT);
+		}
+		if (status == GL_TIMEOUT_EXPIRED) return false;
+
+		glDeleteSync(frame.fence);
+		frame.fence = 0;
+	}
+
+	if (m_timerSupported) {
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(frame.query, GL_QUERY_RESULT, &elapsed);
+		m_gpuTimes.record(elapsed * 1e-9);
+	}
+
+	m_tail++;
+	return true;
+}
+
+
+/**
+ * To print the frame timings.
+ */
+void FramePipeline::printReport(ostream& a_stream) const {
+	a_stream << "graphics: " << (m_fenceSupported ? "pipelined" : "finished every frame") << ", up to "
+			 << m_maxFramesInFlight << " frames in flight" << endl;
+	a_stream << "  wait for a free frame: ";
+	m_waitTimes.print(a_stream);
+	a_stream << endl << "  CPU submit: ";
+	m_submitTimes.print(a_stream);
+	a_stream << endl;
+	if (m_timerSupported) {
+		a_stream << "  GPU: ";
+		m_gpuTimes.print(a_stream);
+		a_stream << endl;
+	}
+	a_stream << "  present to present: ";
+	m_presentIntervals.print(a_stream);
+	a_stream << endl;
+}
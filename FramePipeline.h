@@ -0,0 +1,82 @@
+/**
+ * Filename: FramePipeline.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef FRAMEPIPELINE_H
+#define FRAMEPIPELINE_H
+
+#include "chai3d.h"
+#include <ostream>
+
+using namespace chai3d;
+using namespace std;
+
+// most frames that can be queued on the GPU at once
+constexpr unsigned int FRAME_PIPELINE_MAX_DEPTH = 3;
+
+/**
+ * Paces the frames of the graphics thread without draining the GPU after every frame. A fence is
+ * placed behind the commands of every frame and the CPU only waits for the oldest one once the
+ * set number of frames is in flight, so the CPU prepares the next frame while the GPU is still
+ * drawing the previous ones. Each frame is also timed: CPU time spent waiting for a free slot,
+ * CPU time spent submitting, GPU time (timer queries) and the interval between two presents.
+ * Without fence support every frame is finished with glFinish() as before.
+ */
+class FramePipeline {
+// Public functions
+public:
+	FramePipeline();
+	~FramePipeline();
+
+	void init(); // with the display context current
+	void release(); // with the display context current
+
+	void setMaxFramesInFlight(unsigned int a_frames);
+	unsigned int getMaxFramesInFlight() const { return m_maxFramesInFlight; }
+	bool isPipelined() const { return m_fenceSupported; }
+	bool isGpuTimed() const { return m_timerSupported; }
+
+	void beginFrame();
+	void endFrame();
+	void framePresented(); // right after the buffers were swapped
+
+	const cLatencyHistogram& getWaitTimes() const { return m_waitTimes; }
+	const cLatencyHistogram& getSubmitTimes() const { return m_submitTimes; }
+	const cLatencyHistogram& getGpuTimes() const { return m_gpuTimes; }
+	const cLatencyHistogram& getPresentIntervals() const { return m_presentIntervals; }
+	void printReport(ostream& a_stream) const;
+
+// Private types
+private:
+	struct Frame {
+		GLsync fence; // signalled once the GPU has finished the frame
+		GLuint query; // GPU time of the frame
+	};
+
+// Private functions
+private:
+	bool retireOldest(bool a_wait);
+
+// Private variables
+private:
+	bool m_fenceSupported; // if fence syncs are available
+	bool m_timerSupported; // if timer queries are available
+	unsigned int m_maxFramesInFlight; // frames the CPU may run ahead of the GPU
+
+	Frame m_frames[FRAME_PIPELINE_MAX_DEPTH]; // slot of a frame is its number modulo the depth
+	unsigned long long m_head; // number of the next frame to begin
+	unsigned long long m_tail; // number of the oldest frame still in flight
+
+	double m_submitStart; // CPU time the current frame started submitting
+	double m_lastPresent; // CPU time of the last present, 0 before the first
+
+	cLatencyHistogram m_waitTimes; // time waited for a free slot
+	cLatencyHistogram m_submitTimes; // time spent submitting a frame
+	cLatencyHistogram m_gpuTimes; // time the GPU spent on a frame
+	cLatencyHistogram m_presentIntervals; // time between two presents
+};
+
+#endif
@@ -0,0 +1,166 @@
+/**
+ * Filename: HapticScheduler.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "HapticScheduler.h"
+#include "chai3d.h"
+
+#if defined(WIN32) | defined(WIN64)
+#include <mmsystem.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+#if defined(LINUX)
+#include <errno.h>
+#endif
+
+using namespace chai3d;
+using namespace std;
+
+constexpr long long NS_PER_SECOND = 1000000000LL;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+HapticScheduler::HapticScheduler(unsigned int a_rate) {
+	m_rate = HAPTIC_RATE_1KHZ;
+	m_period = 1.0 / m_rate;
+	m_periodNs = NS_PER_SECOND / m_rate;
+	setRate(a_rate);
+
+#if defined(WIN32) | defined(WIN64)
+	// the windows scheduler can overshoot a sleep by a full timer tick, so leave more time to spin
+	m_spinMarginNs = 2000000; // 2 ms
+	timeBeginPeriod(1); // ask for 1 ms sleep granularity
+#else
+	m_spinMarginNs = 100000; // 100 us
+#endif
+
+	m_deadline = 0;
+	m_realTime = true;
+	m_ticks = 0;
+	m_missed = 0;
+}
+
+
+HapticScheduler::~HapticScheduler() {
+#if defined(WIN32) | defined(WIN64)
+	timeEndPeriod(1);
+#endif
+}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To set the rate of the haptic loop. Only 1, 2 and 4 kHz are accepted, anything else
+ * leaves the current rate unchanged.
+ */
+bool HapticScheduler::setRate(unsigned int a_rate) {
+	if ((a_rate != HAPTIC_RATE_500HZ) && (a_rate != HAPTIC_RATE_1KHZ) && (a_rate != HAPTIC_RATE_2KHZ) && (a_rate != HAPTIC_RATE_4KHZ)) {
+		return false;
+	}
+
+	m_rate = a_rate;
+	m_periodNs = NS_PER_SECOND / m_rate;
+	m_period = (double)m_periodNs / (double)NS_PER_SECOND;
+	return true;
+}
+
+
+/**
+ * To set how long before each deadline the scheduler stops sleeping and spins on the clock.
+ */
+void HapticScheduler::setSpinMargin(double a_seconds) {
+	m_spinMarginNs = a_seconds > 0.0 ? (long long)(a_seconds * NS_PER_SECOND) : 0;
+}
+
+
+/**
+ * To arm the first deadline. Must be called once from the haptic thread before the loop starts.
+ */
+void HapticScheduler::start() {
+	m_deadline = now() + m_periodNs;
+	m_ticks = 0;
+	m_missed = 0;
+}
+
+
+/**
+ * To block until the next absolute deadline. The thread sleeps until it is close to the deadline
+ * and spins for the remainder. Returns false if the last tick overran its deadline, in which case
+ * the next tick starts right away and the deadlines are re-anchored to the current time.
+ * When real time pacing is off the call returns immediately.
+ */
+bool HapticScheduler::waitForNextTick() {
+	m_ticks.fetch_add(1, memory_order_release);
+
+	// faster than real time, only virtual time moves forward
+	if (!m_realTime) return true;
+
+	long long t = now();
+	if (t > m_deadline) {
+		// tick took longer than a period, don't try to catch up with a burst of ticks
+		m_missed++;
+		m_deadline = t + m_periodNs;
+		return false;
+	}
+
+	// coarse sleep handled by the OS
+	if (m_deadline - t > m_spinMarginNs) {
+		sleepUntil(m_deadline - m_spinMarginNs);
+	}
+
+	// fine wait for the remaining time
+	while (now() < m_deadline) {}
+
+	m_deadline += m_periodNs; // absolute deadlines, so errors do not accumulate
+	return true;
+}
+
+
+/**
+ * To get the current time of the monotonic clock in nanoseconds.
+ */
+long long HapticScheduler::now() {
+#if defined(WIN32) | defined(WIN64)
+	static LARGE_INTEGER freq = { 0 };
+	if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (long long)((double)counter.QuadPart * ((double)NS_PER_SECOND / (double)freq.QuadPart));
+#elif defined(LINUX)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts); // same clock clock_nanosleep waits on
+	return (long long)ts.tv_sec * NS_PER_SECOND + ts.tv_nsec;
+#else
+	return (long long)(cPrecisionClock::getCPUTimeSeconds() * NS_PER_SECOND);
+#endif
+}
+
+
+/**
+ * To put the thread to sleep until an absolute time given in nanoseconds.
+ */
+void HapticScheduler::sleepUntil(long long a_deadline) {
+#if defined(LINUX)
+	struct timespec ts;
+	ts.tv_sec = (time_t)(a_deadline / NS_PER_SECOND);
+	ts.tv_nsec = (long)(a_deadline % NS_PER_SECOND);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {}
+#elif defined(WIN32) | defined(WIN64)
+	// Sleep() only has millisecond resolution, sleep in whole milliseconds while we can
+	long long remaining = a_deadline - now();
+	while (remaining > 1000000) {
+		Sleep((DWORD)(remaining / 1000000));
+		remaining = a_deadline - now();
+	}
+#else
+	long long remaining = a_deadline - now();
+	if (remaining > 0) {
+		struct timespec ts;
+		ts.tv_sec = (time_t)(remaining / NS_PER_SECOND);
+		ts.tv_nsec = (long)(remaining % NS_PER_SECOND);
+		nanosleep(&ts, NULL);
+	}
+#endif
+}
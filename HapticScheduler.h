@@ -0,0 +1,63 @@
+/**
+ * Filename: HapticScheduler.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef HAPTICSCHEDULER_H
+#define HAPTICSCHEDULER_H
+
+#include "chai3d.h"
+#include <atomic>
+
+using namespace chai3d;
+using namespace std;
+
+// haptic rates supported by the scheduler (in Hz)
+constexpr unsigned int HAPTIC_RATE_500HZ = 500;
+constexpr unsigned int HAPTIC_RATE_1KHZ = 1000;
+constexpr unsigned int HAPTIC_RATE_2KHZ = 2000;
+constexpr unsigned int HAPTIC_RATE_4KHZ = 4000;
+
+class HapticScheduler {
+// Public functions
+public:
+	HapticScheduler(unsigned int a_rate = HAPTIC_RATE_1KHZ); // rate of the haptic loop in Hz
+	~HapticScheduler();
+
+	bool setRate(unsigned int a_rate);
+	unsigned int getRate() const { return m_rate; }
+	double getPeriod() const { return m_period; } // constant time step handed to the game in seconds
+
+	void setSpinMargin(double a_seconds); // how long before a deadline we stop sleeping and start spinning
+	void setRealTime(bool a_realTime) { m_realTime = a_realTime; } // if false, ticks run back to back in virtual time
+	bool getRealTime() const { return m_realTime; }
+
+	void start();
+	bool waitForNextTick();
+
+	unsigned long long getTickCount() const { return m_ticks.load(memory_order_acquire); } // safe from the device I/O threads
+	unsigned long long getMissedDeadlines() const { return m_missed; }
+
+	static long long now(); // monotonic time in nanoseconds
+
+// Private functions
+private:
+	static void sleepUntil(long long a_deadline);
+
+// Private variables
+private:
+	unsigned int m_rate; // haptic rate in Hz
+	double m_period; // period of one tick in seconds
+	long long m_periodNs; // period of one tick in nanoseconds
+	long long m_spinMarginNs; // time before the deadline where we spin instead of sleep
+
+	long long m_deadline; // absolute time of the next tick in nanoseconds
+	bool m_realTime; // if the ticks are paced against the wall clock
+
+	atomic<unsigned long long> m_ticks; // number of ticks that have been scheduled, read by the virtual device clocks
+	unsigned long long m_missed; // number of ticks that finished after their deadline
+};
+
+#endif
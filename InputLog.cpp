@@ -0,0 +1,116 @@
+/**
+ * Filename: InputLog.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "InputLog.h"
+#include "chai3d.h"
+
+#if !(defined(WIN32) | defined(WIN64))
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace chai3d;
+using namespace std;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+InputLogFile::InputLogFile() {
+	m_records = NULL;
+	m_count = 0;
+	m_data = NULL;
+	m_size = 0;
+#if defined(WIN32) | defined(WIN64)
+	m_file = INVALID_HANDLE_VALUE;
+	m_mapping = NULL;
+#endif
+}
+
+
+InputLogFile::~InputLogFile() {
+	close();
+}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To map a log into memory and check its header. Returns false if the file can not be mapped or
+ * was not written by a compatible recorder.
+ */
+bool InputLogFile::open(const string& a_filename) {
+	close();
+
+#if defined(WIN32) | defined(WIN64)
+	m_file = CreateFileA(a_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (m_file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file, &size) || (size.QuadPart < (LONGLONG)sizeof(InputLogHeader))) {
+		close();
+		return false;
+	}
+	m_size = (size_t)size.QuadPart;
+
+	m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m_mapping == NULL) {
+		close();
+		return false;
+	}
+	m_data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	int fd = ::open(a_filename.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if ((fstat(fd, &st) != 0) || (st.st_size < (off_t)sizeof(InputLogHeader))) {
+		::close(fd);
+		return false;
+	}
+	m_size = (size_t)st.st_size;
+
+	m_data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); // the mapping keeps the file alive
+	if (m_data == MAP_FAILED) m_data = NULL;
+#endif
+
+	if (m_data == NULL) {
+		close();
+		return false;
+	}
+
+	m_header = *(const InputLogHeader*)m_data;
+	if ((m_header.magic != INPUT_LOG_MAGIC) || (m_header.version != INPUT_LOG_VERSION) ||
+		(m_header.recordSize != sizeof(InputLogRecord))) {
+		close();
+		return false;
+	}
+
+	// a partly written last record (recording was killed) is ignored
+	m_records = (const InputLogRecord*)((const char*)m_data + sizeof(InputLogHeader));
+	m_count = (m_size - sizeof(InputLogHeader)) / sizeof(InputLogRecord);
+	return true;
+}
+
+
+/**
+ * To unmap the log.
+ */
+void InputLogFile::close() {
+#if defined(WIN32) | defined(WIN64)
+	if (m_data != NULL) UnmapViewOfFile(m_data);
+	if (m_mapping != NULL) CloseHandle(m_mapping);
+	if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+	m_mapping = NULL;
+	m_file = INVALID_HANDLE_VALUE;
+#else
+	if (m_data != NULL) munmap(m_data, m_size);
+#endif
+
+	m_data = NULL;
+	m_size = 0;
+	m_records = NULL;
+	m_count = 0;
+}
@@ -0,0 +1,75 @@
+/**
+ * Filename: InputLog.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef INPUTLOG_H
+#define INPUTLOG_H
+
+#include "chai3d.h"
+#include <cstdint>
+
+using namespace chai3d;
+using namespace std;
+
+// identifies an input log file and the layout of its records
+constexpr uint32_t INPUT_LOG_MAGIC = 0x4C494248; // "HBIL"
+constexpr uint32_t INPUT_LOG_VERSION = 2;
+
+// written once at the start of a log
+typedef struct InputLogHeader {
+	uint32_t magic; // INPUT_LOG_MAGIC
+	uint32_t version; // INPUT_LOG_VERSION
+	uint32_t deviceCount; // number of devices recorded
+	uint32_t rate; // haptic rate the log was recorded at in Hz
+	uint32_t recordSize; // size of one InputLogRecord in bytes
+	uint64_t seed; // random seed the levels were generated from
+} InputLogHeader;
+
+// device input read on one haptic tick, appended to the log for every device on every tick
+typedef struct InputLogRecord {
+	uint64_t tick; // haptic tick the input was read on
+	double time; // wall clock time since recording started in seconds
+	uint32_t device; // index of the device
+	uint32_t switches; // user switch bitmask
+	double position[3]; // getPosition()
+	double rotation[9]; // getRotation(), row major
+	double velocity[3]; // getLinearVelocity()
+} InputLogRecord;
+
+
+/**
+ * Read only view of an input log. The file is memory mapped so a replay never touches the disk
+ * from the haptic thread after it has been opened.
+ */
+class InputLogFile {
+// Public functions
+public:
+	InputLogFile();
+	~InputLogFile();
+
+	bool open(const string& a_filename);
+	void close();
+	bool isOpen() const { return m_records != NULL; }
+
+	const InputLogHeader& getHeader() const { return m_header; }
+	size_t getRecordCount() const { return m_count; }
+	const InputLogRecord& getRecord(size_t a_index) const { return m_records[a_index]; }
+
+// Private variables
+private:
+	InputLogHeader m_header; // header of the open log
+	const InputLogRecord* m_records; // first record in the mapped file
+	size_t m_count; // number of complete records in the file
+
+	void* m_data; // start of the mapping
+	size_t m_size; // size of the mapping in bytes
+#if defined(WIN32) | defined(WIN64)
+	HANDLE m_file; // handle to the log file
+	HANDLE m_mapping; // handle to the file mapping
+#endif
+};
+
+#endif
@@ -0,0 +1,155 @@
+/**
+ * Filename: InputRecorder.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "InputRecorder.h"
+#include "chai3d.h"
+#include <cstring>
+
+using namespace chai3d;
+using namespace std;
+
+// records written to disk per fwrite call
+constexpr size_t INPUT_RECORDER_BATCH = 256;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+InputRecorder::InputRecorder() {
+	m_ring = new InputLogRecord[INPUT_RECORDER_CAPACITY];
+	m_head.store(0);
+	m_tail.store(0);
+	m_dropped.store(0);
+
+	m_file = NULL;
+	m_writerThread = NULL;
+	m_running.store(false);
+	m_finished.store(true);
+	m_written = 0;
+}
+
+
+InputRecorder::~InputRecorder() {
+	close();
+	delete[] m_ring;
+}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To create the log file, write its header and start the writer thread.
+ */
+bool InputRecorder::open(const string& a_filename, unsigned int a_deviceCount, unsigned int a_rate, uint64_t a_seed) {
+	close();
+
+	m_file = fopen(a_filename.c_str(), "wb");
+	if (m_file == NULL) return false;
+
+	InputLogHeader header;
+	memset(&header, 0, sizeof(header)); // no uninitialised padding in the file
+	header.magic = INPUT_LOG_MAGIC;
+	header.version = INPUT_LOG_VERSION;
+	header.deviceCount = a_deviceCount;
+	header.rate = a_rate;
+	header.recordSize = sizeof(InputLogRecord);
+	header.seed = a_seed;
+	if (fwrite(&header, sizeof(header), 1, m_file) != 1) {
+		fclose(m_file);
+		m_file = NULL;
+		return false;
+	}
+
+	m_head.store(0);
+	m_tail.store(0);
+	m_dropped.store(0);
+	m_written = 0;
+	m_clock.start(true);
+
+	m_running.store(true);
+	m_finished.store(false);
+	m_writerThread = new cThread();
+	m_writerThread->start(writerLoop, CTHREAD_PRIORITY_GRAPHICS, this);
+	return true;
+}
+
+
+/**
+ * To stop the writer thread, write out whatever is left in the ring and close the file.
+ */
+void InputRecorder::close() {
+	if (m_file == NULL) return;
+
+	m_running.store(false);
+	while (!m_finished.load()) { cSleepMs(1); }
+	delete m_writerThread;
+	m_writerThread = NULL;
+
+	while (drain() > 0) {}
+
+	fclose(m_file);
+	m_file = NULL;
+}
+
+
+/**
+ * To queue the input of one device for the current tick. Never blocks: if the ring is full the
+ * record is dropped.
+ */
+void InputRecorder::record(unsigned long long a_tick, unsigned int a_device, const cVector3d& a_position,
+						   const cMatrix3d& a_rotation, const cVector3d& a_velocity, unsigned int a_switches) {
+	if (m_file == NULL) return;
+
+	size_t head = m_head.load(memory_order_relaxed);
+	if (head - m_tail.load(memory_order_acquire) >= INPUT_RECORDER_CAPACITY) {
+		m_dropped.fetch_add(1, memory_order_relaxed);
+		return;
+	}
+
+	InputLogRecord &r = m_ring[head & (INPUT_RECORDER_CAPACITY - 1)];
+	r.tick = a_tick;
+	r.time = m_clock.getCurrentTimeSeconds();
+	r.device = a_device;
+	r.switches = a_switches;
+	for (int i = 0; i < 3; i++) {
+		r.position[i] = a_position(i);
+		r.velocity[i] = a_velocity(i);
+		for (int j = 0; j < 3; j++) r.rotation[3 * i + j] = a_rotation(i, j);
+	}
+
+	m_head.store(head + 1, memory_order_release);
+}
+
+
+/**
+ * To write the records that are currently in the ring. Returns how many were written.
+ */
+size_t InputRecorder::drain() {
+	size_t tail = m_tail.load(memory_order_relaxed);
+	size_t count = m_head.load(memory_order_acquire) - tail;
+	if (count == 0) return 0;
+
+	// write in contiguous pieces, stopping at the end of the ring
+	size_t first = tail & (INPUT_RECORDER_CAPACITY - 1);
+	if (count > INPUT_RECORDER_CAPACITY - first) count = INPUT_RECORDER_CAPACITY - first;
+	if (count > INPUT_RECORDER_BATCH) count = INPUT_RECORDER_BATCH;
+
+	fwrite(&m_ring[first], sizeof(InputLogRecord), count, m_file);
+	m_written += count;
+
+	m_tail.store(tail + count, memory_order_release);
+	return count;
+}
+
+
+/**
+ * Body of the writer thread. Drains the ring until the recorder is closed.
+ */
+void InputRecorder::writerLoop(void* a_recorder) {
+	InputRecorder* recorder = (InputRecorder*)a_recorder;
+
+	while (recorder->m_running.load()) {
+		if (recorder->drain() == 0) cSleepMs(1);
+	}
+
+	recorder->m_finished.store(true);
+}
@@ -0,0 +1,64 @@
+/**
+ * Filename: InputRecorder.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef INPUTRECORDER_H
+#define INPUTRECORDER_H
+
+#include "InputLog.h"
+#include "chai3d.h"
+#include <atomic>
+#include <cstdio>
+
+using namespace chai3d;
+using namespace std;
+
+// number of records the ring can hold before the writer thread has to catch up (power of two)
+constexpr size_t INPUT_RECORDER_CAPACITY = 1 << 14;
+
+/**
+ * Records the device input of every haptic tick to an append only binary log. The haptic thread
+ * only copies records into a lock-free single producer/single consumer ring, a background thread
+ * drains the ring to disk. If the disk ever falls a full ring behind, records are dropped and
+ * counted instead of stalling the haptic loop.
+ */
+class InputRecorder {
+// Public functions
+public:
+	InputRecorder();
+	~InputRecorder();
+
+	bool open(const string& a_filename, unsigned int a_deviceCount, unsigned int a_rate, uint64_t a_seed);
+	void close();
+	bool isRecording() const { return m_file != NULL; }
+
+	void record(unsigned long long a_tick, unsigned int a_device, const cVector3d& a_position,
+				const cMatrix3d& a_rotation, const cVector3d& a_velocity, unsigned int a_switches); // haptics thread only
+
+	unsigned long long getRecordCount() const { return m_written; }
+	unsigned long long getDroppedCount() const { return m_dropped.load(memory_order_relaxed); }
+
+// Private functions
+private:
+	static void writerLoop(void* a_recorder);
+	size_t drain(); // writer thread only
+
+// Private variables
+private:
+	InputLogRecord* m_ring; // records waiting to be written
+	alignas(64) atomic<size_t> m_head; // next slot the haptic thread writes
+	alignas(64) atomic<size_t> m_tail; // next slot the writer thread reads
+	alignas(64) atomic<unsigned long long> m_dropped; // records lost because the ring was full
+
+	FILE* m_file; // log being written
+	cThread* m_writerThread; // thread draining the ring
+	cPrecisionClock m_clock; // timestamps of the records
+	atomic<bool> m_running; // cleared to stop the writer thread
+	atomic<bool> m_finished; // set by the writer thread once it has exited
+	unsigned long long m_written; // records written to disk
+};
+
+#endif
@@ -0,0 +1,184 @@
+/**
+ * Filename: LevelModel.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "LevelModel.h"
+#include "chai3d.h"
+#include <algorithm>
+
+using namespace chai3d;
+using namespace std;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+LevelModel::LevelModel() {
+	m_settings = PipeSettings();
+	m_maxPipeRadius = 0.0;
+	m_maxTurbulenceLength = 0.0;
+}
+
+
+LevelModel::~LevelModel() {}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To empty the level and set the layout its pipes are drawn with. Memory is kept for the next level.
+ */
+void LevelModel::reset(const PipeSettings& a_settings) {
+	m_settings = a_settings;
+
+	m_pipeX.clear();
+	m_gapCenter.clear();
+	m_gapSize.clear();
+	m_pipeRadius.clear();
+
+	m_turbulenceBegin.clear();
+	m_turbulenceEnd.clear();
+	m_turbulencePeriod.clear();
+	m_turbulenceAmplitude.clear();
+	m_turbulenceWave.clear();
+
+	m_pipeOrder.clear();
+	m_sortedPipeX.clear();
+	m_maxPipeRadius = 0.0;
+	m_turbulenceOrder.clear();
+	m_sortedTurbulenceEnd.clear();
+	m_maxTurbulenceLength = 0.0;
+}
+
+
+/**
+ * To add the next pair of pipes of the level.
+ */
+void LevelModel::addPipe(const PipePair& a_pipe) {
+	m_pipeX.push_back(a_pipe.x);
+	m_gapCenter.push_back(a_pipe.gapCenter);
+	m_gapSize.push_back(a_pipe.gapSize);
+	m_pipeRadius.push_back(a_pipe.radius);
+}
+
+
+/**
+ * To add the next turbulence region of the level with the rumble baked for it.
+ */
+void LevelModel::addTurbulence(const turbulence& a_region, const TurbulenceWave& a_wave) {
+	m_turbulenceBegin.push_back(cMax(a_region.begin, a_region.end));
+	m_turbulenceEnd.push_back(cMin(a_region.begin, a_region.end));
+	m_turbulencePeriod.push_back(a_region.periodRange);
+	m_turbulenceAmplitude.push_back(a_region.amplitudeRange);
+	m_turbulenceWave.push_back(a_wave);
+}
+
+
+/**
+ * To sort the pipes and the turbulence regions by x for findPipes() and findTurbulence().
+ */
+void LevelModel::buildIndex() {
+	m_pipeOrder.resize(m_pipeX.size());
+	for (unsigned int i = 0; i < m_pipeOrder.size(); i++) m_pipeOrder[i] = i;
+	sort(m_pipeOrder.begin(), m_pipeOrder.end(), [this](unsigned int a, unsigned int b) { return m_pipeX[a] < m_pipeX[b]; });
+
+	m_sortedPipeX.resize(m_pipeOrder.size());
+	m_maxPipeRadius = 0.0;
+	for (unsigned int k = 0; k < m_pipeOrder.size(); k++) {
+		m_sortedPipeX[k] = m_pipeX[m_pipeOrder[k]];
+		m_maxPipeRadius = cMax(m_maxPipeRadius, m_pipeRadius[k]);
+	}
+
+	m_turbulenceOrder.resize(m_turbulenceEnd.size());
+	for (unsigned int i = 0; i < m_turbulenceOrder.size(); i++) m_turbulenceOrder[i] = i;
+	sort(m_turbulenceOrder.begin(), m_turbulenceOrder.end(), [this](unsigned int a, unsigned int b) { return m_turbulenceEnd[a] < m_turbulenceEnd[b]; });
+
+	m_sortedTurbulenceEnd.resize(m_turbulenceOrder.size());
+	m_maxTurbulenceLength = 0.0;
+	for (unsigned int k = 0; k < m_turbulenceOrder.size(); k++) {
+		m_sortedTurbulenceEnd[k] = m_turbulenceEnd[m_turbulenceOrder[k]];
+		m_maxTurbulenceLength = cMax(m_maxTurbulenceLength, m_turbulenceBegin[k] - m_turbulenceEnd[k]);
+	}
+}
+
+
+/**
+ * To get a pair of pipes by the order the bird meets them in.
+ */
+PipePair LevelModel::getPipe(unsigned int a_index) const {
+	PipePair pipe;
+	pipe.x = m_pipeX[a_index];
+	pipe.gapCenter = m_gapCenter[a_index];
+	pipe.gapSize = m_gapSize[a_index];
+	pipe.radius = m_pipeRadius[a_index];
+	return pipe;
+}
+
+
+/**
+ * To get where the two pipes of a pair stand and how tall they are.
+ */
+void LevelModel::getPipeGeometry(unsigned int a_index, cVector3d& a_topPos, double& a_topHeight, cVector3d& a_bottomPos, double& a_bottomHeight) const {
+	pipeGeometry(m_settings, getPipe(a_index), a_topPos, a_topHeight, a_bottomPos, a_bottomHeight);
+}
+
+
+/**
+ * To find the pairs of pipes that overlap [a_x0, a_x1] along the level. The indices are appended to
+ * a_pipes, which is cleared first. Takes O(log n) plus the number of pipes found.
+ */
+void LevelModel::findPipes(double a_x0, double a_x1, vector<unsigned int>& a_pipes) const {
+	a_pipes.clear();
+
+	// a pipe can reach at most the widest radius past its x
+	auto first = lower_bound(m_sortedPipeX.begin(), m_sortedPipeX.end(), a_x0 - m_maxPipeRadius);
+	auto last = upper_bound(first, m_sortedPipeX.end(), a_x1 + m_maxPipeRadius);
+
+	for (auto it = first; it != last; it++) {
+		unsigned int i = m_pipeOrder[it - m_sortedPipeX.begin()];
+		if ((m_pipeX[i] - m_pipeRadius[i] <= a_x1) && (m_pipeX[i] + m_pipeRadius[i] >= a_x0)) a_pipes.push_back(i);
+	}
+}
+
+
+/**
+ * To get a turbulence region by the order the bird meets them in.
+ */
+turbulence LevelModel::getTurbulence(unsigned int a_index) const {
+	turbulence region;
+	region.begin = m_turbulenceBegin[a_index];
+	region.end = m_turbulenceEnd[a_index];
+	region.periodRange = m_turbulencePeriod[a_index];
+	region.amplitudeRange = m_turbulenceAmplitude[a_index];
+	return region;
+}
+
+
+/**
+ * To find the turbulence regions that overlap [a_x0, a_x1] along the level. The indices are
+ * appended to a_regions, which is cleared first. Takes O(log n) plus the number of regions found.
+ */
+void LevelModel::findTurbulence(double a_x0, double a_x1, vector<unsigned int>& a_regions) const {
+	a_regions.clear();
+
+	// a region can reach at most the longest length past its end
+	auto first = lower_bound(m_sortedTurbulenceEnd.begin(), m_sortedTurbulenceEnd.end(), a_x0 - m_maxTurbulenceLength);
+	auto last = upper_bound(first, m_sortedTurbulenceEnd.end(), a_x1);
+
+	for (auto it = first; it != last; it++) {
+		unsigned int i = m_turbulenceOrder[it - m_sortedTurbulenceEnd.begin()];
+		if (m_turbulenceBegin[i] >= a_x0) a_regions.push_back(i);
+	}
+}
+
+
+/**
+ * To get where the two pipes of a pair stand and how tall they are. Both pipes reach past the
+ * ceiling and floor by the extension of the settings.
+ */
+void LevelModel::pipeGeometry(const PipeSettings& a_settings, const PipePair& a_pipe, cVector3d& a_topPos, double& a_topHeight,
+							  cVector3d& a_bottomPos, double& a_bottomHeight) {
+	a_topHeight = (a_settings.ceiling - a_pipe.gapCenter) - (a_pipe.gapSize / 2.0) + a_settings.extension;
+	a_topPos = cVector3d(a_pipe.x, 0, a_settings.ceiling - a_topHeight + a_settings.extension);
+
+	a_bottomHeight = (a_pipe.gapCenter - a_settings.floor) - (a_pipe.gapSize / 2.0) + a_settings.extension;
+	a_bottomPos = cVector3d(a_pipe.x, 0, a_settings.floor - a_settings.extension);
+}
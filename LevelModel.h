@@ -0,0 +1,116 @@
+/**
+ * Filename: LevelModel.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef LEVELMODEL_H
+#define LEVELMODEL_H
+
+#include "TurbulenceWave.h"
+#include "chai3d.h"
+#include <vector>
+
+using namespace chai3d;
+using namespace std;
+
+// structure for storing turublence parameters
+typedef struct turbulence {
+	double begin;
+	double end;
+	unsigned int periodRange;
+	unsigned int amplitudeRange;
+} turbulence;
+
+// pair of pipes, one hanging from the ceiling and one standing on the floor, with a gap in between
+typedef struct PipePair {
+	double x; // position of both pipes along the level
+	double gapCenter; // height of the middle of the gap
+	double gapSize; // height of the gap
+	double radius; // radius of both pipes
+} PipePair;
+
+// how the pipes of a difficulty are laid out
+typedef struct PipeSettings {
+	double minGap; // smallest gap between the pipes of a pair
+	double maxGap; // largest gap between the pipes of a pair
+	double minDistance; // smallest distance between two pairs
+	double maxDistance; // largest distance between two pairs
+	unsigned int numberOfPipes; // pairs in a level that has an end
+	double radius; // radius of the pipes
+	double ceiling; // top of the level
+	double floor; // bottom of the level
+	double extension; // length the pipes reach past the ceiling and floor
+} PipeSettings;
+
+// how the turbulence of a difficulty is laid out
+typedef struct TurbulenceSettings {
+	double minLength; // shortest region
+	double maxLength; // longest region
+	double minDistance; // smallest distance between two regions
+	double maxDistance; // largest distance between two regions of the endless track
+	unsigned int numTurbulence; // regions in a level that has an end
+	unsigned int period; // period range of the rumble
+	unsigned int amplitude; // amplitude range of the rumble
+} TurbulenceSettings;
+
+/**
+ * Plain data model of a level, independent of the scene graph. Pipe pairs and turbulence regions
+ * are kept as structures of arrays in the order the bird meets them. Each of them also has an index
+ * sorted by x so the obstacles or regions overlapping a range of x are found with a binary search
+ * instead of walking the level. Call buildIndex() after adding to the level, before searching it.
+ */
+class LevelModel {
+// Public functions
+public:
+	LevelModel();
+	~LevelModel();
+
+	void reset(const PipeSettings& a_settings);
+	const PipeSettings& getSettings() const { return m_settings; }
+
+	void addPipe(const PipePair& a_pipe);
+	void addTurbulence(const turbulence& a_region, const TurbulenceWave& a_wave);
+	void buildIndex();
+
+	unsigned int getPipeCount() const { return (unsigned int)m_pipeX.size(); }
+	PipePair getPipe(unsigned int a_index) const;
+	void getPipeGeometry(unsigned int a_index, cVector3d& a_topPos, double& a_topHeight, cVector3d& a_bottomPos, double& a_bottomHeight) const;
+	void findPipes(double a_x0, double a_x1, vector<unsigned int>& a_pipes) const;
+
+	unsigned int getTurbulenceCount() const { return (unsigned int)m_turbulenceBegin.size(); }
+	turbulence getTurbulence(unsigned int a_index) const;
+	const TurbulenceWave& getTurbulenceWave(unsigned int a_index) const { return m_turbulenceWave[a_index]; }
+	void findTurbulence(double a_x0, double a_x1, vector<unsigned int>& a_regions) const;
+
+	static void pipeGeometry(const PipeSettings& a_settings, const PipePair& a_pipe, cVector3d& a_topPos, double& a_topHeight,
+							 cVector3d& a_bottomPos, double& a_bottomHeight);
+
+// Private variables
+private:
+	PipeSettings m_settings; // ceiling, floor and pipe extension of the level
+
+	// pipe pairs in the order the bird meets them
+	vector<double> m_pipeX; // position along the level
+	vector<double> m_gapCenter; // height of the middle of the gap
+	vector<double> m_gapSize; // height of the gap
+	vector<double> m_pipeRadius; // radius of the pipes
+
+	// turbulence regions in the order the bird meets them
+	vector<double> m_turbulenceBegin; // start of the region (largest x)
+	vector<double> m_turbulenceEnd; // end of the region (smallest x)
+	vector<unsigned int> m_turbulencePeriod; // period range of the rumble
+	vector<unsigned int> m_turbulenceAmplitude; // amplitude range of the rumble
+	vector<TurbulenceWave> m_turbulenceWave; // rumble baked for the region
+
+	// x-sorted indices
+	vector<unsigned int> m_pipeOrder; // pipes sorted by x
+	vector<double> m_sortedPipeX; // x of the pipes in that order
+	double m_maxPipeRadius; // widest pipe, how far a pipe can reach from its x
+	vector<unsigned int> m_turbulenceOrder; // regions sorted by their end
+	vector<double> m_sortedTurbulenceEnd; // end of the regions in that order
+	double m_maxTurbulenceLength; // longest region, how far a region can reach from its end
+};
+
+#endif
@@ -0,0 +1,56 @@
+/**
+ * Filename: LevelRandom.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "LevelRandom.h"
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+// golden ratio increment of splitmix64
+constexpr uint64_t RANDOM_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+LevelRandom::LevelRandom() {
+	seed(0, 0);
+}
+
+
+LevelRandom::LevelRandom(uint64_t a_seed, uint64_t a_stream) {
+	seed(a_seed, a_stream);
+}
+
+
+LevelRandom::~LevelRandom() {}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To start the stream a_stream of the seed a_seed from its first value.
+ */
+void LevelRandom::seed(uint64_t a_seed, uint64_t a_stream) {
+	m_key = mix(a_seed ^ mix(a_stream + RANDOM_GAMMA));
+	m_counter = 0;
+}
+
+
+/**
+ * To get the value a_counter of the stream without moving the stream.
+ */
+uint64_t LevelRandom::at(uint64_t a_counter) const {
+	return mix(m_key + RANDOM_GAMMA * (a_counter + 1));
+}
+
+
+/**
+ * To scramble a value with the splitmix64 finalizer.
+ */
+uint64_t LevelRandom::mix(uint64_t a_value) {
+	uint64_t z = a_value;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
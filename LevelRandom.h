@@ -0,0 +1,47 @@
+/**
+ * Filename: LevelRandom.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef LEVELRANDOM_H
+#define LEVELRANDOM_H
+
+#include "chai3d.h"
+#include <cstdint>
+
+using namespace chai3d;
+using namespace std;
+
+/**
+ * Counter based random number generator. The n-th number of a stream is a hash (splitmix64) of the
+ * seed, the stream and n, so it holds no state other than a counter, takes no lock and gives the same
+ * numbers for the same seed on every platform. Every level, the endless track and the turbulence of
+ * the bird draw from their own stream, so a run is reproduced by starting it with the same seed.
+ */
+class LevelRandom {
+// Public functions
+public:
+	LevelRandom();
+	LevelRandom(uint64_t a_seed, uint64_t a_stream);
+	~LevelRandom();
+
+	void seed(uint64_t a_seed, uint64_t a_stream);
+
+	uint64_t at(uint64_t a_counter) const;
+	uint64_t next() { return at(m_counter++); }
+	unsigned int nextInt(unsigned int a_range) { return (unsigned int)(next() % a_range); } // in [0, a_range)
+
+	uint64_t getCounter() const { return m_counter; }
+	void setCounter(uint64_t a_counter) { m_counter = a_counter; }
+
+	static uint64_t mix(uint64_t a_value);
+
+// Private variables
+private:
+	uint64_t m_key; // seed and stream hashed together
+	uint64_t m_counter; // number of the next value of the stream
+};
+
+#endif
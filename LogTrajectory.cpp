@@ -0,0 +1,56 @@
+/**
+ * Filename: LogTrajectory.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "LogTrajectory.h"
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+LogTrajectory::LogTrajectory(const InputLogFile* a_log, unsigned int a_device) {
+	m_log = a_log;
+	m_rate = m_log->getHeader().rate;
+
+	// index the records of this device once so lookups are a binary search
+	for (size_t i = 0; i < m_log->getRecordCount(); i++) {
+		if (m_log->getRecord(i).device == a_device) m_records.push_back(i);
+	}
+}
+
+
+LogTrajectory::~LogTrajectory() {}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To get the recorded hand position at a time, interpolated between the two nearest ticks. The
+ * buttons are the ones held on the earlier tick. Past either end of the log the end is held.
+ */
+void LogTrajectory::getHand(const double a_time, cVector3d& a_position, unsigned int& a_userSwitches) {
+	a_position.zero();
+	a_userSwitches = 0;
+	if (m_records.empty()) return;
+
+	double tick = a_time * m_rate;
+
+	// first record later than the requested time
+	size_t lo = 0, hi = m_records.size();
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if ((double)m_log->getRecord(m_records[mid]).tick <= tick) lo = mid + 1;
+		else hi = mid;
+	}
+
+	const InputLogRecord &a = m_log->getRecord(m_records[lo > 0 ? lo - 1 : 0]);
+	const InputLogRecord &b = m_log->getRecord(m_records[lo < m_records.size() ? lo : m_records.size() - 1]);
+
+	double f = 0.0;
+	if (b.tick > a.tick) f = cClamp((tick - (double)a.tick) / (double)(b.tick - a.tick), 0.0, 1.0);
+
+	for (int i = 0; i < 3; i++) a_position(i) = (1.0 - f) * a.position[i] + f * b.position[i];
+	a_userSwitches = a.switches;
+}
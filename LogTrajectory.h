@@ -0,0 +1,43 @@
+/**
+ * Filename: LogTrajectory.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef LOGTRAJECTORY_H
+#define LOGTRAJECTORY_H
+
+#include "InputLog.h"
+#include "chai3d.h"
+#include <vector>
+
+using namespace chai3d;
+using namespace std;
+
+class LogTrajectory;
+typedef std::shared_ptr<LogTrajectory> LogTrajectoryPtr;
+
+/**
+ * Hand trajectory for the virtual Falcon that follows the positions and buttons of one device in
+ * a recorded input log. Unlike ReplayDevice the recorded positions only guide the simulated hand,
+ * so the forces of the game still act on the device.
+ */
+class LogTrajectory : public cGenericHandTrajectory {
+// Public functions
+public:
+	LogTrajectory(const InputLogFile* a_log, unsigned int a_device);
+	virtual ~LogTrajectory();
+
+	static LogTrajectoryPtr create(const InputLogFile* a_log, unsigned int a_device) { return (std::make_shared<LogTrajectory>(a_log, a_device)); }
+
+	virtual void getHand(const double a_time, cVector3d& a_position, unsigned int& a_userSwitches);
+
+// Private variables
+private:
+	const InputLogFile* m_log; // log being followed
+	vector<size_t> m_records; // indices of the records of this device, in tick order
+	double m_rate; // rate the log was recorded at in Hz
+};
+
+#endif
@@ -0,0 +1,370 @@
+/**
+ * Filename: PipeRenderer.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "PipeRenderer.h"
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+// vertex attributes of the instancing shader
+constexpr GLuint PIPE_ATTRIB_POSITION = 0; // unit cylinder vertex
+constexpr GLuint PIPE_ATTRIB_NORMAL = 1; // unit cylinder normal
+constexpr GLuint PIPE_ATTRIB_BASE = 2; // per instance: x, y, z of the base and radius
+constexpr GLuint PIPE_ATTRIB_EXTENT = 3; // per instance: height and colour
+
+// floats per vertex of the unit cylinder, position then normal
+constexpr int PIPE_VERTEX_FLOATS = 6;
+
+// scales the unit cylinder onto each instance and lights it with the first light, as the fixed pipeline
+// lights a chai3d material (ambient half the diffuse colour)
+static const char* PIPE_VERTEX_SHADER =
+	"#version 120\n"
+	"attribute vec3 a_position;\n"
+	"attribute vec3 a_normal;\n"
+	"attribute vec4 a_base;\n"
+	"attribute vec4 a_extent;\n"
+	"varying vec4 v_color;\n"
+	"void main() {\n"
+	"	vec3 p = a_base.xyz + vec3(a_position.xy * a_base.w, a_position.z * a_extent.x);\n"
+	"	vec4 eye = gl_ModelViewMatrix * vec4(p, 1.0);\n"
+	"	vec3 n = normalize(gl_NormalMatrix * a_normal);\n"
+	"	vec3 l = normalize(gl_LightSource[0].position.xyz - eye.xyz * gl_LightSource[0].position.w);\n"
+	"	vec3 c = a_extent.yzw;\n"
+	"	vec3 lit = 0.5 * c * (gl_LightModel.ambient.rgb + gl_LightSource[0].ambient.rgb) + c * max(dot(n, l), 0.0) * gl_LightSource[0].diffuse.rgb;\n"
+	"	v_color = vec4(lit, 1.0);\n"
+	"	gl_Position = gl_ProjectionMatrix * eye;\n"
+	"}\n";
+
+static const char* PIPE_FRAGMENT_SHADER =
+	"#version 120\n"
+	"varying vec4 v_color;\n"
+	"void main() {\n"
+	"	gl_FragColor = v_color;\n"
+	"}\n";
+
+// to compile one stage of the instancing shader, 0 on failure
+static GLuint compileShader(GLenum a_type, const char* a_source);
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+PipeRenderer::PipeRenderer() {
+	m_initialized = false;
+	m_instanced = false;
+	m_cylinderBuffer = 0;
+	m_instanceBuffer = 0;
+	m_program = 0;
+	m_vertexCount = 0;
+}
+
+
+PipeRenderer::~PipeRenderer() {
+	// the node has to be deleted on the graphics thread, while the context of its GL objects is current
+#ifdef C_USE_OPENGL
+	if (m_cylinderBuffer != 0) glDeleteBuffers(1, &m_cylinderBuffer);
+	if (m_instanceBuffer != 0) glDeleteBuffers(1, &m_instanceBuffer);
+	if (m_program != 0) glDeleteProgram(m_program);
+#endif
+	m_cylinderBuffer = 0;
+	m_instanceBuffer = 0;
+	m_program = 0;
+}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To remove every pipe.
+ */
+void PipeRenderer::clear() {
+	m_pipes.clear();
+	m_enabled.clear();
+	m_visible.clear();
+}
+
+
+/**
+ * To add a pipe standing on a_base. Returns its index.
+ */
+unsigned int PipeRenderer::addPipe(const cVector3d& a_base, double a_radius, double a_height, const cColorf& a_color) {
+	m_pipes.push_back(makePipe(a_base, a_radius, a_height, a_color));
+	m_enabled.push_back(1);
+	return (unsigned int)m_pipes.size() - 1;
+}
+
+
+/**
+ * To replace every pipe with a_pipes, all enabled.
+ */
+void PipeRenderer::setPipes(const vector<PipeInstance>& a_pipes) {
+	m_pipes = a_pipes;
+	m_enabled.assign(a_pipes.size(), 1);
+}
+
+
+/**
+ * To move and resize a pipe, keeping its colour.
+ */
+void PipeRenderer::setPipe(unsigned int a_index, const cVector3d& a_base, double a_radius, double a_height) {
+	PipeInstance& pipe = m_pipes[a_index];
+	pipe.x = (float)a_base.x();
+	pipe.y = (float)a_base.y();
+	pipe.z = (float)a_base.z();
+	pipe.radius = (float)a_radius;
+	pipe.height = (float)a_height;
+}
+
+
+/**
+ * To lay a pipe out the way the instance buffer holds it.
+ */
+PipeInstance PipeRenderer::makePipe(const cVector3d& a_base, double a_radius, double a_height, const cColorf& a_color) {
+	PipeInstance pipe;
+	pipe.x = (float)a_base.x();
+	pipe.y = (float)a_base.y();
+	pipe.z = (float)a_base.z();
+	pipe.radius = (float)a_radius;
+	pipe.height = (float)a_height;
+	pipe.r = a_color.getR();
+	pipe.g = a_color.getG();
+	pipe.b = a_color.getB();
+	return pipe;
+}
+
+
+/**
+ * To draw the visible pipes.
+ */
+void PipeRenderer::render(cRenderOptions& a_options) {
+#ifdef C_USE_OPENGL
+	if (!SECTION_RENDER_PARTS_WITH_MATERIALS(a_options, m_useTransparency)) return;
+	if (!m_initialized && !initGL()) return;
+
+	cull();
+	if (m_visible.empty()) return;
+
+	if (m_instanced) drawInstanced();
+	else drawEach();
+#endif
+}
+
+
+/**
+ * To tessellate the unit cylinder (radius 1, base at the origin, height 1 along z) into a vertex
+ * buffer and, if the context supports it, build the instancing shader. Needs the display context.
+ */
+bool PipeRenderer::initGL() {
+	vector<float> vertices;
+	vertices.reserve(PIPE_RENDER_SEGMENTS * 12 * PIPE_VERTEX_FLOATS);
+	auto vertex = [&vertices](float x, float y, float z, float nx, float ny, float nz) {
+		vertices.push_back(x);
+		vertices.push_back(y);
+		vertices.push_back(z);
+		vertices.push_back(nx);
+		vertices.push_back(ny);
+		vertices.push_back(nz);
+	};
+
+	for (unsigned int i = 0; i < PIPE_RENDER_SEGMENTS; i++) {
+		float a0 = (float)(C_TWO_PI * i / PIPE_RENDER_SEGMENTS);
+		float a1 = (float)(C_TWO_PI * (i + 1) / PIPE_RENDER_SEGMENTS);
+		float c0 = cos(a0), s0 = sin(a0);
+		float c1 = cos(a1), s1 = sin(a1);
+
+		// side
+		vertex(c0, s0, 0.0f, c0, s0, 0.0f);
+		vertex(c1, s1, 0.0f, c1, s1, 0.0f);
+		vertex(c1, s1, 1.0f, c1, s1, 0.0f);
+		vertex(c0, s0, 0.0f, c0, s0, 0.0f);
+		vertex(c1, s1, 1.0f, c1, s1, 0.0f);
+		vertex(c0, s0, 1.0f, c0, s0, 0.0f);
+
+		// bottom and top caps
+		vertex(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f);
+		vertex(c1, s1, 0.0f, 0.0f, 0.0f, -1.0f);
+		vertex(c0, s0, 0.0f, 0.0f, 0.0f, -1.0f);
+		vertex(0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f);
+		vertex(c0, s0, 1.0f, 0.0f, 0.0f, 1.0f);
+		vertex(c1, s1, 1.0f, 0.0f, 0.0f, 1.0f);
+	}
+	m_vertexCount = (GLsizei)(vertices.size() / PIPE_VERTEX_FLOATS);
+
+	glGenBuffers(1, &m_cylinderBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_cylinderBuffer);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+#ifdef GLEW_VERSION
+	m_instanced = GLEW_VERSION_3_3 ? true : false;
+#endif
+
+	if (m_instanced) {
+		GLuint vertexShader = compileShader(GL_VERTEX_SHADER, PIPE_VERTEX_SHADER);
+		GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, PIPE_FRAGMENT_SHADER);
+
+		GLint linked = GL_FALSE;
+		if ((vertexShader != 0) && (fragmentShader != 0)) {
+			m_program = glCreateProgram();
+			glAttachShader(m_program, vertexShader);
+			glAttachShader(m_program, fragmentShader);
+			glBindAttribLocation(m_program, PIPE_ATTRIB_POSITION, "a_position");
+			glBindAttribLocation(m_program, PIPE_ATTRIB_NORMAL, "a_normal");
+			glBindAttribLocation(m_program, PIPE_ATTRIB_BASE, "a_base");
+			glBindAttribLocation(m_program, PIPE_ATTRIB_EXTENT, "a_extent");
+			glLinkProgram(m_program);
+			glGetProgramiv(m_program, GL_LINK_STATUS, &linked);
+		}
+		if (vertexShader != 0) glDeleteShader(vertexShader);
+		if (fragmentShader != 0) glDeleteShader(fragmentShader);
+
+		if (linked == GL_TRUE) {
+			glGenBuffers(1, &m_instanceBuffer);
+		} else {
+			// draw one pipe at a time instead
+			if (m_program != 0) glDeleteProgram(m_program);
+			m_program = 0;
+			m_instanced = false;
+		}
+	}
+
+	m_initialized = true;
+	return true;
+}
+
+
+/**
+ * To collect the enabled pipes whose bounding box is at least partly inside the view frustum. The
+ * planes of the frustum are taken from the projection and modelview matrices the pipes are drawn
+ * with.
+ */
+void PipeRenderer::cull() {
+	GLfloat modelview[16];
+	GLfloat projection[16];
+	glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+	glGetFloatv(GL_PROJECTION_MATRIX, projection);
+
+	// clip = projection * modelview, column major
+	float clip[16];
+	for (int c = 0; c < 4; c++) {
+		for (int r = 0; r < 4; r++) {
+			clip[c * 4 + r] = 0.0f;
+			for (int k = 0; k < 4; k++) clip[c * 4 + r] += projection[k * 4 + r] * modelview[c * 4 + k];
+		}
+	}
+
+	// left, right, bottom, top, near and far planes, each the last row of clip plus or minus another row
+	float planes[6][4];
+	for (int p = 0; p < 6; p++) {
+		int row = p / 2;
+		float sign = (p % 2 == 0) ? 1.0f : -1.0f;
+		for (int i = 0; i < 4; i++) planes[p][i] = clip[i * 4 + 3] + sign * clip[i * 4 + row];
+	}
+
+	m_visible.clear();
+	for (size_t i = 0; i < m_pipes.size(); i++) {
+		if (!m_enabled[i]) continue;
+		const PipeInstance& pipe = m_pipes[i];
+
+		float low[3] = { pipe.x - pipe.radius, pipe.y - pipe.radius, pipe.z };
+		float high[3] = { pipe.x + pipe.radius, pipe.y + pipe.radius, pipe.z + pipe.height };
+
+		bool inside = true;
+		for (int p = 0; (p < 6) && inside; p++) {
+			// the corner of the box furthest along the plane normal
+			float d = planes[p][3];
+			for (int k = 0; k < 3; k++) d += planes[p][k] * (planes[p][k] >= 0.0f ? high[k] : low[k]);
+			inside = (d >= 0.0f);
+		}
+		if (inside) m_visible.push_back(pipe);
+	}
+}
+
+
+/**
+ * To upload the visible pipes into the instance buffer and draw them all with one call.
+ */
+void PipeRenderer::drawInstanced() {
+	glUseProgram(m_program);
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_cylinderBuffer);
+	glEnableVertexAttribArray(PIPE_ATTRIB_POSITION);
+	glVertexAttribPointer(PIPE_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, PIPE_VERTEX_FLOATS * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(PIPE_ATTRIB_NORMAL);
+	glVertexAttribPointer(PIPE_ATTRIB_NORMAL, 3, GL_FLOAT, GL_FALSE, PIPE_VERTEX_FLOATS * sizeof(float), (void*)(3 * sizeof(float)));
+
+	// orphan last frame's instances so the upload does not wait for the GPU to finish with them
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_visible.size() * sizeof(PipeInstance), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, m_visible.size() * sizeof(PipeInstance), m_visible.data());
+	glEnableVertexAttribArray(PIPE_ATTRIB_BASE);
+	glVertexAttribPointer(PIPE_ATTRIB_BASE, 4, GL_FLOAT, GL_FALSE, sizeof(PipeInstance), (void*)0);
+	glVertexAttribDivisor(PIPE_ATTRIB_BASE, 1);
+	glEnableVertexAttribArray(PIPE_ATTRIB_EXTENT);
+	glVertexAttribPointer(PIPE_ATTRIB_EXTENT, 4, GL_FLOAT, GL_FALSE, sizeof(PipeInstance), (void*)(4 * sizeof(float)));
+	glVertexAttribDivisor(PIPE_ATTRIB_EXTENT, 1);
+
+	glDrawArraysInstanced(GL_TRIANGLES, 0, m_vertexCount, (GLsizei)m_visible.size());
+
+	glVertexAttribDivisor(PIPE_ATTRIB_BASE, 0);
+	glVertexAttribDivisor(PIPE_ATTRIB_EXTENT, 0);
+	glDisableVertexAttribArray(PIPE_ATTRIB_POSITION);
+	glDisableVertexAttribArray(PIPE_ATTRIB_NORMAL);
+	glDisableVertexAttribArray(PIPE_ATTRIB_BASE);
+	glDisableVertexAttribArray(PIPE_ATTRIB_EXTENT);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glUseProgram(0);
+}
+
+
+/**
+ * To draw the visible pipes one at a time from the cached cylinder, for contexts without
+ * instancing. Still no geometry is generated per frame.
+ */
+void PipeRenderer::drawEach() {
+	glBindBuffer(GL_ARRAY_BUFFER, m_cylinderBuffer);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, PIPE_VERTEX_FLOATS * sizeof(float), (void*)0);
+	glEnableClientState(GL_NORMAL_ARRAY);
+	glNormalPointer(GL_FLOAT, PIPE_VERTEX_FLOATS * sizeof(float), (void*)(3 * sizeof(float)));
+
+	// the colour of each pipe is its diffuse material, the normals are rescaled with the pipe
+	glEnable(GL_COLOR_MATERIAL);
+	glColorMaterial(GL_FRONT_AND_BACK, GL_DIFFUSE);
+	glEnable(GL_NORMALIZE);
+
+	for (const PipeInstance& pipe : m_visible) {
+		glPushMatrix();
+		glTranslatef(pipe.x, pipe.y, pipe.z);
+		glScalef(pipe.radius, pipe.radius, pipe.height);
+		GLfloat ambient[4] = { 0.5f * pipe.r, 0.5f * pipe.g, 0.5f * pipe.b, 1.0f };
+		glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, ambient);
+		glColor3f(pipe.r, pipe.g, pipe.b);
+		glDrawArrays(GL_TRIANGLES, 0, m_vertexCount);
+		glPopMatrix();
+	}
+
+	glDisable(GL_NORMALIZE);
+	glDisable(GL_COLOR_MATERIAL);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_NORMAL_ARRAY);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+
+/**
+ * To compile one stage of the instancing shader, 0 on failure.
+ */
+static GLuint compileShader(GLenum a_type, const char* a_source) {
+	GLuint shader = glCreateShader(a_type);
+	glShaderSource(shader, 1, &a_source, NULL);
+	glCompileShader(shader);
+
+	GLint compiled = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+	if (compiled != GL_TRUE) {
+		glDeleteShader(shader);
+		return 0;
+	}
+	return shader;
+}
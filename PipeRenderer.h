@@ -0,0 +1,78 @@
+/**
+ * Filename: PipeRenderer.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef PIPERENDERER_H
+#define PIPERENDERER_H
+
+#include "chai3d.h"
+#include <vector>
+
+using namespace chai3d;
+using namespace std;
+
+// segments around the cylinder that every pipe is drawn with
+constexpr unsigned int PIPE_RENDER_SEGMENTS = 36;
+
+// one upright pipe as the renderer draws it, laid out as the per-instance buffer
+typedef struct PipeInstance {
+	float x, y, z; // centre of the base
+	float radius; // radius of the pipe
+	float height; // height of the pipe
+	float r, g, b; // colour of the pipe
+} PipeInstance;
+
+/**
+ * Scene node drawing any number of upright pipes as instances of one cylinder. The unit cylinder is
+ * tessellated once into a vertex buffer. Every frame the enabled pipes are culled against the view
+ * frustum, the ones left are copied into an instance buffer and all of them are drawn with a single
+ * instanced call, placed and scaled by a small shader. Without instancing support the same vertex
+ * buffer is drawn once per visible pipe instead. Graphics thread only.
+ */
+class PipeRenderer : public cGenericObject {
+// Public functions
+public:
+	PipeRenderer();
+	virtual ~PipeRenderer();
+
+	void clear();
+	unsigned int addPipe(const cVector3d& a_base, double a_radius, double a_height, const cColorf& a_color);
+	void setPipes(const vector<PipeInstance>& a_pipes);
+	void setPipe(unsigned int a_index, const cVector3d& a_base, double a_radius, double a_height);
+	void setPipeEnabled(unsigned int a_index, bool a_enabled) { m_enabled[a_index] = a_enabled; }
+	unsigned int getPipeCount() const { return (unsigned int)m_pipes.size(); }
+
+	unsigned int getDrawnCount() const { return (unsigned int)m_visible.size(); } // pipes drawn in the last frame
+	bool isInstanced() const { return m_instanced; }
+
+	static PipeInstance makePipe(const cVector3d& a_base, double a_radius, double a_height, const cColorf& a_color);
+
+// Protected functions
+protected:
+	virtual void render(cRenderOptions& a_options);
+
+// Private functions
+private:
+	bool initGL();
+	void cull();
+	void drawInstanced();
+	void drawEach();
+
+// Private variables
+private:
+	vector<PipeInstance> m_pipes; // every pipe the node holds
+	vector<char> m_enabled; // if each pipe is drawn at all
+	vector<PipeInstance> m_visible; // enabled pipes inside the view frustum this frame
+
+	bool m_initialized; // GL objects have been created
+	bool m_instanced; // instanced arrays and shaders are supported
+	GLuint m_cylinderBuffer; // unit cylinder, position and normal per vertex
+	GLuint m_instanceBuffer; // visible pipes, one PipeInstance per instance
+	GLuint m_program; // places and lights the instances
+	GLsizei m_vertexCount; // vertices of the unit cylinder
+};
+
+#endif
@@ -0,0 +1,142 @@
+/**
+ * Filename: PipeTrack.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "PipeTrack.h"
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+PipeTrack::PipeTrack() {
+	m_pipeSettings = PipeSettings();
+	m_turbulenceSettings = TurbulenceSettings();
+	m_lookahead = 0.0;
+	clear();
+}
+
+
+PipeTrack::~PipeTrack() {}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To start a new track. The first pair is placed one pipe distance ahead of a_startX and pipes are
+ * kept generated up to a_lookahead ahead of the bird. The layout is drawn from a_random, so the same
+ * stream lays out the same track.
+ */
+void PipeTrack::reset(const PipeSettings& a_pipes, const TurbulenceSettings& a_turbulence, const LevelRandom& a_random, double a_startX, double a_lookahead) {
+	clear();
+	m_pipeSettings = a_pipes;
+	m_turbulenceSettings = a_turbulence;
+	m_random = a_random;
+	m_lookahead = a_lookahead;
+	m_lastPipeX = a_startX;
+	m_lastTurbulenceX = 0.0;
+	update(0.0);
+}
+
+
+/**
+ * To drop everything that was generated.
+ */
+void PipeTrack::clear() {
+	m_pipeHead = 0;
+	m_pipeTail = 0;
+	m_lastPipeX = 0.0;
+	m_turbulenceHead = 0;
+	m_turbulenceTail = 0;
+	m_lastTurbulenceX = 0.0;
+	m_model.reset(m_pipeSettings);
+}
+
+
+/**
+ * To drop the turbulence regions the bird has left behind and generate pipes and turbulence until
+ * the track reaches the lookahead distance past the bird or the rings are full. The bird flies
+ * towards negative x.
+ */
+void PipeTrack::update(double a_birdX) {
+	bool changed = false;
+
+	while ((m_turbulenceTail < m_turbulenceHead) && (m_turbulence[m_turbulenceTail & (TURBULENCE_TRACK_CAPACITY - 1)].end > a_birdX)) {
+		m_turbulenceTail++;
+		changed = true;
+	}
+
+	while ((getPipeCount() < PIPE_TRACK_CAPACITY) && (m_lastPipeX > a_birdX - m_lookahead)) {
+		PipePair pair = generatePipe(m_pipeSettings, m_lastPipeX, m_random);
+		m_pipes[m_pipeHead & (PIPE_TRACK_CAPACITY - 1)] = pair;
+		m_pipeHead++;
+		m_lastPipeX = pair.x;
+		changed = true;
+	}
+
+	const TurbulenceSettings &t = m_turbulenceSettings;
+	while ((m_turbulenceHead - m_turbulenceTail < TURBULENCE_TRACK_CAPACITY) && (m_lastTurbulenceX > a_birdX - m_lookahead)) {
+		// laid out the same way as the regions of a level that has an end
+		double begin = m_lastTurbulenceX - (((m_random.nextInt(100) + 1) / 100.0) * (t.maxDistance - t.minDistance) + t.minDistance);
+		double end = begin - ((m_random.nextInt(100) + 1) / 100.0) * (t.maxLength - t.minLength);
+
+		turbulence &region = m_turbulence[m_turbulenceHead & (TURBULENCE_TRACK_CAPACITY - 1)];
+		region.begin = begin;
+		region.end = end;
+		region.periodRange = t.period;
+		region.amplitudeRange = t.amplitude;
+		m_turbulenceWave[m_turbulenceHead & (TURBULENCE_TRACK_CAPACITY - 1)].bake(t.period, t.amplitude, m_random);
+		m_turbulenceHead++;
+		m_lastTurbulenceX = end;
+		changed = true;
+	}
+
+	if (changed) rebuildModel();
+}
+
+
+/**
+ * To drop the first pair, once the bird has flown past it.
+ */
+void PipeTrack::popPipe() {
+	if (m_pipeTail == m_pipeHead) return;
+	m_pipeTail++;
+	rebuildModel();
+}
+
+
+/**
+ * To copy the pairs and regions in the rings into the level model. The rings are small, so this
+ * costs the same however long the track has been running.
+ */
+void PipeTrack::rebuildModel() {
+	m_model.reset(m_pipeSettings);
+	for (unsigned long long i = m_pipeTail; i < m_pipeHead; i++) {
+		m_model.addPipe(getPipe(i));
+	}
+	for (unsigned long long i = m_turbulenceTail; i < m_turbulenceHead; i++) {
+		m_model.addTurbulence(m_turbulence[i & (TURBULENCE_TRACK_CAPACITY - 1)], m_turbulenceWave[i & (TURBULENCE_TRACK_CAPACITY - 1)]);
+	}
+	m_model.buildIndex();
+}
+
+
+/**
+ * To randomly generate the pair of pipes that follows the pair at a_previousX, drawn from a_random.
+ */
+PipePair PipeTrack::generatePipe(const PipeSettings& a_settings, double a_previousX, LevelRandom& a_random) {
+	PipePair pair;
+
+	double distance = ((a_random.nextInt(101) / 100.0) * (a_settings.maxDistance - a_settings.minDistance)) + a_settings.minDistance;
+	pair.x = a_previousX - distance;
+	pair.radius = a_settings.radius;
+
+	// calculate gap size to be used to determine placement
+	pair.gapSize = ((a_random.nextInt(101) / 100.0) * (a_settings.maxGap - a_settings.minGap)) + a_settings.minGap;
+
+	// get gap position and move into relation of floor and ceiling, ensure no pipe is of height 0
+	pair.gapCenter = (((a_random.nextInt(100) + 1) / 100.0) * (a_settings.ceiling - a_settings.floor - pair.gapSize)) + a_settings.floor + pair.gapSize / 2.0;
+
+	return pair;
+}
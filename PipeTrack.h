@@ -0,0 +1,78 @@
+/**
+ * Filename: PipeTrack.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef PIPETRACK_H
+#define PIPETRACK_H
+
+#include "LevelModel.h"
+#include "LevelRandom.h"
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+// number of pipe pairs the endless track can hold (power of two)
+constexpr unsigned int PIPE_TRACK_CAPACITY = 16;
+
+// number of turbulence regions the endless track can hold (power of two)
+constexpr unsigned int TURBULENCE_TRACK_CAPACITY = 4;
+
+/**
+ * Level without an end. Pipes and turbulence are generated a fixed distance ahead of the bird
+ * into fixed size rings and dropped once the bird has passed them, so memory and the work done per
+ * tick do not grow however long the bird survives. Every pair gets a sequence number, its slot in
+ * the ring is the sequence number modulo PIPE_TRACK_CAPACITY. What is in the rings is mirrored in a
+ * LevelModel, rebuilt whenever the rings change, so the game searches the track the same way as a
+ * level that has an end.
+ */
+class PipeTrack {
+// Public functions
+public:
+	PipeTrack();
+	~PipeTrack();
+
+	void reset(const PipeSettings& a_pipes, const TurbulenceSettings& a_turbulence, const LevelRandom& a_random, double a_startX, double a_lookahead);
+	void update(double a_birdX);
+	void clear();
+
+	unsigned int getPipeCount() const { return (unsigned int)(m_pipeHead - m_pipeTail); }
+	unsigned long long getFirstPipe() const { return m_pipeTail; }
+	const PipePair& getPipe(unsigned long long a_sequence) const { return m_pipes[a_sequence & (PIPE_TRACK_CAPACITY - 1)]; }
+	const PipePair* getPipeRing() const { return m_pipes; }
+	const PipeSettings& getPipeSettings() const { return m_pipeSettings; }
+	void popPipe();
+
+	const LevelModel& getModel() const { return m_model; }
+
+	static PipePair generatePipe(const PipeSettings& a_settings, double a_previousX, LevelRandom& a_random);
+
+// Private functions
+private:
+	void rebuildModel();
+
+// Private variables
+private:
+	PipeSettings m_pipeSettings; // layout of the pipes
+	TurbulenceSettings m_turbulenceSettings; // layout of the turbulence
+	double m_lookahead; // distance ahead of the bird that is kept generated
+	LevelRandom m_random; // draws the layout of the track
+
+	PipePair m_pipes[PIPE_TRACK_CAPACITY]; // pipes ahead of the bird
+	unsigned long long m_pipeHead; // sequence number of the next pair to generate
+	unsigned long long m_pipeTail; // sequence number of the first pair not yet passed
+	double m_lastPipeX; // position of the last generated pair
+
+	turbulence m_turbulence[TURBULENCE_TRACK_CAPACITY]; // turbulence regions ahead of the bird
+	TurbulenceWave m_turbulenceWave[TURBULENCE_TRACK_CAPACITY]; // rumble baked for each region
+	unsigned long long m_turbulenceHead; // next region to generate
+	unsigned long long m_turbulenceTail; // first region not yet passed
+	double m_lastTurbulenceX; // end of the last generated region
+
+	LevelModel m_model; // pairs and regions currently in the rings, first pair first
+};
+
+#endif
@@ -0,0 +1,155 @@
+/**
+ * Filename: ReplayDevice.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "ReplayDevice.h"
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+ReplayDevice::ReplayDevice(unsigned int a_deviceNumber, const InputLogFile* a_log, const HapticScheduler* a_scheduler) : cGenericHapticDevice(a_deviceNumber) {
+	m_log = a_log;
+	m_scheduler = a_scheduler;
+	m_next = 0;
+	m_current = NULL;
+	m_finished = false;
+
+	// report the same capabilities as a Falcon
+	m_specifications.m_model = C_HAPTIC_DEVICE_VIRTUAL;
+	m_specifications.m_manufacturerName = "Flappy Bird 3D";
+	m_specifications.m_modelName = "replayed falcon";
+	m_specifications.m_maxLinearForce = 8.0; // [N]
+	m_specifications.m_maxLinearStiffness = 3000.0; // [N/m]
+	m_specifications.m_maxLinearDamping = 20.0; // [N/(m/s)]
+	m_specifications.m_workspaceRadius = 0.04; // [m]
+	m_specifications.m_sensedPosition = true;
+	m_specifications.m_actuatedPosition = true;
+	m_specifications.m_rightHand = true;
+	m_specifications.m_leftHand = true;
+
+	m_deviceAvailable = (m_log != NULL) && m_log->isOpen();
+	m_deviceReady = false;
+}
+
+
+ReplayDevice::~ReplayDevice() {}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+bool ReplayDevice::open() {
+	m_deviceReady = m_deviceAvailable;
+	m_next = 0;
+	m_current = NULL;
+	m_finished = false;
+	return m_deviceReady ? C_SUCCESS : C_ERROR;
+}
+
+
+bool ReplayDevice::close() {
+	m_deviceReady = false;
+	return C_SUCCESS;
+}
+
+
+bool ReplayDevice::calibrate(bool /*a_forceCalibration*/) {
+	return m_deviceReady;
+}
+
+
+bool ReplayDevice::getPosition(cVector3d& a_position) {
+	const InputLogRecord* r = seek();
+	if (r == NULL) a_position.zero();
+	else a_position.set(r->position[0], r->position[1], r->position[2]);
+	markPositionSensed();
+	return m_deviceReady;
+}
+
+
+bool ReplayDevice::getLinearVelocity(cVector3d& a_linearVelocity) {
+	const InputLogRecord* r = seek();
+	if (r == NULL) a_linearVelocity.zero();
+	else a_linearVelocity.set(r->velocity[0], r->velocity[1], r->velocity[2]);
+	m_linearVelocity = a_linearVelocity;
+	return m_deviceReady;
+}
+
+
+bool ReplayDevice::getRotation(cMatrix3d& a_rotation) {
+	const InputLogRecord* r = seek();
+	if (r == NULL) a_rotation.identity();
+	else a_rotation.set(r->rotation[0], r->rotation[1], r->rotation[2],
+						r->rotation[3], r->rotation[4], r->rotation[5],
+						r->rotation[6], r->rotation[7], r->rotation[8]);
+	return m_deviceReady;
+}
+
+
+bool ReplayDevice::getUserSwitches(unsigned int& a_userSwitches) {
+	const InputLogRecord* r = seek();
+	a_userSwitches = (r == NULL) ? 0 : r->switches;
+	return m_deviceReady;
+}
+
+
+/**
+ * To get everything recorded for the current tick with a single lookup.
+ */
+bool ReplayDevice::getState(cHapticDeviceState& a_state) {
+	const InputLogRecord* r = seek();
+	if (r == NULL) {
+		a_state.m_position.zero();
+		a_state.m_rotation.identity();
+		a_state.m_linearVelocity.zero();
+		a_state.m_userSwitches = 0;
+	}
+	else {
+		a_state.m_position.set(r->position[0], r->position[1], r->position[2]);
+		a_state.m_rotation.set(r->rotation[0], r->rotation[1], r->rotation[2],
+							   r->rotation[3], r->rotation[4], r->rotation[5],
+							   r->rotation[6], r->rotation[7], r->rotation[8]);
+		a_state.m_linearVelocity.set(r->velocity[0], r->velocity[1], r->velocity[2]);
+		a_state.m_userSwitches = r->switches;
+	}
+	m_linearVelocity = a_state.m_linearVelocity;
+	a_state.m_angularVelocity.zero();
+	a_state.m_gripperAngle = 0.0;
+	a_state.m_gripperAngularVelocity = 0.0;
+	markPositionSensed();
+	return m_deviceReady;
+}
+
+
+/**
+ * Forces are accepted and remembered but do not change what is played back.
+ */
+bool ReplayDevice::setForceAndTorqueAndGripperForce(const cVector3d& a_force, const cVector3d& a_torque, double a_gripperForce) {
+	m_prevForce = a_force;
+	m_prevTorque = a_torque;
+	m_prevGripperForce = a_gripperForce;
+	markForceCommitted();
+	return m_deviceReady;
+}
+
+
+/**
+ * To move forward through the log to the newest record of this device that is not later than the
+ * current tick. Records are in tick order so this only ever walks forward.
+ */
+const InputLogRecord* ReplayDevice::seek() {
+	if (!m_deviceReady) return m_current;
+
+	unsigned long long tick = m_scheduler->getTickCount();
+	size_t count = m_log->getRecordCount();
+	while ((m_next < count) && (m_log->getRecord(m_next).tick <= tick)) {
+		const InputLogRecord &r = m_log->getRecord(m_next);
+		if (r.device == (uint32_t)m_deviceNumber) m_current = &r;
+		m_next++;
+	}
+
+	if (m_next >= count) m_finished = true;
+	return m_current;
+}
@@ -0,0 +1,61 @@
+/**
+ * Filename: ReplayDevice.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef REPLAYDEVICE_H
+#define REPLAYDEVICE_H
+
+#include "HapticScheduler.h"
+#include "InputLog.h"
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+class ReplayDevice;
+typedef std::shared_ptr<ReplayDevice> ReplayDevicePtr;
+
+/**
+ * Plays back the input one device produced in a recorded session. The record handed out is the
+ * one logged on the current tick of the haptic scheduler, so a replay started from the same state
+ * reproduces the session exactly. After the end of the log the last record is held.
+ */
+class ReplayDevice : public cGenericHapticDevice {
+// Public functions
+public:
+	ReplayDevice(unsigned int a_deviceNumber, const InputLogFile* a_log, const HapticScheduler* a_scheduler);
+	virtual ~ReplayDevice();
+
+	static ReplayDevicePtr create(unsigned int a_deviceNumber, const InputLogFile* a_log, const HapticScheduler* a_scheduler) { return (std::make_shared<ReplayDevice>(a_deviceNumber, a_log, a_scheduler)); }
+
+	virtual bool open();
+	virtual bool close();
+	virtual bool calibrate(bool a_forceCalibration = false);
+
+	virtual bool getPosition(cVector3d& a_position);
+	virtual bool getLinearVelocity(cVector3d& a_linearVelocity);
+	virtual bool getRotation(cMatrix3d& a_rotation);
+	virtual bool getUserSwitches(unsigned int& a_userSwitches);
+	virtual bool getState(cHapticDeviceState& a_state);
+	virtual bool setForceAndTorqueAndGripperForce(const cVector3d& a_force, const cVector3d& a_torque, double a_gripperForce);
+
+	bool isFinished() const { return m_finished; } // true once the last record of this device was played
+
+// Private functions
+private:
+	const InputLogRecord* seek(); // record for the current tick
+
+// Private variables
+private:
+	const InputLogFile* m_log; // log being played back
+	const HapticScheduler* m_scheduler; // source of the current tick
+
+	size_t m_next; // next record in the log that has not been played
+	const InputLogRecord* m_current; // record being played
+	bool m_finished; // if the log has run out for this device
+};
+
+#endif
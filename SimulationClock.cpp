@@ -0,0 +1,56 @@
+/**
+ * Filename: SimulationClock.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "SimulationClock.h"
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+SimulationClock::SimulationClock() {
+	m_time = 0.0;
+	m_on = false;
+}
+
+
+SimulationClock::~SimulationClock() {}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To reset the clock to a given time. The clock keeps its on/off state.
+ */
+void SimulationClock::reset(const double a_currentTime) {
+	m_time = a_currentTime;
+}
+
+
+/**
+ * To start the clock, optionally resetting it first. Returns the current time.
+ */
+double SimulationClock::start(bool a_resetClock) {
+	if (a_resetClock) reset();
+	m_on = true;
+	return m_time;
+}
+
+
+/**
+ * To stop the clock. Returns the time accumulated so far.
+ */
+double SimulationClock::stop() {
+	m_on = false;
+	return m_time;
+}
+
+
+/**
+ * To advance the clock by one fixed step. Does nothing while the clock is stopped.
+ */
+void SimulationClock::advance(double a_dt) {
+	if (m_on) m_time += a_dt;
+}
@@ -0,0 +1,41 @@
+/**
+ * Filename: SimulationClock.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef SIMULATIONCLOCK_H
+#define SIMULATIONCLOCK_H
+
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+/**
+ * Game clock that advances in fixed virtual steps instead of reading the wall clock. It has the
+ * same start/stop/reset behaviour as cPrecisionClock so the game logic can use it the same way,
+ * but time only moves when the haptic loop calls advance() once per tick.
+ */
+class SimulationClock {
+// Public functions
+public:
+	SimulationClock();
+	~SimulationClock();
+
+	void reset(const double a_currentTime = 0.0);
+	double start(bool a_resetClock = false);
+	double stop();
+	bool on() const { return m_on; }
+
+	void advance(double a_dt); // move time forward by one step if the clock is running
+	double getCurrentTimeSeconds() const { return m_time; }
+
+// Private variables
+private:
+	double m_time; // accumulated virtual time in seconds
+	bool m_on; // if the clock is currently running
+};
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * Filename: SimulationSnapshot.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "SimulationSnapshot.h"
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+SnapshotBuffer::SnapshotBuffer() {
+	for (int i = 0; i < 3; i++) {
+		SimulationSnapshot &s = m_slots[i].data;
+		s.tick = 0;
+		s.publishTime = 0;
+		s.period = 0.001;
+		s.birdPos = cVector3d(0, 0, 0);
+		s.previousBirdPos = cVector3d(0, 0, 0);
+		s.rightWingAngle = 0.0;
+		s.leftWingAngle = 0.0;
+		s.cameraEye = cVector3d(0.5, 0.0, 0.0);
+		s.cameraTarget = cVector3d(0.0, 0.0, 0.0);
+		s.cameraUp = cVector3d(0.0, 0.0, 1.0);
+		s.previousCameraEye = s.cameraEye;
+		s.previousCameraTarget = s.cameraTarget;
+		for (int j = 0; j < SNAPSHOT_MAX_CURSORS; j++) {
+			s.cursorPos[j] = cVector3d(0, 0, 0);
+			s.cursorRot[j].identity();
+		}
+		s.levelId = 0;
+		s.firstActivePipe = 0;
+		for (unsigned int j = 0; j < PIPE_TRACK_CAPACITY; j++) {
+			s.trackPipes[j].x = 0.0;
+			s.trackPipes[j].gapCenter = 0.0;
+			s.trackPipes[j].gapSize = 0.0;
+			s.trackPipes[j].radius = 0.0;
+		}
+		s.trackSettings = PipeSettings();
+		s.trackFirstPipe = 0;
+		s.trackPipeCount = 0;
+	}
+
+	m_writeIndex = 0;
+	m_middle.store(1);
+	m_readIndex = 2;
+}
+
+
+SnapshotBuffer::~SnapshotBuffer() {}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To publish a new snapshot. Copies into the writers private slot and then swaps it with the
+ * middle slot, flagging it as fresh for the reader.
+ */
+void SnapshotBuffer::publish(const SimulationSnapshot& a_snapshot) {
+	m_slots[m_writeIndex].data = a_snapshot;
+	unsigned int previous = m_middle.exchange(m_writeIndex | FRESH_BIT, memory_order_acq_rel);
+	m_writeIndex = previous & INDEX_MASK;
+}
+
+
+/**
+ * To get the newest published snapshot. Returns false if nothing new has been published since the
+ * last call, in which case the previous snapshot is returned again.
+ */
+bool SnapshotBuffer::consume(SimulationSnapshot& a_snapshot) {
+	bool fresh = (m_middle.load(memory_order_relaxed) & FRESH_BIT) != 0;
+	if (fresh) {
+		unsigned int previous = m_middle.exchange(m_readIndex, memory_order_acq_rel);
+		m_readIndex = previous & INDEX_MASK;
+	}
+	a_snapshot = m_slots[m_readIndex].data;
+	return fresh;
+}
@@ -0,0 +1,83 @@
+/**
+ * Filename: SimulationSnapshot.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef SIMULATIONSNAPSHOT_H
+#define SIMULATIONSNAPSHOT_H
+
+#include "PipeTrack.h"
+#include "chai3d.h"
+#include <atomic>
+
+using namespace chai3d;
+using namespace std;
+
+// maximum number of device cursors carried by a snapshot
+constexpr int SNAPSHOT_MAX_CURSORS = 4;
+
+// state the graphics thread needs to draw one frame of the game
+typedef struct SimulationSnapshot {
+	unsigned long long tick; // haptic tick the snapshot was published on
+	long long publishTime; // when the snapshot was published, on the clock of the haptic scheduler [ns]
+	double period; // time step of the haptic loop [s]
+
+	cVector3d birdPos; // position of the bird body
+	cVector3d previousBirdPos; // position of the bird body in the snapshot before
+	double rightWingAngle; // rotation of the right wing about the x axis
+	double leftWingAngle; // rotation of the left wing about the x axis
+
+	cVector3d cameraEye; // camera position
+	cVector3d cameraTarget; // camera look at position
+	cVector3d cameraUp; // camera up vector
+	cVector3d previousCameraEye; // camera position in the snapshot before
+	cVector3d previousCameraTarget; // camera look at position in the snapshot before
+
+	cVector3d cursorPos[SNAPSHOT_MAX_CURSORS]; // positions of the device cursors
+	cMatrix3d cursorRot[SNAPSHOT_MAX_CURSORS]; // orientations of the device cursors
+
+	unsigned int levelId; // changes every time a level is (re)started
+	unsigned int firstActivePipe; // index of the first pipe in the current level that has not been passed
+
+	PipePair trackPipes[PIPE_TRACK_CAPACITY]; // ring of pipe pairs of the endless track
+	PipeSettings trackSettings; // layout the pipes of the endless track were generated with
+	unsigned long long trackFirstPipe; // sequence number of the first pair of the endless track that is shown
+	unsigned int trackPipeCount; // number of pairs of the endless track that are shown
+} SimulationSnapshot;
+
+
+/**
+ * Triple buffer for handing snapshots from the haptics thread (single writer) to the
+ * graphics thread (single reader). Neither side ever waits on the other: the writer
+ * always has a free slot to publish into and the reader always gets the newest
+ * complete snapshot.
+ */
+class SnapshotBuffer {
+// Public functions
+public:
+	SnapshotBuffer();
+	~SnapshotBuffer();
+
+	void publish(const SimulationSnapshot& a_snapshot); // haptics thread only
+	bool consume(SimulationSnapshot& a_snapshot); // graphics thread only
+
+// Private variables
+private:
+	static constexpr unsigned int INDEX_MASK = 0x3;
+	static constexpr unsigned int FRESH_BIT = 0x4;
+
+	// each slot on its own cache line so the two threads never write the same line
+	struct alignas(64) Slot {
+		SimulationSnapshot data;
+	};
+
+	Slot m_slots[3];
+
+	alignas(64) unsigned int m_writeIndex; // slot owned by the writer
+	alignas(64) unsigned int m_readIndex; // slot owned by the reader
+	alignas(64) atomic<unsigned int> m_middle; // slot being exchanged, plus the fresh bit
+};
+
+#endif
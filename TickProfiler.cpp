@@ -0,0 +1,261 @@
+/**
+ * Filename: TickProfiler.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "TickProfiler.h"
+#include "chai3d.h"
+#include <chrono>
+#include <cstdio>
+
+using namespace chai3d;
+using namespace std;
+
+// names of the phases in the report and the trace
+static const char* PROFILE_PHASE_NAMES[PROFILE_PHASE_COUNT] = {
+	"device read",
+	"buttons",
+	"wing forces",
+	"turbulence",
+	"integration",
+	"wing rotation",
+	"collision",
+	"camera",
+	"force write"
+};
+
+// profiler and ring of the current thread, assigned on its first event
+static thread_local TickProfiler* t_profiler = NULL;
+static thread_local int t_ring = -1;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+TickProfiler::TickProfiler() {
+	for (unsigned int i = 0; i < PROFILE_MAX_THREADS; i++) {
+		m_rings[i] = new Ring();
+		m_rings[i]->head.store(0);
+		m_rings[i]->tail.store(0);
+	}
+	m_ringCount.store(0);
+	m_dropped.store(0);
+	m_enabled.store(false);
+	m_origin = 0;
+	m_origin = now();
+
+	m_aggregatorThread = NULL;
+	m_running.store(false);
+	m_finished.store(true);
+
+	m_traceCount = 0;
+}
+
+
+TickProfiler::~TickProfiler() {
+	stop();
+	for (unsigned int i = 0; i < PROFILE_MAX_THREADS; i++) delete m_rings[i];
+}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To start recording events and start the aggregator thread.
+ */
+void TickProfiler::start() {
+	if (m_running.load()) return;
+
+	m_mutex.acquire();
+	m_trace.resize(PROFILE_TRACE_CAPACITY);
+	m_mutex.release();
+
+	m_running.store(true);
+	m_finished.store(false);
+	m_aggregatorThread = new cThread();
+	m_aggregatorThread->start(aggregatorLoop, CTHREAD_PRIORITY_GRAPHICS, this);
+	m_enabled.store(true);
+}
+
+
+/**
+ * To stop recording events, stop the aggregator thread and aggregate whatever is left in the rings.
+ */
+void TickProfiler::stop() {
+	if (!m_running.load()) return;
+
+	m_enabled.store(false);
+	m_running.store(false);
+	while (!m_finished.load()) { cSleepMs(1); }
+	delete m_aggregatorThread;
+	m_aggregatorThread = NULL;
+
+	while (drain() > 0) {}
+}
+
+
+/**
+ * To read the clock events are timed with, in nanoseconds since the profiler was created.
+ */
+long long TickProfiler::now() const {
+	return (long long)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count() - m_origin;
+}
+
+
+/**
+ * To queue one run of a phase in the ring of the calling thread. Never blocks: if the ring is full
+ * or every ring is taken the event is dropped.
+ */
+void TickProfiler::record(ProfilePhase a_phase, long long a_start, long long a_end) {
+	int index = getThreadRing();
+	if (index < 0) {
+		m_dropped.fetch_add(1, memory_order_relaxed);
+		return;
+	}
+
+	Ring* ring = m_rings[index];
+	size_t head = ring->head.load(memory_order_relaxed);
+	if (head - ring->tail.load(memory_order_acquire) >= PROFILE_RING_CAPACITY) {
+		m_dropped.fetch_add(1, memory_order_relaxed);
+		return;
+	}
+
+	ProfileEvent &e = ring->events[head & (PROFILE_RING_CAPACITY - 1)];
+	e.start = a_start;
+	e.end = a_end;
+	e.phase = a_phase;
+	e.thread = (unsigned int)index;
+
+	ring->head.store(head + 1, memory_order_release);
+}
+
+
+/**
+ * To get the ring of the calling thread, handing it one on its first event. Returns -1 once every
+ * ring is taken.
+ */
+int TickProfiler::getThreadRing() {
+	if (t_profiler != this) {
+		t_profiler = this;
+		unsigned int index = m_ringCount.fetch_add(1);
+		t_ring = (index < PROFILE_MAX_THREADS) ? (int)index : -1;
+	}
+	return t_ring;
+}
+
+
+/**
+ * To move the events in the rings into the histograms and the trace. Returns how many were moved.
+ */
+size_t TickProfiler::drain() {
+	size_t moved = 0;
+	unsigned int rings = cMin(m_ringCount.load(), PROFILE_MAX_THREADS);
+
+	m_mutex.acquire();
+	for (unsigned int i = 0; i < rings; i++) {
+		Ring* ring = m_rings[i];
+		size_t tail = ring->tail.load(memory_order_relaxed);
+		size_t head = ring->head.load(memory_order_acquire);
+
+		for (; tail != head; tail++) {
+			const ProfileEvent &e = ring->events[tail & (PROFILE_RING_CAPACITY - 1)];
+			long long duration = e.end - e.start;
+			m_histogram[e.phase].recordNs((duration > 0) ? (unsigned long long)duration : 0);
+
+			if (!m_trace.empty()) m_trace[m_traceCount & (PROFILE_TRACE_CAPACITY - 1)] = e;
+			m_traceCount++;
+			moved++;
+		}
+
+		ring->tail.store(tail, memory_order_release);
+	}
+	m_mutex.release();
+
+	return moved;
+}
+
+
+/**
+ * Body of the aggregator thread. Drains the rings until the profiler is stopped.
+ */
+void TickProfiler::aggregatorLoop(void* a_profiler) {
+	TickProfiler* profiler = (TickProfiler*)a_profiler;
+
+	while (profiler->m_running.load()) {
+		if (profiler->drain() == 0) cSleepMs(1);
+	}
+
+	profiler->m_finished.store(true);
+}
+
+
+/**
+ * To get the durations of a phase aggregated so far. The percentiles are accurate to the width of
+ * a histogram bucket, about 3 percent.
+ */
+ProfileStats TickProfiler::getStats(ProfilePhase a_phase) {
+	ProfileStats stats = { 0, 0.0, 0.0, 0.0, 0.0 };
+
+	m_mutex.acquire();
+	const cLatencyHistogram& histogram = m_histogram[a_phase];
+	stats.count = histogram.getCount();
+	if (stats.count > 0) {
+		stats.min = histogram.getMinSeconds() * 1e6;
+		stats.p50 = histogram.getPercentileSeconds(50.0) * 1e6;
+		stats.p99 = histogram.getPercentileSeconds(99.0) * 1e6;
+		stats.max = histogram.getMaxSeconds() * 1e6;
+	}
+	m_mutex.release();
+
+	return stats;
+}
+
+
+/**
+ * To print a table of the durations of every phase.
+ */
+void TickProfiler::printReport(ostream& a_stream) {
+	char line[128];
+
+	a_stream << "haptic tick profile (microseconds):" << endl;
+	snprintf(line, sizeof(line), "  %-14s %10s %9s %9s %9s %9s", "phase", "count", "min", "p50", "p99", "max");
+	a_stream << line << endl;
+
+	for (unsigned int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+		ProfileStats s = getStats((ProfilePhase)p);
+		if (s.count == 0) continue;
+		snprintf(line, sizeof(line), "  %-14s %10llu %9.2f %9.2f %9.2f %9.2f", getPhaseName((ProfilePhase)p), s.count, s.min, s.p50, s.p99, s.max);
+		a_stream << line << endl;
+	}
+
+	if (getDroppedCount() > 0) a_stream << "  " << getDroppedCount() << " events dropped" << endl;
+}
+
+
+/**
+ * To write the latest events as a Chrome trace event file.
+ */
+bool TickProfiler::writeTrace(const string& a_filename) {
+	FILE* file = fopen(a_filename.c_str(), "w");
+	if (file == NULL) return false;
+
+	m_mutex.acquire();
+	unsigned long long count = cMin(m_traceCount, (unsigned long long)m_trace.size());
+	unsigned long long first = m_traceCount - count;
+
+	fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	for (unsigned long long i = first; i < m_traceCount; i++) {
+		const ProfileEvent &e = m_trace[i & (PROFILE_TRACE_CAPACITY - 1)];
+		fprintf(file, "{\"name\":\"%s\",\"cat\":\"haptics\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+				PROFILE_PHASE_NAMES[e.phase], e.thread, e.start / 1000.0, (e.end - e.start) / 1000.0, (i + 1 < m_traceCount) ? "," : "");
+	}
+	fprintf(file, "]}\n");
+	m_mutex.release();
+
+	return fclose(file) == 0;
+}
+
+
+/**
+ * To get the name of a phase.
+ */
+const char* TickProfiler::getPhaseName(ProfilePhase a_phase) {
+	return PROFILE_PHASE_NAMES[a_phase];
+}
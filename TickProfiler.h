@@ -0,0 +1,152 @@
+/**
+ * Filename: TickProfiler.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef TICKPROFILER_H
+#define TICKPROFILER_H
+
+#include "AlignedAlloc.h"
+#include "chai3d.h"
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace chai3d;
+using namespace std;
+
+// number of events a thread can queue before the aggregator has to catch up (power of two)
+constexpr size_t PROFILE_RING_CAPACITY = 1 << 15;
+
+// number of threads that can record events
+constexpr unsigned int PROFILE_MAX_THREADS = 4;
+
+// number of the latest events kept for the trace (power of two)
+constexpr size_t PROFILE_TRACE_CAPACITY = 1 << 18;
+
+// phases of the haptic tick
+enum ProfilePhase {
+	PROFILE_DEVICE_READ,
+	PROFILE_BUTTONS,
+	PROFILE_FORCES,
+	PROFILE_TURBULENCE,
+	PROFILE_INTEGRATION,
+	PROFILE_WING_ROTATION,
+	PROFILE_COLLISION,
+	PROFILE_CAMERA,
+	PROFILE_FORCE_WRITE,
+	PROFILE_PHASE_COUNT
+};
+
+// one run of a phase, timestamps in nanoseconds since the profiler was started
+typedef struct ProfileEvent {
+	long long start;
+	long long end;
+	unsigned int phase;
+	unsigned int thread; // ring of the thread that recorded the event
+} ProfileEvent;
+
+// durations of a phase in microseconds
+typedef struct ProfileStats {
+	unsigned long long count;
+	double min;
+	double p50;
+	double p99;
+	double max;
+} ProfileStats;
+
+/**
+ * Profiler of the phases of the haptic tick. Phases are timed with ProfileScope, which costs two
+ * clock reads and a copy into a lock-free ring of the thread. A background thread drains the rings
+ * into a cLatencyHistogram of durations per phase, from which min/p50/p99/max are read, and keeps the latest
+ * events to write them out as a Chrome trace (chrome://tracing or ui.perfetto.dev). Nothing is
+ * recorded until start() is called. If a ring is full, events are dropped and counted instead of
+ * stalling the thread that records them.
+ */
+class TickProfiler {
+// Public functions
+public:
+	TickProfiler();
+	~TickProfiler();
+
+	void start();
+	void stop();
+	bool isEnabled() const { return m_enabled.load(memory_order_relaxed); }
+
+	long long now() const;
+	void record(ProfilePhase a_phase, long long a_start, long long a_end);
+
+	ProfileStats getStats(ProfilePhase a_phase);
+	unsigned long long getDroppedCount() const { return m_dropped.load(memory_order_relaxed); }
+	void printReport(ostream& a_stream);
+	bool writeTrace(const string& a_filename);
+
+	static const char* getPhaseName(ProfilePhase a_phase);
+
+// Private types
+private:
+	struct Ring {
+		ProfileEvent events[PROFILE_RING_CAPACITY]; // events waiting to be aggregated
+		alignas(64) atomic<size_t> head; // next slot the recording thread writes
+		alignas(64) atomic<size_t> tail; // next slot the aggregator reads
+
+		// the counters are kept on their own cache lines, which plain new does not guarantee
+		static void* operator new(size_t a_size) { return alignedAlloc(a_size); }
+		static void operator delete(void* a_pointer) { alignedFree(a_pointer); }
+	};
+
+// Private functions
+private:
+	static void aggregatorLoop(void* a_profiler);
+	size_t drain(); // aggregator only, or once it has stopped
+	int getThreadRing();
+
+// Private variables
+private:
+	Ring* m_rings[PROFILE_MAX_THREADS]; // one per recording thread
+	atomic<unsigned int> m_ringCount; // rings handed out to threads
+	atomic<unsigned long long> m_dropped; // events lost because a ring was full
+	atomic<bool> m_enabled; // if events are recorded
+	long long m_origin; // clock reading events are measured from
+
+	cThread* m_aggregatorThread; // thread draining the rings
+	atomic<bool> m_running; // cleared to stop the aggregator
+	atomic<bool> m_finished; // set by the aggregator once it has exited
+
+	cMutex m_mutex; // guards everything below
+	cLatencyHistogram m_histogram[PROFILE_PHASE_COUNT]; // duration histogram of each phase
+	vector<ProfileEvent> m_trace; // latest events, oldest overwritten first
+	unsigned long long m_traceCount; // events ever added to the trace
+};
+
+/**
+ * Times one phase from its construction until end() is called or it goes out of scope.
+ */
+class ProfileScope {
+// Public functions
+public:
+	ProfileScope(TickProfiler& a_profiler, ProfilePhase a_phase) : m_profiler(a_profiler), m_phase(a_phase) {
+		m_start = m_profiler.isEnabled() ? m_profiler.now() : -1;
+	}
+	~ProfileScope() { end(); }
+
+	/**
+	 * To stop timing the phase. Does nothing if it was already stopped.
+	 */
+	void end() {
+		if (m_start < 0) return;
+		m_profiler.record(m_phase, m_start, m_profiler.now());
+		m_start = -1;
+	}
+
+// Private variables
+private:
+	TickProfiler& m_profiler; // profiler the phase is recorded to
+	ProfilePhase m_phase; // phase being timed
+	long long m_start; // start of the phase, negative once recorded or if the profiler is off
+};
+
+#endif
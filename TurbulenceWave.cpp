@@ -0,0 +1,59 @@
+/**
+ * Filename: TurbulenceWave.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "TurbulenceWave.h"
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+TurbulenceWave::TurbulenceWave() {
+	for (unsigned int i = 0; i <= TURBULENCE_TABLE_SIZE; i++) m_samples[i] = 0.0f;
+	m_amplitude = 0.0;
+}
+
+
+TurbulenceWave::~TurbulenceWave() {}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To draw the rumble of a region and fill the table with it. Periods are drawn from 1 to
+ * a_periodRange and the peak from 1 to a_amplitudeRange, the ranges the rumble was drawn from every
+ * tick before it was baked. A period p gives sin(p * PI * t), as before.
+ */
+void TurbulenceWave::bake(unsigned int a_periodRange, unsigned int a_amplitudeRange, LevelRandom& a_random) {
+	double period[TURBULENCE_PARTIALS];
+	double phase[TURBULENCE_PARTIALS];
+	double weight[TURBULENCE_PARTIALS];
+
+	m_amplitude = (a_random.nextInt(cMax(a_amplitudeRange, 1u)) + 1);
+	for (unsigned int k = 0; k < TURBULENCE_PARTIALS; k++) {
+		period[k] = (a_random.nextInt(cMax(a_periodRange, 1u)) + 1);
+		phase[k] = (a_random.nextInt(1000) / 1000.0) * 2.0 * M_PI;
+		weight[k] = (a_random.nextInt(100) + 1) / 100.0;
+	}
+
+	// mix the sine waves
+	double peak = 0.0;
+	for (unsigned int i = 0; i < TURBULENCE_TABLE_SIZE; i++) {
+		double t = i * (TURBULENCE_TABLE_DURATION / TURBULENCE_TABLE_SIZE);
+		double value = 0.0;
+		for (unsigned int k = 0; k < TURBULENCE_PARTIALS; k++) {
+			value += weight[k] * sin(period[k] * M_PI * t + phase[k]);
+		}
+		m_samples[i] = (float)value;
+		peak = cMax(peak, fabs(value));
+	}
+
+	// scale the peak to the amplitude
+	double scale = (peak > 0.0) ? m_amplitude / peak : 0.0;
+	for (unsigned int i = 0; i < TURBULENCE_TABLE_SIZE; i++) {
+		m_samples[i] = (float)(m_samples[i] * scale);
+	}
+	m_samples[TURBULENCE_TABLE_SIZE] = m_samples[0];
+}
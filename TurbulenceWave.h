@@ -0,0 +1,60 @@
+/**
+ * Filename: TurbulenceWave.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef TURBULENCEWAVE_H
+#define TURBULENCEWAVE_H
+
+#include "LevelRandom.h"
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+// number of samples of a waveform table (power of two)
+constexpr unsigned int TURBULENCE_TABLE_SIZE = 1024;
+
+// seconds covered by a waveform table before it repeats
+constexpr double TURBULENCE_TABLE_DURATION = 2.0;
+
+// number of sine waves mixed into the rumble of a region
+constexpr unsigned int TURBULENCE_PARTIALS = 4;
+
+/**
+ * Rumble of a turbulence region, baked into a table when the level is generated. The rumble is a
+ * mix of a few sine waves with random periods, phases and weights, scaled so its peak is the
+ * amplitude drawn for the region. Every period is a whole number of cycles over the length of the
+ * table, so the table repeats without a seam and holds nothing above the highest period of the
+ * region. At haptic rate the rumble is a linear interpolation between two samples of the table.
+ */
+class TurbulenceWave {
+// Public functions
+public:
+	TurbulenceWave();
+	~TurbulenceWave();
+
+	void bake(unsigned int a_periodRange, unsigned int a_amplitudeRange, LevelRandom& a_random);
+
+	/**
+	 * To get the rumble at a_time seconds.
+	 */
+	double sample(double a_time) const {
+		double position = a_time * (TURBULENCE_TABLE_SIZE / TURBULENCE_TABLE_DURATION);
+		double index = floor(position);
+		unsigned int i = (unsigned int)((long long)index & (TURBULENCE_TABLE_SIZE - 1));
+		double fraction = position - index;
+		return m_samples[i] + fraction * (m_samples[i + 1] - m_samples[i]);
+	}
+
+	double getAmplitude() const { return m_amplitude; }
+
+// Private variables
+private:
+	float m_samples[TURBULENCE_TABLE_SIZE + 1]; // one period of the rumble, the first sample repeated at the end
+	double m_amplitude; // peak of the rumble
+};
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * Filename: UiEvents.cpp
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#include "UiEvents.h"
+#include "chai3d.h"
+
+using namespace chai3d;
+using namespace std;
+
+/////////////////////////////////////////// CONSTRUCTORS ///////////////////////////////////////////////////
+UiEventQueue::UiEventQueue() {
+	for (size_t i = 0; i < UI_QUEUE_CAPACITY; i++) m_slots[i].sequence.store(i);
+	m_head.store(0);
+	m_tail = 0;
+	m_dropped.store(0);
+}
+
+
+UiEventQueue::~UiEventQueue() {}
+
+////////////////////////////////////////////// FUNCTIONS ///////////////////////////////////////////////////
+
+/**
+ * To post an event to the graphics thread. Returns false, and counts the event as dropped, if the
+ * queue is full. Never blocks, so it is safe to call from the haptics thread.
+ */
+bool UiEventQueue::post(UiEventType a_type, unsigned int a_value, unsigned int a_levelId) {
+	size_t head = m_head.load(memory_order_relaxed);
+	Slot* slot;
+	while (true) {
+		slot = &m_slots[head & (UI_QUEUE_CAPACITY - 1)];
+		size_t sequence = slot->sequence.load(memory_order_acquire);
+		if (sequence == head) {
+			// the slot is free, claim it unless another producer got there first
+			if (m_head.compare_exchange_weak(head, head + 1, memory_order_relaxed)) break;
+		}
+		else if (sequence < head) {
+			// the consumer has not freed the slot yet, the queue is full
+			m_dropped.fetch_add(1, memory_order_relaxed);
+			return false;
+		}
+		else {
+			// another producer claimed the slot, try the next one
+			head = m_head.load(memory_order_relaxed);
+		}
+	}
+
+	slot->event.type = a_type;
+	slot->event.value = a_value;
+	slot->event.levelId = a_levelId;
+	slot->sequence.store(head + 1, memory_order_release);
+	return true;
+}
+
+
+/**
+ * To take the oldest event in the queue. Returns false if there is none, or if the oldest one is
+ * still being written by its producer.
+ */
+bool UiEventQueue::pop(UiEvent& a_event) {
+	Slot& slot = m_slots[m_tail & (UI_QUEUE_CAPACITY - 1)];
+	if (slot.sequence.load(memory_order_acquire) != m_tail + 1) return false;
+
+	a_event = slot.event;
+	slot.sequence.store(m_tail + UI_QUEUE_CAPACITY, memory_order_release);
+	m_tail++;
+	return true;
+}
@@ -0,0 +1,71 @@
+/**
+ * Filename: UiEvents.h
+ *
+ * Authors: Brandon Seiu, Glenn Skelton
+ */
+
+#pragma once
+#ifndef UIEVENTS_H
+#define UIEVENTS_H
+
+#include "chai3d.h"
+#include <atomic>
+
+using namespace chai3d;
+using namespace std;
+
+// number of events the UI queue can hold (power of two)
+constexpr size_t UI_QUEUE_CAPACITY = 64;
+
+// screens of the game, each shows its own widgets
+enum UiScreen { UI_NONE, UI_TITLE, UI_LEVEL_SELECT, UI_PLAY, UI_PAUSE, UI_LOSE, UI_WIN };
+
+// what changed in the game
+enum UiEventType {
+	UI_SCREEN, // value is the UiScreen now shown
+	UI_SELECTION, // value is the highlighted row of the menu on screen
+	UI_SCORE, // value is the score
+	UI_LEVEL_START, // value is the difficulty, levelId the level that started
+	UI_LEVEL_END // the level was cleaned up
+};
+
+// one change posted to the graphics thread
+typedef struct UiEvent {
+	UiEventType type;
+	unsigned int value;
+	unsigned int levelId;
+} UiEvent;
+
+/**
+ * Bounded lock-free queue of UI events with any number of producer threads and one consumer, the
+ * graphics thread. Each slot carries a sequence number telling whether it is free for the producer
+ * that claimed it or holds an event for the consumer, so producers only contend on the head.
+ * Events never allocate and a full queue drops the event instead of blocking the producer.
+ */
+class UiEventQueue {
+// Public functions
+public:
+	UiEventQueue();
+	~UiEventQueue();
+
+	bool post(UiEventType a_type, unsigned int a_value = 0, unsigned int a_levelId = 0); // any thread
+	bool pop(UiEvent& a_event); // graphics thread only
+
+	unsigned long long getDropped() const { return m_dropped.load(memory_order_relaxed); }
+
+// Private types
+private:
+	struct Slot {
+		atomic<size_t> sequence; // position the slot is free for, that position plus one once it holds an event
+		UiEvent event; // event in the slot
+	};
+
+// Private variables
+private:
+	Slot m_slots[UI_QUEUE_CAPACITY]; // events in the queue
+	alignas(64) atomic<size_t> m_head; // next slot a producer claims
+	alignas(64) size_t m_tail; // next slot the consumer reads
+	alignas(64) atomic<unsigned long long> m_dropped; // events lost to a full queue
+};
+
+#endif
@@ -12,11 +12,31 @@
 #include "chai3d.h"
 #include "Wing.h"
 #include "Body.h"
+#include "HapticScheduler.h"
+#include "SimulationSnapshot.h"
+#include "SimulationClock.h"
+#include "LogTrajectory.h"
+#include "InputRecorder.h"
+#include "ReplayDevice.h"
+#include "DeviceIO.h"
+#include "LevelModel.h"
+#include "PipeTrack.h"
+#include "LevelRandom.h"
+#include "TickProfiler.h"
+#include "FramePipeline.h"
+#include "UiEvents.h"
+#include "PipeRenderer.h"
+#include "BirdShader.h"
+#include "AssetLoader.h"
 //------------------------------------------------------------------------------
 #include <GLFW/glfw3.h>
 #include<iostream>
 #include<stdlib.h>
 #include<time.h>
+#include<climits>
+#include<thread>
+#include<sstream>
+#include<iomanip>
 //------------------------------------------------------------------------------
 using namespace chai3d;
 using namespace std;
@@ -41,17 +61,12 @@ bool fullscreen = false;
 // mirrored display
 bool mirroredDisplay = false;
 
-//number of devices
-const int MAX_DEVICES = 2;
+// number of devices to use, 0 uses every device found (two virtual Falcons in headless mode)
+int requestedDevices = 0;
 
+// if true, every device is read and written by its own I/O thread
+bool parallelDeviceIO = false;
 
-// structure for storing turublence parameters
-typedef struct turbulence {
-	double begin;
-	double end;
-	unsigned int periodRange;
-	unsigned int amplitudeRange;
-} turbulence;
 
 // game state enumerators
 enum GAME_STATE { MENU, LEVEL_SELECT, PLAY, PAUSE, GAME_OVER };
@@ -77,14 +92,14 @@ cDirectionalLight *light;
 // a haptic device handler
 cHapticDeviceHandler* handler;
 
-// a pointer to the current haptic device
-cGenericHapticDevicePtr hapticDevice[MAX_DEVICES];
+// the haptic devices in use
+vector<cGenericHapticDevicePtr> hapticDevice;
 
-// array to haptic device positions
-cVector3d hapticDevicePosition[MAX_DEVICES];
+// a small sphere (cursor) representing each haptic device 
+vector<cShapeSphere*> cursor;
 
-// a small sphere (cursor) representing the haptic device 
-cShapeSphere* cursor[MAX_DEVICES];
+// per-device I/O threads, used when parallelDeviceIO is set
+DeviceIO deviceIO;
 
 // flag to indicate if the haptic simulation currently running
 bool simulationRunning = false;
@@ -101,6 +116,16 @@ cFrequencyCounter freqCounterHaptics;
 // haptic thread
 cThread* hapticsThread;
 
+// fixed rate scheduler driving the haptic loop
+HapticScheduler hapticScheduler(HAPTIC_RATE_1KHZ);
+
+// game state written by the haptics thread, published to the graphics thread once per tick
+SimulationSnapshot simState;
+SnapshotBuffer snapshotBuffer;
+
+// changes of screen, menu selection, score and level posted to the graphics thread, which owns every widget
+UiEventQueue uiEvents;
+
 // a handle to window display context
 GLFWwindow* window = NULL;
 
@@ -113,6 +138,42 @@ int height = 0;
 // swap interval for the display context (vertical synchronization)
 int swapInterval = 1;
 
+// paces the frames of the graphics thread, the CPU may run this many frames ahead of the GPU
+FramePipeline framePipeline;
+unsigned int framesInFlight = 2;
+
+// if true, run levels back to back without a window, real devices or wall clock pacing
+bool headless = false;
+
+// number of levels to play in headless mode
+unsigned int headlessLevels = 100;
+
+// difficulty of the headless levels (0 cycles through all of them)
+unsigned int headlessDifficulty = 0;
+
+// number of headless levels played so far and how they went
+unsigned int headlessPlayed = 0;
+unsigned int headlessWins = 0;
+unsigned long long headlessScore = 0;
+unsigned long long headlessLevelStart = 0;
+
+// motion of the simulated hands holding the virtual Falcons in headless mode (sine, noise or a log file)
+string handTrajectory = "sine";
+InputLogFile handLog;
+
+// records the device input of every tick when a file is given with --record
+string recordFile = "";
+InputRecorder inputRecorder;
+
+// plays a recorded log back in place of the devices when a file is given with --replay
+string replayFile = "";
+InputLogFile replayLog;
+vector<ReplayDevicePtr> replayDevice;
+
+// times the phases of the haptic tick when a trace file is given with --profile
+string profileFile = "";
+TickProfiler tickProfiler;
+
 //number of haptic devices
 int numHapticDevices = 0;
 
@@ -144,21 +205,43 @@ cVector3d UPDRAFT(0, 0, 9.79); // counteract force of gravity to adjust playabil
 
 
 // level arrays
-vector<cShapeCylinder*> *currentLevel;
-vector<cShapeCylinder*> *lvl1 = new vector<cShapeCylinder*>();
-vector<cShapeCylinder*> *lvl2 = new vector<cShapeCylinder*>();
-vector<cShapeCylinder*> *lvl3 = new vector<cShapeCylinder*>();
-
-// level turbulence
-vector<turbulence*> *currentTurbulence;
-vector<turbulence*> *lvl1_turbulence = new vector<turbulence*>();
-vector<turbulence*> *lvl2_turbulence = new vector<turbulence*>();
-vector<turbulence*> *lvl3_turbulence = new vector<turbulence*>();
+vector<PipeInstance> *currentLevel = NULL; // pipes of the level in the world, owned by the graphics thread
+vector<PipeInstance> *lvl1 = new vector<PipeInstance>();
+vector<PipeInstance> *lvl2 = new vector<PipeInstance>();
+vector<PipeInstance> *lvl3 = new vector<PipeInstance>();
+
+// draws the pipes of the level that is played, all in one call
+PipeRenderer *levelPipes;
+
+// level layout (pipes and turbulence) the game is played against, the arrays above only draw it
+LevelModel *currentModel;
+LevelModel lvl1Model;
+LevelModel lvl2Model;
+LevelModel lvl3Model;
+
+// seed of every random number drawn by the game, the same seed plays the same levels
+uint64_t randomSeed = 0;
+LevelRandom lvl1Random; // lays out level 1
+LevelRandom lvl2Random; // lays out level 2
+LevelRandom lvl3Random; // lays out level 3
+constexpr uint64_t ENDLESS_STREAM = 10; // streams of the endless tracks start here, plus their difficulty
 
 // top and bottom of levels
 constexpr double CEILING = 0.15; // 0.15
 constexpr double FLOOR = -0.15; // -0.15
 
+// steps the bird is integrated in per haptic tick, each checked for collisions
+unsigned int physicsSubsteps = 1;
+constexpr unsigned int MAX_PHYSICS_SUBSTEPS = 16;
+
+// endless levels, generated ahead of the bird as it flies
+bool endlessMode = false;
+PipeTrack pipeTrack;
+constexpr double PIPE_TRACK_LOOKAHEAD = 10.0; // distance ahead of the bird that is kept generated, as far as the camera sees
+
+// draws the pipes of the endless track, two per slot of the track, recycled by the graphics thread
+PipeRenderer *trackPipes;
+
 
 
 //////////////////////////////////////// GLOBAL STATE VARIABLES /////////////////////////////////////
@@ -179,8 +262,6 @@ bool loseState = false; // to know if the user has lost the game
 
 unsigned int SCORE = 0; // users score
 
-bool isInitialized = false; // used to know if the menu elements have been initialized when first called
-
 bool GAME_STARTED = false; // to know if the initialization period is done
 bool INIT_PROCESS = false; // to know if currently in init process
 
@@ -219,22 +300,49 @@ cLabel* keyagainWin;
 cPanel* scorePanel;
 cLabel* scoreLabel;
 
+// UI as drawn by the graphics thread
+UiScreen uiScreen = UI_NONE; // screen whose widgets are shown
+unsigned int uiSelection = 0; // highlighted row of the menu on screen
+unsigned int uiScore = 0; // score on the score panel
+unsigned int uiLevelId = 0; // level whose pipes are in the world
+bool uiLayoutDirty = true; // widgets need to be placed again
+bool uiSelectionDirty = true; // menu rows need to be coloured again
+bool uiScoreDirty = true; // score text needs to be set again
+
 
 // GLOBAL CONSTANTS
 constexpr double p = 0.038; // air density
 constexpr double angleMultiplier = 20.0; // angle multiplier for wings rotation
 constexpr double pipeRadius = 0.03; // 0.015
+constexpr double pipeExtension = 1.0; // length the pipes reach past the ceiling and floor
 
 // game clock
-cPrecisionClock gameClock; // cClock timer for level 
+SimulationClock gameClock; // clock for level, advanced by one fixed step every haptic tick
 
 
 cBackground *background; // background image variable
 
+// loads the models and background and generates the levels on worker threads at start up
+AssetLoader assetLoader;
+int loadThreads = -1; // worker threads of the loader, -1 for one per core
+bool meshCache = true; // keep a precompiled cache next to each model so later starts skip parsing it
+bool meshOptimize = true; // weld the vertices of each model and reorder it for the vertex cache once loaded
+shared_future<bool> birdBodyLoaded;
+shared_future<bool> leftWingLoaded;
+shared_future<bool> rightWingLoaded;
+shared_future<bool> backgroundLoaded;
+shared_future<bool> levelsLoaded[3];
+cImagePtr backgroundImage; // decoded by a worker, handed to the background on the graphics thread
+bool birdAttached = false; // bird meshes are in the world, owned by the graphics thread
+bool levelShown = false; // a level is on screen, owned by the graphics thread
+
 //------------------------------------------------------------------------------
 // DECLARED FUNCTIONS
 //------------------------------------------------------------------------------
 
+// this function creates the window display and its OpenGL context
+bool initWindow(void);
+
 // callback when the window display is resized
 void windowSizeCallback(GLFWwindow* a_window, int a_width, int a_height);
 
@@ -247,12 +355,21 @@ void keyCallback(GLFWwindow* a_window, int a_key, int a_scancode, int a_action,
 // this function renders the scene
 void updateGraphics(void);
 
+// this function copies the latest haptics snapshot into the scene graph
+void applySnapshot(void);
+
+// this function applies the UI events posted since the last frame
+void applyUiEvents(void);
+
 // this function contains the main haptics simulation loop
 void updateHaptics(void);
 
 // this function closes the application
 void close(void);
 
+// this function changes the swap interval of the display context
+void setSwapInterval(int a_interval);
+
 
 
 
@@ -260,8 +377,10 @@ void close(void);
 
 ////////////////////////////// OUR ADDED FUNCTIONS ///////////////////////////////////
 
-void pipeGenerator(vector<cShapeCylinder*> *a_pipes, unsigned int a_difficulty);
-void turbulenceGenerator(vector<turbulence*> *a_turbulence, double a_lastX, unsigned int a_difficulty);
+void pipeGenerator(vector<PipeInstance> *a_pipes, LevelModel *a_level, LevelRandom *a_random, unsigned int a_difficulty);
+void turbulenceGenerator(LevelModel *a_level, LevelRandom *a_random, unsigned int a_difficulty);
+PipeSettings getPipeSettings(unsigned int a_difficulty);
+TurbulenceSettings getTurbulenceSettings(unsigned int a_difficulty);
 
 //scene changers
 void showtitleMenu();
@@ -269,6 +388,8 @@ void showlevelMenu();
 void showpauseMenu();
 void showgameoverMenu();
 void showwinMenu();
+void showScreen(UiScreen a_screen);
+void showLevel(int a_level);
 
 //scene cleaners
 void cleanTitle();
@@ -277,6 +398,16 @@ void cleanPause();
 void cleanLevel();
 void cleangameoverMenu();
 void cleanwinMenu();
+void cleanScreen(UiScreen a_screen);
+void hideLevel();
+
+// functions for placing and colouring the widgets
+void layoutUi();
+void colourMenu();
+
+// functions for posting changes to the graphics thread
+bool postUiEvent(UiEventType a_type, unsigned int a_value = 0, unsigned int a_levelId = 0);
+void postUiChanges();
 
 // level changer
 void setLevel(int level);
@@ -296,6 +427,23 @@ void playOptions(bool r_val[], bool l_val[], double &a_prev, double &a_current,
 void endGameOptions(bool r_val[], bool l_val[], double &a_prev, double &a_current, double &a_delta_t);
 void resetClockVars(double &prev, double &current, double &delta_t);
 
+// headless mode
+void runHeadless();
+bool startHeadlessLevel();
+void finishHeadlessLevel();
+void setupVirtualFalcon(cVirtualFalconDevicePtr a_falcon, int a_index);
+
+// device output
+void setDeviceForce(int a_device, const cVector3d& a_force);
+void setWingForces(const cVector3d& a_right, const cVector3d& a_left);
+void printLatency();
+
+// asset loading
+void loadAssets();
+bool loadModel(cMultiMesh* a_model, const string& a_filename);
+void attachBird();
+void printLoadProgress(unsigned int a_done, unsigned int a_total, const string& a_name, bool a_success);
+
 
 
 
@@ -309,7 +457,89 @@ void resetClockVars(double &prev, double &current, double &delta_t);
 
 int main(int argc, char* argv[])
 {
-	srand(time(0)); // initialize the random number generator
+	randomSeed = (uint64_t)time(0); // a new game every run unless a seed is given
+	bool seedGiven = false;
+
+	// read command line options
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (((arg == "-r") || (arg == "--rate")) && (i + 1 < argc)) {
+			unsigned int rate = (unsigned int)atoi(argv[++i]);
+			if (!hapticScheduler.setRate(rate)) {
+				cout << "unsupported haptic rate " << rate << " Hz, using " << hapticScheduler.getRate() << " Hz" << endl;
+			}
+		}
+		else if (arg == "--headless") {
+			headless = true;
+		}
+		else if ((arg == "--levels") && (i + 1 < argc)) {
+			headlessLevels = (unsigned int)atoi(argv[++i]);
+		}
+		else if ((arg == "--difficulty") && (i + 1 < argc)) {
+			headlessDifficulty = (unsigned int)atoi(argv[++i]);
+			if (headlessDifficulty > 3) headlessDifficulty = 0;
+		}
+		else if ((arg == "--hand") && (i + 1 < argc)) {
+			handTrajectory = argv[++i];
+		}
+		else if ((arg == "--record") && (i + 1 < argc)) {
+			recordFile = argv[++i];
+		}
+		else if ((arg == "--replay") && (i + 1 < argc)) {
+			replayFile = argv[++i];
+		}
+		else if ((arg == "--devices") && (i + 1 < argc)) {
+			requestedDevices = cMax(atoi(argv[++i]), 0);
+		}
+		else if (arg == "--parallel-io") {
+			parallelDeviceIO = true;
+		}
+		else if (arg == "--endless") {
+			endlessMode = true;
+		}
+		else if ((arg == "--seed") && (i + 1 < argc)) {
+			randomSeed = strtoull(argv[++i], NULL, 10);
+			seedGiven = true;
+		}
+		else if ((arg == "--profile") && (i + 1 < argc)) {
+			profileFile = argv[++i];
+		}
+		else if ((arg == "--swap-interval") && (i + 1 < argc)) {
+			swapInterval = cMax(atoi(argv[++i]), 0);
+		}
+		else if ((arg == "--frames-in-flight") && (i + 1 < argc)) {
+			framesInFlight = cClamp((unsigned int)atoi(argv[++i]), 1u, FRAME_PIPELINE_MAX_DEPTH);
+		}
+		else if ((arg == "--substeps") && (i + 1 < argc)) {
+			physicsSubsteps = cClamp((unsigned int)atoi(argv[++i]), 1u, MAX_PHYSICS_SUBSTEPS);
+		}
+		else if ((arg == "--load-threads") && (i + 1 < argc)) {
+			loadThreads = cMax(atoi(argv[++i]), 0);
+		}
+		else if (arg == "--no-mesh-cache") {
+			meshCache = false;
+		}
+		else if (arg == "--no-mesh-optimize") {
+			meshOptimize = false;
+		}
+	}
+
+	// a replay plays the levels its input was recorded against
+	if (replayFile != "") {
+		if (!replayLog.open(replayFile)) {
+			cout << "failed to open input log " << replayFile << endl;
+			return 1;
+		}
+		if (seedGiven && (randomSeed != replayLog.getHeader().seed)) {
+			cout << "ignoring --seed " << randomSeed << ", " << replayFile << " was recorded with seed " << replayLog.getHeader().seed << endl;
+		}
+		randomSeed = replayLog.getHeader().seed;
+	}
+
+	// every level draws from its own stream of the seed
+	lvl1Random.seed(randomSeed, LEVEL_1);
+	lvl2Random.seed(randomSeed, LEVEL_2);
+	lvl3Random.seed(randomSeed, LEVEL_3);
 
     //--------------------------------------------------------------------------
     // INITIALIZATION
@@ -322,86 +552,48 @@ int main(int argc, char* argv[])
     cout << "Keyboard Options:" << endl << endl;
     cout << "[f] - Enable/Disable full screen mode" << endl;
     cout << "[m] - Enable/Disable vertical mirroring" << endl;
+    cout << "[l] - Print the sense-to-actuate latency of every device" << endl;
+    cout << "[v] - Cycle the swap interval (0, 1, 2)" << endl;
+    cout << "[g] - Cycle the number of frames in flight (1 to 3)" << endl;
     cout << "[q] - Exit application" << endl;
+    cout << endl;
+    cout << "Command Line Options:" << endl << endl;
+    cout << "-r, --rate <500|1000|2000|4000> - Haptic loop rate in Hz" << endl;
+    cout << "--headless                  - Run levels without a window or devices" << endl;
+    cout << "--levels <n>                - Number of levels to run in headless mode" << endl;
+    cout << "--difficulty <1|2|3>        - Difficulty of the headless levels (default: all)" << endl;
+    cout << "--hand <sine|noise|file>    - Hand motion driving the headless devices" << endl;
+    cout << "--record <file>             - Record the device input to a file" << endl;
+    cout << "--replay <file>             - Play recorded device input back instead of the devices" << endl;
+    cout << "--devices <n>               - Number of haptic devices to use" << endl;
+    cout << "--parallel-io               - Read and write every device from its own thread" << endl;
+    cout << "--endless                   - Levels never end, pipes keep coming until the bird hits one" << endl;
+    cout << "--seed <n>                  - Seed of the level generation, the same seed plays the same levels" << endl;
+    cout << "--profile <file>            - Time the phases of the haptic loop and write a trace to a file" << endl;
+    cout << "--swap-interval <n>         - Screen refreshes per frame, 0 to not wait for vertical sync (default 1)" << endl;
+    cout << "--frames-in-flight <1|2|3>  - Frames the CPU may prepare ahead of the GPU (default 2)" << endl;
+    cout << "--substeps <n>              - Steps the bird is integrated in per haptic tick (default 1)" << endl;
+    cout << "--load-threads <n>          - Threads loading the assets at start up, 0 loads them in turn (default: one per core)" << endl;
+    cout << "--no-mesh-cache             - Parse the bird models on every start instead of using their caches" << endl;
+    cout << "--no-mesh-optimize          - Draw the bird models as loaded, without welding and reordering them" << endl;
+    cout << endl;
+    cout << "Random seed: " << randomSeed << endl;
     cout << endl << endl;
 
+	// read the models and background and generate the levels in the background while the window,
+	// world and devices are set up
+	loadAssets();
+
 
     //--------------------------------------------------------------------------
     // OPENGL - WINDOW DISPLAY
     //--------------------------------------------------------------------------
 
-    // initialize GLFW library
-    if (!glfwInit())
-    {
-        cout << "failed initialization" << endl;
-        cSleepMs(1000);
-        return 1;
-    }
-
-    // set error callback
-    glfwSetErrorCallback(errorCallback);
-
-    // compute desired size of window
-    const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
-    int w = 0.8 * mode->height;
-    int h = 0.5 * mode->height;
-    int x = 0.5 * (mode->width - w);
-    int y = 0.5 * (mode->height - h);
-
-    // set OpenGL version
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-
-    // set active stereo mode
-    if (stereoMode == C_STEREO_ACTIVE)
-    {
-        glfwWindowHint(GLFW_STEREO, GL_TRUE);
-    }
-    else
-    {
-        glfwWindowHint(GLFW_STEREO, GL_FALSE);
-    }
-
-    // create display context
-    window = glfwCreateWindow(w, h, "CHAI3D", NULL, NULL);
-    if (!window)
-    {
-        cout << "failed to create window" << endl;
-        cSleepMs(1000);
-        glfwTerminate();
-        return 1;
-    }
-
-    // get width and height of window
-    glfwGetWindowSize(window, &width, &height);
-
-    // set position of window
-    glfwSetWindowPos(window, x, y);
-
-    // set key callback
-    glfwSetKeyCallback(window, keyCallback);
-
-	// set mouse button callback
-	//glfwSetMouseButtonCallback(window, mouseButtonCallback);
-
-    // set resize callback
-    glfwSetWindowSizeCallback(window, windowSizeCallback);
-
-    // set current display context
-    glfwMakeContextCurrent(window);
-
-    // sets the swap interval for the current display context
-    glfwSwapInterval(swapInterval);
-
-#ifdef GLEW_VERSION
-    // initialize GLEW library
-    if (glewInit() != GLEW_OK)
+    // no window is opened in headless mode
+    if (!headless && !initWindow())
     {
-        cout << "failed to initialize GLEW library" << endl;
-        glfwTerminate();
         return 1;
     }
-#endif
 
 
     //--------------------------------------------------------------------------
@@ -419,16 +611,19 @@ int main(int argc, char* argv[])
     camera = new cCamera(world);
     world->addChild(camera);
 
-	// set background image
+	// set background image, shown once it is decoded
 	background = new cBackground;
-	background->loadFromFile("background.jpg");
 	camera->m_backLayer->addChild(background);
+	assetLoader.post([] { if (backgroundLoaded.get()) background->loadFromImage(backgroundImage); }, { backgroundLoaded });
 	
     // position and orient the camera
     camera->set( cVector3d (0.5, 0.0, 0.0),    // camera position (eye)
                  cVector3d (0.0, 0.0, 0.0),    // look at position (target)
                  cVector3d (0.0, 0.0, 1.0));   // direction of the (up) vector
 
+	// start the haptics state from the same defaults the snapshot buffer holds
+	snapshotBuffer.consume(simState);
+
     // set the near and far clipping planes of the camera
     camera->setClippingPlanes(0.01, 10.0);
 
@@ -458,17 +653,46 @@ int main(int argc, char* argv[])
     // HAPTIC DEVICE
     //--------------------------------------------------------------------------
 
+	// virtual Falcons stand in for the real ones without hardware, and always replace them when running headless
+	cVirtualFalconDevice::setNumDevices((requestedDevices > 0) ? requestedDevices : 2);
+	cHapticDeviceHandler::setEnableVirtualDevices(true, headless);
+
     // create a haptic device handler
     handler = new cHapticDeviceHandler();
 
 	// get number of haptic devices
 	numHapticDevices = handler->getNumDevices();
+	if (requestedDevices > 0) numHapticDevices = cMin(numHapticDevices, requestedDevices);
+
+	// the simulated hands can follow a recorded session
+	if ((handTrajectory != "sine") && (handTrajectory != "noise") && !handLog.open(handTrajectory)) {
+		cout << "failed to open input log " << handTrajectory << endl;
+		return 1;
+	}
+
+	// a replay stands in for the devices that were recorded, at the rate they were recorded at
+	if (replayLog.isOpen()) {
+		hapticScheduler.setRate(replayLog.getHeader().rate);
+		numHapticDevices = (int)replayLog.getHeader().deviceCount;
+		if (requestedDevices > 0) numHapticDevices = cMin(numHapticDevices, requestedDevices);
+	}
+	hapticDevice.resize(numHapticDevices);
+	cursor.resize(numHapticDevices);
+	replayDevice.resize(numHapticDevices);
 
 	// setup each haptic device
 	for (int i = 0; i < numHapticDevices; i++)
 	{
 		// get a handle to the first haptic device
-		handler->getDevice(hapticDevice[i], i);
+		if (replayLog.isOpen()) {
+			replayDevice[i] = ReplayDevice::create(i, &replayLog, &hapticScheduler);
+			hapticDevice[i] = replayDevice[i];
+		}
+		else handler->getDevice(hapticDevice[i], i);
+
+		// virtual Falcons listed by the handler run on the time of the haptic loop
+		cVirtualFalconDevicePtr falcon = dynamic_pointer_cast<cVirtualFalconDevice>(hapticDevice[i]);
+		if (falcon != nullptr) setupVirtualFalcon(falcon, i);
 
 		// open a connection to haptic device
 		hapticDevice[i]->open();
@@ -481,6 +705,7 @@ int main(int argc, char* argv[])
 
 		// create a sphere (cursor) to represent the haptic device
 		cursor[i] = new cShapeSphere(0.01);
+		cursor[i]->setUseLevelOfDetail(true); // the cursors are small on screen, draw them coarser
 
 		// insert cursor inside world
 		world->addChild(cursor[i]);
@@ -500,47 +725,36 @@ int main(int argc, char* argv[])
 		hapticDevice[i]->setEnableGripperUserSwitch(true);
 	}
 
+	// start writing the device input of every tick to disk
+	if ((recordFile != "") && !inputRecorder.open(recordFile, numHapticDevices, hapticScheduler.getRate(), randomSeed)) {
+		cout << "failed to create input log " << recordFile << endl;
+	}
 
-	//--------------------------------------------------------------------------
-	// WORDL OBJECTS
-	//--------------------------------------------------------------------------
-	// create bird object
-	birdBody->body = new cMultiMesh(); 
-	birdBody->body->loadFromFile("birdBody.obj");
-	birdBody->body->setUseTransparency(false);
-	birdBody->body->setLocalPos(0.0, 0.0, 0.0);
-
-	// create wings
-	birdBody->leftWing = new cMultiMesh();
-	birdBody->leftWing->loadFromFile("leftWing.obj");
-	birdBody->leftWing->setUseTransparency(false);
-	birdBody->leftWing->setLocalPos(0, -0.002, 0.002); // relative to the bird body
-	birdBody->rightWing = new cMultiMesh();
-	birdBody->rightWing->loadFromFile("rightWing.obj");
-	birdBody->rightWing->setUseTransparency(false);
-	birdBody->rightWing->setLocalPos(0, 0.002, 0.002); // relative to the bird body
+	// hand every device to its own I/O thread
+	if (parallelDeviceIO) deviceIO.start(hapticDevice);
 
-	// parent wings and body
-	birdBody->body->addChild(birdBody->rightWing);
-	birdBody->body->addChild(birdBody->leftWing);
-	birdBody->body->setEnabled(false, true);
-	birdBody->body->setShowEnabled(false, true);
-	world->addChild(birdBody->body);
+	// start timing the phases of the haptic loop
+	if (profileFile != "") tickProfiler.start();
 
-	// set the birds colour
-	cMaterialPtr birdColour = birdBody->body->m_material;
-	birdColour->setBlue();
-	birdBody->body->setMaterial(birdColour, true);
 
-	// level generation
-	pipeGenerator(lvl1, 1);
-	pipeGenerator(lvl2, 2);
-	pipeGenerator(lvl3, 3);
-	
-	// generate turbulence for each level
-	turbulenceGenerator(lvl1_turbulence, lvl1->back()->getLocalPos().x(), 1);
-	turbulenceGenerator(lvl2_turbulence, lvl2->back()->getLocalPos().x(), 2);
-	turbulenceGenerator(lvl3_turbulence, lvl3->back()->getLocalPos().x(), 3);
+	//--------------------------------------------------------------------------
+	// WORDL OBJECTS
+	//--------------------------------------------------------------------------
+	// the bird is put in the world by the graphics thread once its meshes are loaded
+	assetLoader.post(attachBird, { birdBodyLoaded, leftWingLoaded, rightWingLoaded });
+
+	// the pipes of a level are handed to the renderer when the level is shown
+	levelPipes = new PipeRenderer();
+	world->addChild(levelPipes);
+
+	// the endless track draws its pipes with a fixed set of instances
+	cColorf pipeColour;
+	pipeColour.setGreenLight();
+	trackPipes = new PipeRenderer();
+	for (unsigned int i = 0; i < 2 * PIPE_TRACK_CAPACITY; i++) {
+		trackPipes->setPipeEnabled(trackPipes->addPipe(cVector3d(0, 0, 0), pipeRadius, 1.0, pipeColour), false);
+	}
+	world->addChild(trackPipes);
 
 
     //--------------------------------------------------------------------------
@@ -699,6 +913,18 @@ int main(int argc, char* argv[])
     // START SIMULATION
     //--------------------------------------------------------------------------
 
+	// headless mode runs the haptic loop on this thread until all levels are played
+	if (headless) {
+		atexit(close);
+		assetLoader.wait();
+		assetLoader.runRenderTasks(); // nothing is drawn, this thread stands in for the graphics thread
+		runHeadless();
+		return 0;
+	}
+
+	// the haptics thread plays the levels, the models can keep loading while the menu is up
+	for (unsigned int i = 0; i < 3; i++) levelsLoaded[i].wait();
+
     // create a thread which starts the main haptics rendering loop
     hapticsThread = new cThread();
     hapticsThread->start(updateHaptics, CTHREAD_PRIORITY_HAPTICS);
@@ -725,6 +951,7 @@ int main(int argc, char* argv[])
 
         // swap buffers
         glfwSwapBuffers(window);
+        framePipeline.framePresented();
 
         // process events
         glfwPollEvents();
@@ -733,6 +960,10 @@ int main(int argc, char* argv[])
         freqCounterGraphics.signal(1);
     }
 
+    // report the frame timings and wait for the frames still in flight
+    framePipeline.printReport(cout);
+    framePipeline.release();
+
     // close window
     glfwDestroyWindow(window);
 
@@ -745,11 +976,107 @@ int main(int argc, char* argv[])
 
 //------------------------------------------------------------------------------
 
+bool initWindow(void)
+{
+    // initialize GLFW library
+    if (!glfwInit())
+    {
+        cout << "failed initialization" << endl;
+        cSleepMs(1000);
+        return false;
+    }
+
+    // set error callback
+    glfwSetErrorCallback(errorCallback);
+
+    // compute desired size of window
+    const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    int w = 0.8 * mode->height;
+    int h = 0.5 * mode->height;
+    int x = 0.5 * (mode->width - w);
+    int y = 0.5 * (mode->height - h);
+
+    // set OpenGL version
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+
+    // set active stereo mode
+    if (stereoMode == C_STEREO_ACTIVE)
+    {
+        glfwWindowHint(GLFW_STEREO, GL_TRUE);
+    }
+    else
+    {
+        glfwWindowHint(GLFW_STEREO, GL_FALSE);
+    }
+
+    // create display context
+    window = glfwCreateWindow(w, h, "CHAI3D", NULL, NULL);
+    if (!window)
+    {
+        cout << "failed to create window" << endl;
+        cSleepMs(1000);
+        glfwTerminate();
+        return false;
+    }
+
+    // get width and height of window
+    glfwGetWindowSize(window, &width, &height);
+
+    // set position of window
+    glfwSetWindowPos(window, x, y);
+
+    // set key callback
+    glfwSetKeyCallback(window, keyCallback);
+
+	// set mouse button callback
+	//glfwSetMouseButtonCallback(window, mouseButtonCallback);
+
+    // set resize callback
+    glfwSetWindowSizeCallback(window, windowSizeCallback);
+
+    // set current display context
+    glfwMakeContextCurrent(window);
+
+    // sets the swap interval for the current display context
+    glfwSwapInterval(swapInterval);
+
+#ifdef GLEW_VERSION
+    // initialize GLEW library
+    if (glewInit() != GLEW_OK)
+    {
+        cout << "failed to initialize GLEW library" << endl;
+        glfwTerminate();
+        return false;
+    }
+#endif
+
+    // set up fences and timer queries for the frames
+    framePipeline.init();
+    framePipeline.setMaxFramesInFlight(framesInFlight);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
 void windowSizeCallback(GLFWwindow* a_window, int a_width, int a_height)
 {
     // update window size
     width  = a_width;
     height = a_height;
+
+    // place the widgets for the new size on the next frame
+    uiLayoutDirty = true;
+}
+
+//------------------------------------------------------------------------------
+
+void setSwapInterval(int a_interval)
+{
+    // takes effect on the display context of the graphics thread
+    swapInterval = a_interval;
+    glfwSwapInterval(swapInterval);
 }
 
 //------------------------------------------------------------------------------
@@ -791,7 +1118,7 @@ void keyCallback(GLFWwindow* a_window, int a_key, int a_scancode, int a_action,
         if (fullscreen)
         {
             glfwSetWindowMonitor(window, monitor, 0, 0, mode->width, mode->height, mode->refreshRate);
-            glfwSwapInterval(swapInterval);
+            setSwapInterval(swapInterval);
         }
         else
         {
@@ -800,7 +1127,7 @@ void keyCallback(GLFWwindow* a_window, int a_key, int a_scancode, int a_action,
             int x = 0.5 * (mode->width - w);
             int y = 0.5 * (mode->height - h);
             glfwSetWindowMonitor(window, NULL, x, y, w, h, mode->refreshRate);
-            glfwSwapInterval(swapInterval);
+            setSwapInterval(swapInterval);
         }
     }
 
@@ -816,11 +1143,22 @@ void keyCallback(GLFWwindow* a_window, int a_key, int a_scancode, int a_action,
 	else if (a_key == GLFW_KEY_C) {
 		COLLISION = !COLLISION;
 	}
+	else if (a_key == GLFW_KEY_L) {
+		printLatency();
+	}
+	else if (a_key == GLFW_KEY_V) {
+		setSwapInterval((swapInterval + 1) % 3);
+		cout << "swap interval " << swapInterval << endl;
+	}
+	else if (a_key == GLFW_KEY_G) {
+		framePipeline.setMaxFramesInFlight(framePipeline.getMaxFramesInFlight() % FRAME_PIPELINE_MAX_DEPTH + 1);
+		cout << framePipeline.getMaxFramesInFlight() << " frames in flight" << endl;
+	}
 	else if (a_key == GLFW_KEY_P) {
-		isInitialized = false;
+		// the haptics thread posts the change of screen on its next tick
 		if (gameState == PLAY) gameState = PAUSE;
 		else if (gameState == PAUSE) {
-			cleanPause();
+			pauseState = P_RESUME;
 			gameState = PLAY;
 		}
 	}
@@ -836,10 +1174,42 @@ void close(void)
     // wait for graphics and haptics loops to terminate
     while (!simulationFinished) { cSleepMs(100); }
 
-	// close haptic device
-	for (int i = 0; i < numHapticDevices; i++)
-	{
-		hapticDevice[i]->close();
+	// report how well the haptic loop kept its rate
+	cout << "haptic loop: " << hapticScheduler.getTickCount() << " ticks at " << hapticScheduler.getRate() << " Hz, "
+		 << hapticScheduler.getMissedDeadlines() << " missed deadlines" << endl;
+
+	// report where the time of the haptic loop went
+	if (tickProfiler.isEnabled()) {
+		tickProfiler.stop();
+		tickProfiler.printReport(cout);
+		if (tickProfiler.writeTrace(profileFile)) cout << "haptic trace written to " << profileFile << endl;
+		else cout << "failed to write haptic trace " << profileFile << endl;
+	}
+
+	// flush the input log
+	if (inputRecorder.isRecording()) {
+		inputRecorder.close();
+		cout << "input log: " << inputRecorder.getRecordCount() << " records written to " << recordFile << ", "
+			 << inputRecorder.getDroppedCount() << " dropped" << endl;
+	}
+
+	// stop the device I/O threads before the devices are closed
+	if (deviceIO.isRunning()) {
+		cout << "parallel device I/O: " << deviceIO.getDeviceCount() << " threads, "
+			 << deviceIO.getPinnedCount() << " pinned to a core" << endl;
+		deviceIO.stop();
+	}
+
+	// report how long the forces took to follow the positions they were computed from
+	printLatency();
+
+	// let the loader finish what is still queued
+	assetLoader.stop();
+
+	// close haptic device
+	for (int i = 0; i < numHapticDevices; i++)
+	{
+		hapticDevice[i]->close();
 	}
 
     // delete resources
@@ -856,14 +1226,24 @@ void updateGraphics(void)
     // RENDER SCENE
     /////////////////////////////////////////////////////////////////////
 
+    // wait until there is room for another frame on the GPU
+    framePipeline.beginFrame();
+
     // update shadow maps (if any)
     world->updateShadowMaps(false, mirroredDisplay);
 
+    // put the assets that finished loading in the scene graph
+    assetLoader.runRenderTasks();
+
+    // bring the widgets and the scene graph up to date with the haptics thread
+    applyUiEvents();
+    applySnapshot();
+
     // render world
     camera->renderView(width, height);
 
-    // wait until all GL commands are completed
-    glFinish();
+    // fence the frame, the GPU finishes it while the next one is prepared
+    framePipeline.endFrame();
 
     // check for any OpenGL errors
     GLenum err;
@@ -873,23 +1253,158 @@ void updateGraphics(void)
 
 //------------------------------------------------------------------------------
 
+void applySnapshot(void)
+{
+	// graphics side bookkeeping for the snapshot that was last applied
+	static unsigned int levelId = 0;
+	static unsigned int hiddenPipes = 0;
+	static unsigned long long poolPipe[PIPE_TRACK_CAPACITY]; // pair shown by each slot of the pipe pool, plus one
+
+	static SimulationSnapshot snapshot; // newest snapshot, drawn again until a newer one comes in
+	static bool received = false;
+
+	bool fresh = snapshotBuffer.consume(snapshot);
+	received = received || fresh;
+	if (!received) return; // the haptics thread has not published yet
+
+	// the bird and camera are drawn between the last two ticks, one tick behind the haptics thread,
+	// so they move smoothly whatever the haptic rate and frame rate are
+	double alpha = cClamp((double)(HapticScheduler::now() - snapshot.publishTime) / (snapshot.period * 1e9), 0.0, 1.0);
+	if (birdAttached) birdBody->body->setLocalPos(snapshot.previousBirdPos + alpha * (snapshot.birdPos - snapshot.previousBirdPos));
+	camera->set(snapshot.previousCameraEye + alpha * (snapshot.cameraEye - snapshot.previousCameraEye),
+				snapshot.previousCameraTarget + alpha * (snapshot.cameraTarget - snapshot.previousCameraTarget),
+				snapshot.cameraUp);
+
+	if (!fresh) return; // nothing else changed since the last frame
+
+	// wings
+	if (birdAttached) {
+		birdBody->rightWing->setLocalRot(cMatrix3d(1.0, 0.0, 0.0, snapshot.rightWingAngle));
+		birdBody->leftWing->setLocalRot(cMatrix3d(1.0, 0.0, 0.0, snapshot.leftWingAngle));
+	}
+
+	// device cursors
+	for (int i = 0; (i < numHapticDevices) && (i < SNAPSHOT_MAX_CURSORS); i++) {
+		cursor[i]->setLocalPos(snapshot.cursorPos[i]);
+		cursor[i]->setLocalRot(snapshot.cursorRot[i]);
+	}
+
+	// remove pipes the bird has moved past
+	if (snapshot.levelId != levelId) {
+		levelId = snapshot.levelId;
+		hiddenPipes = 0;
+		for (unsigned int slot = 0; slot < PIPE_TRACK_CAPACITY; slot++) poolPipe[slot] = ULLONG_MAX; // redo every slot
+	}
+	// the snapshot and the UI events travel separately, only touch the pipes once both are on the same level
+	if ((levelId == uiLevelId) && (currentLevel != NULL)) {
+		for (; (hiddenPipes < snapshot.firstActivePipe) && (hiddenPipes < levelPipes->getPipeCount()); hiddenPipes++) {
+			levelPipes->setPipeEnabled(hiddenPipes, false);
+		}
+	}
+
+	// move the instances of the endless track onto the pairs that are new in their slot and hide the
+	// slots that are not in use
+	for (unsigned int slot = 0; slot < PIPE_TRACK_CAPACITY; slot++) {
+		unsigned long long sequence = snapshot.trackFirstPipe + ((slot - snapshot.trackFirstPipe) & (PIPE_TRACK_CAPACITY - 1));
+		bool used = (sequence < snapshot.trackFirstPipe + snapshot.trackPipeCount);
+		unsigned int topPipe = 2 * slot;
+		unsigned int bottomPipe = 2 * slot + 1;
+
+		if (!used) {
+			if (poolPipe[slot] != 0) {
+				trackPipes->setPipeEnabled(topPipe, false);
+				trackPipes->setPipeEnabled(bottomPipe, false);
+				poolPipe[slot] = 0;
+			}
+		}
+		else if (poolPipe[slot] != sequence + 1) {
+			cVector3d topPos, bottomPos;
+			double topHeight, bottomHeight;
+			LevelModel::pipeGeometry(snapshot.trackSettings, snapshot.trackPipes[slot], topPos, topHeight, bottomPos, bottomHeight);
+
+			trackPipes->setPipe(topPipe, topPos, snapshot.trackPipes[slot].radius, topHeight);
+			trackPipes->setPipe(bottomPipe, bottomPos, snapshot.trackPipes[slot].radius, bottomHeight);
+			trackPipes->setPipeEnabled(topPipe, true);
+			trackPipes->setPipeEnabled(bottomPipe, true);
+			poolPipe[slot] = sequence + 1;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+
+void applyUiEvents(void)
+{
+	UiEvent event;
+	while (uiEvents.pop(event)) {
+		switch (event.type) {
+		case UI_SCREEN:
+			if ((UiScreen)event.value != uiScreen) {
+				cleanScreen(uiScreen);
+				uiScreen = (UiScreen)event.value;
+				showScreen(uiScreen);
+				uiLayoutDirty = true;
+				uiSelectionDirty = true;
+			}
+			break;
+		case UI_SELECTION:
+			uiSelection = event.value;
+			uiSelectionDirty = true;
+			break;
+		case UI_SCORE:
+			uiScore = event.value;
+			uiScoreDirty = true;
+			break;
+		case UI_LEVEL_START:
+			hideLevel();
+			showLevel(event.value);
+			uiLevelId = event.levelId;
+			uiLayoutDirty = true;
+			break;
+		case UI_LEVEL_END:
+			hideLevel();
+			break;
+		}
+	}
+
+	// text and layout are only redone when something they depend on changed
+	if (uiScoreDirty) {
+		scoreLabel->setText("SCORE: " + cStr(uiScore)); // update score label
+		uiScoreDirty = false;
+		uiLayoutDirty = true; // the label is centred on its new width
+	}
+	if (uiSelectionDirty) {
+		colourMenu();
+		uiSelectionDirty = false;
+	}
+	if (uiLayoutDirty) {
+		layoutUi();
+		uiLayoutDirty = false;
+	}
+}
+
+//------------------------------------------------------------------------------
+
 void updateHaptics(void)
 {
     simulationRunning  = true; // to know if the haptic loop is still going
     simulationFinished = false; // to know if we need to terminate
 
-	cVector3d velocity[2] = { cVector3d(0, 0, 0), cVector3d(0, 0, 0) }; // array for veocity for each device
-	cVector3d position[2] = { cVector3d(0, 0, 0), cVector3d(0, 0, 0) }; // array for position for each device
-	cMatrix3d rotation[2];
+	// the game reads the first two devices even when only one is connected
+	int numSlots = cMax(numHapticDevices, 2);
+	vector<cVector3d> velocity(numSlots, cVector3d(0, 0, 0)); // array for veocity for each device
+	vector<cVector3d> position(numSlots, cVector3d(0, 0, 0)); // array for position for each device
+	vector<cMatrix3d> rotation(numSlots, cIdentity3d());
+	vector<cHapticDeviceState> deviceStates(numHapticDevices); // everything read from each device in one tick
+
+	// the I/O threads keep off the core of the haptic thread
+	if (deviceIO.isRunning()) deviceIO.pinSimulationThread();
 
 	cVector3d netForce; // force accumulator
 	cVector3d acceleration; // acceleration variable
-	cVector3d newVelocity; // storage for new velocity calculation
 
 	// haptic device accumulators
 	cVector3d force(0, 0, 0);
-	cVector3d torque(0, 0, 0);
-	double gripperForce = 0.0;
 
 	double prev = 0.0; // stores prev time value
 	double current = 0.0; // stores current time value
@@ -905,6 +1420,7 @@ void updateHaptics(void)
 	bool startSetupClock = false; // bool for knowing if the init clock has been started or not
 
 	bool scoreUpdate = false; // to know when to update the score after passing a pipe
+	vector<unsigned int> nearbyTurbulence; // turbulence regions the bird is in
 
 
 	// button readers
@@ -919,47 +1435,73 @@ void updateHaptics(void)
 	bool leftButtonValues[4] = { false, false, false, false };
 
 
+	// arm the first deadline of the fixed rate loop
+	hapticScheduler.start();
 
     // main haptic simulation loop
     while(simulationRunning)
     {
+		// move game time forward by one fixed step
+		gameClock.advance(hapticScheduler.getPeriod());
+
+		// the graphics thread draws between the state published last tick and the one of this tick
+		simState.previousBirdPos = simState.birdPos;
+		simState.previousCameraEye = simState.cameraEye;
+		simState.previousCameraTarget = simState.cameraTarget;
+
+		// read position, orientation, velocity and buttons of every device, all at once when each
+		// device has its own I/O thread
+		ProfileScope readScope(tickProfiler, PROFILE_DEVICE_READ);
+		if (deviceIO.isRunning()) {
+			deviceIO.sample(deviceStates);
+		} else {
+			for (int i = 0; i < numHapticDevices; i++) {
+				deviceStates[i].m_userSwitches = 0;
+				hapticDevice[i]->getState(deviceStates[i]);
+			}
+		}
+		readScope.end();
+
+		// even devices hold the right wing, odd devices the left one
+		ProfileScope buttonScope(tickProfiler, PROFILE_BUTTONS);
+		for (int i = 0; i < 4; i++) {
+			rightFalconButtons[i] = false;
+			leftFalconButtons[i] = false;
+		}
+
 		for (int i = 0; i < numHapticDevices; i++) {
-			// read position 
-			hapticDevice[i]->getPosition(position[i]);
-
-			// read orientation 
-			hapticDevice[i]->getRotation(rotation[i]);
-
-			hapticDevice[i]->getLinearVelocity(velocity[i]);
-
-			// button calls
-			// read user-switch status (button 0)
-			button0 = false, button1 = false, button2 = false, button3 = false;
-			hapticDevice[i]->getUserSwitch(0, button0);
-			hapticDevice[i]->getUserSwitch(1, button1);
-			hapticDevice[i]->getUserSwitch(2, button2);
-			hapticDevice[i]->getUserSwitch(3, button3);
-
-			if (i == 0) {
-				rightFalconButtons[0] = button0;
-				rightFalconButtons[1] = button1;
-				rightFalconButtons[2] = button2; 
-				rightFalconButtons[3] = button3;
-			} else {
-				leftFalconButtons[0] = button0;
-				leftFalconButtons[1] = button1;
-				leftFalconButtons[2] = button2;
-				leftFalconButtons[3] = button3;
+			const cHapticDeviceState& deviceState = deviceStates[i];
+			position[i] = deviceState.m_position;
+			rotation[i] = deviceState.m_rotation;
+			velocity[i] = deviceState.m_linearVelocity;
+
+			// button states
+			button0 = deviceState.getUserSwitch(0);
+			button1 = deviceState.getUserSwitch(1);
+			button2 = deviceState.getUserSwitch(2);
+			button3 = deviceState.getUserSwitch(3);
+
+			// log exactly what was read so the session can be replayed
+			if (inputRecorder.isRecording()) {
+				inputRecorder.record(hapticScheduler.getTickCount(), i, position[i], rotation[i], velocity[i], deviceState.m_userSwitches);
 			}
 
+			bool* falconButtons = (i % 2 == 0) ? rightFalconButtons : leftFalconButtons;
+			falconButtons[0] = falconButtons[0] || button0;
+			falconButtons[1] = falconButtons[1] || button1;
+			falconButtons[2] = falconButtons[2] || button2;
+			falconButtons[3] = falconButtons[3] || button3;
+
 
 			/////////////////////////////////////////////////////////////////////
 			// UPDATE 3D CURSOR MODEL
 			/////////////////////////////////////////////////////////////////////
 
 			// update position and orienation of cursor
-			cursor[i]->setLocalPos(position[i]);
-			cursor[i]->setLocalRot(rotation[i]);
+			if (i < SNAPSHOT_MAX_CURSORS) {
+				simState.cursorPos[i] = position[i];
+				simState.cursorRot[i] = rotation[i];
+			}
 
 		}
 		// read and set button values
@@ -971,18 +1513,17 @@ void updateHaptics(void)
 			bool pressed = isPressed(leftFalconButtons[i], leftIsPressed[i]);
 			leftButtonValues[i] = pressed;
 		}
+		buttonScope.end();
 
 
 
 
 		switch (gameState) {
 		case MENU: {
-			showtitleMenu();
 			mainMenuOptions(rightButtonValues, leftButtonValues);
 			break;
 		}
 		case LEVEL_SELECT: {			
-			showlevelMenu();
 			levelSelectOptions(rightButtonValues, leftButtonValues);
 			break;
 		}
@@ -997,7 +1538,7 @@ void updateHaptics(void)
 			netForce = cVector3d(0, 0, 0); // reset net force
 
 			if (!GAME_STARTED) {
-				updateCamera(cameraAngle, birdBody->body->getLocalPos()); // allow camera anlge readjust during setup
+				updateCamera(cameraAngle, birdBody->m_position); // allow camera anlge readjust during setup
 				
 				if (!startSetupClock) {
 					gameClock.reset();
@@ -1012,13 +1553,12 @@ void updateHaptics(void)
 						// apply easing force to controller to guide user into correct position
 						birdBody->controllerStartup(position[0], position[0], currTime, startUpTime);
 						force = birdBody->m_rightWing->m_F_net + birdBody->m_leftWing->m_F_net / 2.0;
-						hapticDevice[0]->setForceAndTorqueAndGripperForce(force, torque, gripperForce);
+						setDeviceForce(0, force);
 						break;
-					case 2:
+					default:
 						// apply easing force to controller to guide user into correct position
 						birdBody->controllerStartup(position[0], position[1], currTime, startUpTime);
-						hapticDevice[0]->setForceAndTorqueAndGripperForce(birdBody->m_rightWing->m_F_net, torque, gripperForce);
-						hapticDevice[1]->setForceAndTorqueAndGripperForce(birdBody->m_leftWing->m_F_net, torque, gripperForce);
+						setWingForces(birdBody->m_rightWing->m_F_net, birdBody->m_leftWing->m_F_net);
 						break;
 					}
 					if (currTime > startUpTime) {
@@ -1040,40 +1580,39 @@ void updateHaptics(void)
 			/////////////////////////////////////////////////////////////////////
 
 			force = cVector3d(0, 0, 0);
-			torque = cVector3d(0, 0, 0);
-			gripperForce = 0.0;
 
 			cVector3d Flift_right;
 			cVector3d Flift_left;
 
 
 			// Get the cumulative forces for each wing
+			ProfileScope forceScope(tickProfiler, PROFILE_FORCES);
 			switch (numHapticDevices) {
 			case 1:
 				birdBody->updateForces(position[0], position[0], velocity[0], velocity[0]);
 				break;
-			case 2:
+			default:
 				birdBody->updateForces(position[0], position[1], velocity[0], velocity[1]);
 				break;
 			}
-
-			// define game turbulence regions
-			if (currentTurbulence->size() > 0) {
-				if (birdBody->body->getLocalPos().x() > currentTurbulence->at(0)->begin) {
-					// do nothin, don't pop
-				}
-				else if ((birdBody->body->getLocalPos().x() <= currentTurbulence->at(0)->begin) &&
-					(birdBody->body->getLocalPos().x() >= currentTurbulence->at(0)->end)) {
-					// turbulence applies
-					birdBody->applyTurbulence(gameClock.getCurrentTimeSeconds(), // was timer
-						currentTurbulence->at(0)->periodRange,
-						currentTurbulence->at(0)->amplitudeRange);
-				}
-				else if (birdBody->body->getLocalPos().x() < currentTurbulence->at(0)->end) {
-					// turbulence is done for this element, pop since done for a little bit
-					currentTurbulence->erase(currentTurbulence->begin());
-				}
+			forceScope.end();
+
+			// the endless track generates what lies ahead of the bird
+			if (endlessMode) pipeTrack.update(birdBody->m_position.x());
+
+			// the layout the bird is flying through, the endless track keeps its own
+			const LevelModel& level = endlessMode ? pipeTrack.getModel() : *currentModel;
+
+			// define game turbulence regions, turbulence applies inside the regions the bird is in
+			ProfileScope turbulenceScope(tickProfiler, PROFILE_TURBULENCE);
+			level.findTurbulence(birdBody->m_position.x(), birdBody->m_position.x(), nearbyTurbulence);
+			for (unsigned int i : nearbyTurbulence) {
+				turbulence region = level.getTurbulence(i);
+				birdBody->applyTurbulence(gameClock.getCurrentTimeSeconds(), // was timer
+					region,
+					level.getTurbulenceWave(i));
 			}
+			turbulenceScope.end();
 
 			// get final forces
 			Flift_right = birdBody->m_rightWing->m_F_net;
@@ -1088,39 +1627,30 @@ void updateHaptics(void)
 			// UPDATE GRAPHICS
 			//////////////////////////////////////////////////////////////////////
 			// update position of the bird, bird graphic, camera
+			ProfileScope integrationScope(tickProfiler, PROFILE_INTEGRATION);
 			current = gameClock.getCurrentTimeSeconds(); // was timer
-			delta_t = current - prev;
+			delta_t = hapticScheduler.getPeriod(); // constant step, independent of loop jitter
 
 			cVector3d Flift;
 
 			// calculate force difference for graphical portion
 			double wingRatio = (birdBody->m_rightWing->m_currentAreaRatio + birdBody->m_leftWing->m_currentAreaRatio) / 2.0;
 			acceleration = ((netForce) / birdBody->m_mass) + GRAVITY + (UPDRAFT * wingRatio);
-			newVelocity = birdBody->m_velocity + acceleration * delta_t;
-
-			//cVector3d newPos = birdBody->m_localPos + newVelocity * delta_t;
-			cVector3d newPos = birdBody->body->getLocalPos() + newVelocity * delta_t;
 
-			// update bird haptic object
+			// update bird haptic object in fixed substeps, sweeping each one against the pipes that are left
+			bool hitPipe = false;
 			if (!collisionDetected) { // check to make sure we haven't hit anything before updating
-				if ((newPos.z() < CEILING) && (newPos.z() > FLOOR)) {
-					birdBody->m_velocity = newVelocity;
-					birdBody->body->setLocalPos(newPos); //birdBody->m_localPos = newPos;
-				}
-				else {
-					birdBody->m_velocity = cVector3d(newVelocity.x(), 0, 0);
-					if ((newPos.z() >= CEILING))
-						birdBody->body->setLocalPos(cVector3d(newPos.x(), 0, CEILING));
-					else if ((newPos.z() <= FLOOR))
-						birdBody->body->setLocalPos(cVector3d(newPos.x(), 0, FLOOR));
-				}
+				const LevelModel* pipes = ((endlessMode ? 0 : simState.firstActivePipe / 2) < level.getPipeCount()) ? &level : NULL;
+				hitPipe = birdBody->integrate(acceleration, delta_t, physicsSubsteps, FLOOR, CEILING, pipes);
 			}
+			integrationScope.end();
 
 			
 			
 			//////////////////////////////////////////////////////////////////
 			// APPLY ROTATION ON WINGS
 			//////////////////////////////////////////////////////////////////
+			ProfileScope rotationScope(tickProfiler, PROFILE_WING_ROTATION);
 			double wingAngle;
 			cVector3d resultant;
 		
@@ -1130,56 +1660,56 @@ void updateHaptics(void)
 				wingAngle = cAngle(resultant, birdBody->m_rightWing->m_initialPos);
 				if (position[0].z() < 0.0) wingAngle = -wingAngle;
 
-				birdBody->rightWing->setLocalRot(cMatrix3d(1.0, 0.0, 0.0, wingAngle * angleMultiplier));
-				birdBody->leftWing->setLocalRot(cMatrix3d(1.0, 0.0, 0.0, -wingAngle * angleMultiplier));
+				simState.rightWingAngle = wingAngle * angleMultiplier;
+				simState.leftWingAngle = -wingAngle * angleMultiplier;
 				break;
-			case 2:
+			default:
 				// right wing
 				resultant = birdBody->m_rightWing->m_initialPos + position[0]; // only need to get one
 				wingAngle = cAngle(resultant, birdBody->m_rightWing->m_initialPos);
 				if (position[0].z() < 0.0) wingAngle = -wingAngle;
-				birdBody->rightWing->setLocalRot(cMatrix3d(1.0, 0.0, 0.0, wingAngle * angleMultiplier)); // apply transformation
+				simState.rightWingAngle = wingAngle * angleMultiplier; // apply transformation
 
 																										 // left wing
 				resultant = birdBody->m_leftWing->m_initialPos + position[1]; // only need to get one
 				wingAngle = cAngle(resultant, birdBody->m_leftWing->m_initialPos);
 				if (position[1].z() < 0.0) wingAngle = -wingAngle;
-				birdBody->leftWing->setLocalRot(cMatrix3d(1.0, 0.0, 0.0, -wingAngle * angleMultiplier)); // apply transformation
+				simState.leftWingAngle = -wingAngle * angleMultiplier; // apply transformation
 				break;
 			}
+			rotationScope.end();
 			
 			
 			
 			///////////////////////////////////////////////////////////////
 			// collision detection
 			///////////////////////////////////////////////////////////////
-			if (currentLevel->size() >= 2) {
-				
-				if (birdBody->collisionDetector(currentLevel->at(0))) {
-					collisionDetected = true;
-				} else if (birdBody->collisionDetector(currentLevel->at(1))) {
+			// the next pair of pipes, the endless track drops pairs as soon as they are passed
+			ProfileScope collisionScope(tickProfiler, PROFILE_COLLISION);
+			unsigned int nextPipe = endlessMode ? 0 : simState.firstActivePipe / 2;
+
+			if (nextPipe < level.getPipeCount()) {
+				PipePair pipe = level.getPipe(nextPipe);
+
+				if (collisionDetected || hitPipe) {
 					collisionDetected = true;
 				} else {
-					if ((birdBody->body->getLocalPos().x() - currentLevel->at(0)->getLocalPos().x() - currentLevel->at(0)->getBaseRadius() <= 0.0) &&
-						(birdBody->body->getLocalPos().x() - currentLevel->at(1)->getLocalPos().x() - currentLevel->at(1)->getBaseRadius() <= 0.0)) {
+					if (birdBody->m_position.x() - pipe.x - pipe.radius <= 0.0) {
 						if (!scoreUpdate) {
 							// update score
 							SCORE = SCORE + 20; // increment by 20 points
-							scoreLabel->setText("SCORE: " + cStr(SCORE)); // update score label
 							scoreUpdate = !scoreUpdate;
 						}
 						
 					}
 
 					// check if we moved beyond the pipe
-					if ((birdBody->body->getLocalPos().x() - currentLevel->at(0)->getLocalPos().x() - currentLevel->at(0)->getBaseRadius() <= -1.0) &&
-						(birdBody->body->getLocalPos().x() - currentLevel->at(1)->getLocalPos().x() - currentLevel->at(1)->getBaseRadius() <= -1.0)) {
+					if (birdBody->m_position.x() - pipe.x - pipe.radius <= -1.0) {
 						
-						// remove pipes that we moved past
-						// remove children from the world and remove from array
-						world->removeChild(currentLevel->at(0));
-						world->removeChild(currentLevel->at(1));
-						currentLevel->erase(currentLevel->begin(), currentLevel->begin() + 2);
+						// move on to the next pair of pipes, the graphics thread removes the
+						// passed ones from the world when it picks up the snapshot
+						if (endlessMode) pipeTrack.popPipe();
+						else simState.firstActivePipe += 2;
 						scoreUpdate = !scoreUpdate;
 					}
 				}
@@ -1189,13 +1719,16 @@ void updateHaptics(void)
 				winState = true;
 				break;
 			}
+			collisionScope.end();
 
 
 			
 			/////////////////////////////////////////////////////////////////
 			// UPDATE CAMERA
 			/////////////////////////////////////////////////////////////////
-			updateCamera(cameraAngle, newPos);
+			ProfileScope cameraScope(tickProfiler, PROFILE_CAMERA);
+			updateCamera(cameraAngle, birdBody->m_position);
+			cameraScope.end();
 			
 
 			// update prev
@@ -1217,6 +1750,7 @@ void updateHaptics(void)
 			//////////////////////////////////////////////////////////////////////
 			// SEQUENCE FOR IF COLLISION DETECTED FROM BEFORE
 			//////////////////////////////////////////////////////////////////////
+			ProfileScope writeScope(tickProfiler, PROFILE_FORCE_WRITE);
 			switch (numHapticDevices) {
 			case 1:
 				if (collisionDetected) {
@@ -1237,13 +1771,13 @@ void updateHaptics(void)
 							break;
 						}
 					}
-					outputForce = -k * cVector3d(-targetX, 0.0, 0.0);
+					outputForce = k * targetX * birdBody->m_contactNormal; // push back the way the bird hit the pipe
 				} else {
 					outputForce = (Flift_right + Flift_left) / 2.0;
 				}
-				hapticDevice[0]->setForceAndTorqueAndGripperForce(outputForce, torque, gripperForce);
+				setDeviceForce(0, outputForce);
 				break;
-			case 2:
+			default:
 				if (collisionDetected) {
 					if (!beginCycle) startTime = gameClock.getCurrentTimeSeconds();
 
@@ -1262,15 +1796,14 @@ void updateHaptics(void)
 							break;
 						}
 					}
-					outputForceR = -k * cVector3d(-targetX, 0.0, 0.0);
-					outputForceL = -k * cVector3d(-targetX, 0.0, 0.0);
+					outputForceR = k * targetX * birdBody->m_contactNormal; // push back the way the bird hit the pipe
+					outputForceL = k * targetX * birdBody->m_contactNormal;
 				}
 				else {
 					outputForceR = Flift_right;
 					outputForceL = Flift_left;
 				}
-				hapticDevice[0]->setForceAndTorqueAndGripperForce(outputForceR, torque, gripperForce);
-				hapticDevice[1]->setForceAndTorqueAndGripperForce(outputForceL, torque, gripperForce);
+				setWingForces(outputForceR, outputForceL);
 				break;
 			}
 			break;
@@ -1278,18 +1811,15 @@ void updateHaptics(void)
 		case PAUSE: {
 			// apply boundary force but nothing more
 			birdBody->controllerStartup(position[0], position[1], 1.0, 1.0);
-			hapticDevice[0]->setForceAndTorqueAndGripperForce(birdBody->m_rightWing->m_F_net, torque, gripperForce);
-			hapticDevice[1]->setForceAndTorqueAndGripperForce(birdBody->m_leftWing->m_F_net, torque, gripperForce);
+			setWingForces(birdBody->m_rightWing->m_F_net, birdBody->m_leftWing->m_F_net);
 
-			showpauseMenu();
 			pauseMenuOptions(rightButtonValues, leftButtonValues, prev, current, delta_t);
 			break;
 		}
 		case GAME_OVER:{
 			// apply boundary force but nothing more
 			birdBody->controllerStartup(position[0], position[1], 1.0, 1.0);
-			hapticDevice[0]->setForceAndTorqueAndGripperForce(birdBody->m_rightWing->m_F_net, torque, gripperForce);
-			hapticDevice[1]->setForceAndTorqueAndGripperForce(birdBody->m_leftWing->m_F_net, torque, gripperForce);
+			setWingForces(birdBody->m_rightWing->m_F_net, birdBody->m_leftWing->m_F_net);
 
 			endGameOptions(rightButtonValues, leftButtonValues, prev, current, delta_t);
 			break;
@@ -1299,6 +1829,40 @@ void updateHaptics(void)
 	
         // signal frequency counter
         freqCounterHaptics.signal(1);
+
+		// in headless mode a finished level is recorded and the next one started right away
+		if (headless && (gameState == GAME_OVER)) {
+			finishHeadlessLevel();
+			if (!startHeadlessLevel()) simulationRunning = false;
+		}
+
+		// a headless replay ends with its log
+		if (headless && replayLog.isOpen() && replayDevice[0]->isFinished()) {
+			simulationRunning = false;
+		}
+
+		// write the forces of this tick to every device at once
+		if (deviceIO.isRunning()) {
+			ProfileScope commitScope(tickProfiler, PROFILE_FORCE_WRITE);
+			deviceIO.commit();
+		}
+
+		// tell the graphics thread what changed on screen, then hand it the state of this tick
+		postUiChanges();
+		if (endlessMode) {
+			for (unsigned int i = 0; i < PIPE_TRACK_CAPACITY; i++) simState.trackPipes[i] = pipeTrack.getPipeRing()[i];
+			simState.trackSettings = pipeTrack.getPipeSettings();
+			simState.trackFirstPipe = pipeTrack.getFirstPipe();
+			simState.trackPipeCount = pipeTrack.getPipeCount();
+		}
+		simState.tick = hapticScheduler.getTickCount();
+		simState.publishTime = HapticScheduler::now();
+		simState.period = hapticScheduler.getPeriod();
+		simState.birdPos = birdBody->m_position;
+		snapshotBuffer.publish(simState);
+
+		// sleep until the next tick of the fixed rate loop
+		hapticScheduler.waitForNextTick();
     }
     
     // exit haptics thread
@@ -1308,12 +1872,254 @@ void updateHaptics(void)
 //------------------------------------------------------------------------------
 
 
+///////////////////////////////////////////////////////// HEADLESS MODE FUNCTIONS //////////////////////////////////////////////////////////
+
+/**
+ * To run the game without a window. Levels are played back to back by the scripted devices with the
+ * haptic loop running as fast as it can in virtual time, then a summary is printed.
+ */
+void runHeadless() {
+	hapticScheduler.setRealTime(false);
+
+	cPrecisionClock wallClock;
+	wallClock.start(true);
+
+	if (startHeadlessLevel()) {
+		updateHaptics(); // returns once the last level has finished
+	}
+	else {
+		simulationFinished = true;
+	}
+
+	double wallTime = wallClock.stop();
+	double simTime = hapticScheduler.getTickCount() * hapticScheduler.getPeriod();
+
+	cout << endl;
+	cout << "headless run: " << headlessPlayed << " levels, " << headlessWins << " won, average score "
+		 << (headlessPlayed > 0 ? (double)headlessScore / headlessPlayed : 0.0) << endl;
+	cout << "simulated " << simTime << " s in " << wallTime << " s ("
+		 << (wallTime > 0.0 ? simTime / wallTime : 0.0) << "x real time, "
+		 << (wallTime > 0.0 ? 60.0 * headlessPlayed / wallTime : 0.0) << " levels per minute)" << endl;
+}
+
+
+/**
+ * To generate and start the next headless level. Returns false once all levels have been played.
+ */
+bool startHeadlessLevel() {
+	if (headlessPlayed >= headlessLevels) return false;
+
+	unsigned int difficulty = headlessDifficulty != 0 ? headlessDifficulty : (headlessPlayed % 3) + 1;
+
+	// every run gets a freshly generated level
+	switch (difficulty) {
+	case LEVEL_1:
+		pipeGenerator(lvl1, &lvl1Model, &lvl1Random, 1);
+		turbulenceGenerator(&lvl1Model, &lvl1Random, 1);
+		break;
+	case LEVEL_2:
+		pipeGenerator(lvl2, &lvl2Model, &lvl2Random, 2);
+		turbulenceGenerator(&lvl2Model, &lvl2Random, 2);
+		break;
+	case LEVEL_3:
+		pipeGenerator(lvl3, &lvl3Model, &lvl3Random, 3);
+		turbulenceGenerator(&lvl3Model, &lvl3Random, 3);
+		break;
+	}
+
+	levelFlag = (LEVEL)difficulty;
+	setLevel(levelFlag);
+	gameState = PLAY;
+
+	headlessLevelStart = hapticScheduler.getTickCount();
+	return true;
+}
+
+
+/**
+ * To record the result of the headless level that just ended and clean it up.
+ */
+void finishHeadlessLevel() {
+	double levelTime = (hapticScheduler.getTickCount() - headlessLevelStart) * hapticScheduler.getPeriod();
+
+	cout << "level " << headlessPlayed + 1 << ": difficulty " << levelFlag << ", " << (winState ? "won" : "lost")
+		 << ", score " << SCORE << ", " << levelTime << " s" << endl;
+
+	headlessPlayed++;
+	if (winState) headlessWins++;
+	headlessScore += SCORE;
+
+	cleanLevel();
+	winState = false;
+	loseState = false;
+}
+
+
+/**
+ * To set up a virtual Falcon listed by the device handler. It runs on the virtual time of the haptic
+ * loop and is held by a simulated hand following the motion chosen with --hand.
+ */
+void setupVirtualFalcon(cVirtualFalconDevicePtr a_falcon, int a_index) {
+	a_falcon->setClock([]() { return hapticScheduler.getTickCount() * hapticScheduler.getPeriod(); });
+
+	if (handTrajectory == "noise") a_falcon->setHandTrajectory(cNoiseHandTrajectory::create(cVector3d(0.01, 0.01, 0.03), 4.0, a_index + 1));
+	else if (handLog.isOpen()) a_falcon->setHandTrajectory(LogTrajectory::create(&handLog, a_index));
+	else a_falcon->setHandTrajectory(cSineHandTrajectory::create());
+}
+
+
+/**
+ * To send a force to one device. With parallel device I/O the force is queued for the I/O thread of
+ * the device and written when the tick is committed.
+ */
+void setDeviceForce(int a_device, const cVector3d& a_force) {
+	if ((a_device < 0) || (a_device >= numHapticDevices)) return;
+
+	if (deviceIO.isRunning()) deviceIO.setForce(a_device, a_force, cVector3d(0, 0, 0), 0.0);
+	else hapticDevice[a_device]->setForceAndTorqueAndGripperForce(a_force, cVector3d(0, 0, 0), 0.0);
+}
+
+
+/**
+ * To send the force of the right wing to the even devices and the force of the left wing to the
+ * odd ones.
+ */
+void setWingForces(const cVector3d& a_right, const cVector3d& a_left) {
+	for (int i = 0; i < numHapticDevices; i++) {
+		setDeviceForce(i, (i % 2 == 0) ? a_right : a_left);
+	}
+}
+
+
+/**
+ * To print how long the forces of every device took to follow the positions they were computed from.
+ * Safe to call while the haptic loop is running.
+ */
+void printLatency() {
+	for (int i = 0; i < numHapticDevices; i++) {
+		cout << "device " << i << " sense-to-actuate latency: ";
+		hapticDevice[i]->getLatencyHistogram().print(cout);
+		cout << endl;
+	}
+}
+
+
+/**
+ * To start loading the bird, the background and the three levels on the worker threads. Each
+ * load only fills objects that nothing else touches until its future is ready.
+ */
+void loadAssets() {
+	birdBody->body = new cMultiMesh();
+	birdBody->leftWing = new cMultiMesh();
+	birdBody->rightWing = new cMultiMesh();
+	backgroundImage = cImage::create();
+
+	// the first start parses the OBJ files and writes birdBody.obj.cmesh and so on, later starts map
+	// those in as long as the OBJ files are unchanged
+	g_objLoaderShouldUseCache = meshCache;
+
+	unsigned int threads = (loadThreads < 0) ? cMax(thread::hardware_concurrency(), 1u) : (unsigned int)loadThreads;
+	assetLoader.setProgressCallback(printLoadProgress);
+	assetLoader.start(threads);
+
+	birdBodyLoaded = assetLoader.load("birdBody.obj", [] { return loadModel(birdBody->body, "birdBody.obj"); });
+	leftWingLoaded = assetLoader.load("leftWing.obj", [] { return loadModel(birdBody->leftWing, "leftWing.obj"); });
+	rightWingLoaded = assetLoader.load("rightWing.obj", [] { return loadModel(birdBody->rightWing, "rightWing.obj"); });
+	backgroundLoaded = assetLoader.load("background.jpg", [] { return backgroundImage->loadFromFile("background.jpg"); });
+
+	// every level has its own random stream, so they can be generated at the same time
+	levelsLoaded[0] = assetLoader.load("level 1", [] {
+		pipeGenerator(lvl1, &lvl1Model, &lvl1Random, 1);
+		turbulenceGenerator(&lvl1Model, &lvl1Random, 1);
+		return true;
+	});
+	levelsLoaded[1] = assetLoader.load("level 2", [] {
+		pipeGenerator(lvl2, &lvl2Model, &lvl2Random, 2);
+		turbulenceGenerator(&lvl2Model, &lvl2Random, 2);
+		return true;
+	});
+	levelsLoaded[2] = assetLoader.load("level 3", [] {
+		pipeGenerator(lvl3, &lvl3Model, &lvl3Random, 3);
+		turbulenceGenerator(&lvl3Model, &lvl3Random, 3);
+		return true;
+	});
+}
+
+
+/**
+ * To load a model and, unless turned off, weld its identical vertices and reorder its triangles and
+ * vertices for the vertex cache, printing the vertex count and cache miss ratio before and after.
+ * Runs on the loader threads.
+ */
+bool loadModel(cMultiMesh* a_model, const string& a_filename) {
+	if (!a_model->loadFromFile(a_filename)) return false;
+	if (!meshOptimize) return true;
+
+	cMeshOptimizationReport report = a_model->optimize();
+
+	// one string, so lines of models optimized at the same time do not mix
+	ostringstream line;
+	line << fixed << setprecision(3) << "optimized " << a_filename << ": " << report.m_numVerticesBefore << " -> "
+		<< report.m_numVerticesAfter << " vertices, ACMR " << report.m_acmrBefore << " -> " << report.m_acmrAfter << endl;
+	cout << line.str();
+	return true;
+}
+
+
+/**
+ * To put the loaded bird in the world, shown if a level is already on screen. Graphics thread only.
+ */
+void attachBird() {
+	// create bird object
+	birdBody->body->setUseTransparency(false);
+	birdBody->body->setLocalPos(0.0, 0.0, 0.0);
+
+	// create wings
+	birdBody->leftWing->setUseTransparency(false);
+	birdBody->leftWing->setLocalPos(0, -0.002, 0.002); // relative to the bird body
+	birdBody->rightWing->setUseTransparency(false);
+	birdBody->rightWing->setLocalPos(0, 0.002, 0.002); // relative to the bird body
+
+	// parent wings and body
+	birdBody->body->addChild(birdBody->rightWing);
+	birdBody->body->addChild(birdBody->leftWing);
+	birdBody->body->setEnabled(levelShown, true);
+	birdBody->body->setShowEnabled(levelShown, true);
+	world->addChild(birdBody->body);
+
+	// set the birds colour
+	cMaterialPtr birdColour = birdBody->body->m_material;
+	birdColour->setBlue();
+	birdBody->body->setMaterial(birdColour, true);
+
+	// draw the bird from interleaved vertex buffers, unless the context has no shaders
+	if (!headless) {
+		cShaderProgramPtr birdShader = createBirdShader();
+		if (birdShader != nullptr) {
+			setInterleavedRendering(birdBody->body, birdShader);
+			setInterleavedRendering(birdBody->leftWing, birdShader);
+			setInterleavedRendering(birdBody->rightWing, birdShader);
+		}
+	}
+
+	birdAttached = true;
+}
+
+
+/**
+ * To print each asset as it finishes loading. Called from the loader threads, one at a time.
+ */
+void printLoadProgress(unsigned int a_done, unsigned int a_total, const string& a_name, bool a_success) {
+	cout << (a_success ? "loaded " : "failed to load ") << a_name << " (" << a_done << "/" << a_total << ")" << endl;
+}
+
+
+
 ////////////////////////////////////////////////////// MAIN GAME LOOP HELPER FUNCTIONS //////////////////////////////////////////////////
 void mainMenuOptions(bool r_val[], bool l_val[]) {
 	if (l_val[0] || r_val[0]) { // center button
 		switch (menuState) {
 		case (M_START):
-			cleanTitle();
 			gameState = LEVEL_SELECT;
 			break;
 		case (M_QUIT):
@@ -1326,13 +2132,9 @@ void mainMenuOptions(bool r_val[], bool l_val[]) {
 	 // iterate downwards in menu
 		switch (menuState) {
 		case M_START:
-			titleMenu_start->m_fontColor.setWhite();
-			titleMenu_quit->m_fontColor.setRed();
 			menuState = M_QUIT;
 			break;
 		case M_QUIT:
-			titleMenu_start->m_fontColor.setRed();
-			titleMenu_quit->m_fontColor.setWhite();
 			menuState = M_START;
 			break;
 		}
@@ -1341,13 +2143,9 @@ void mainMenuOptions(bool r_val[], bool l_val[]) {
 	 // iterate upwards in menu
 		switch (menuState) { // change based on where we just were
 		case M_START:
-			titleMenu_start->m_fontColor.setWhite();
-			titleMenu_quit->m_fontColor.setRed();
 			menuState = M_QUIT;
 			break;
 		case M_QUIT:
-			titleMenu_start->m_fontColor.setRed();
-			titleMenu_quit->m_fontColor.setWhite();
 			menuState = M_START;
 			break;
 		}
@@ -1359,25 +2157,24 @@ void levelSelectOptions(bool r_val[], bool l_val[]) {
 	if (l_val[0] || r_val[0]) { // center button
 		switch (levelSelectState) {
 		case (L_EASY):
-			cleanlevelMenu();
 			setLevel(LEVEL_1);
 			levelFlag = LEVEL_1;
 			gameState = PLAY;
 			break;
 		case (L_MEDIUM):
-			cleanlevelMenu();
+			levelSelectState = L_EASY;
 			setLevel(LEVEL_2);
 			levelFlag = LEVEL_2;
 			gameState = PLAY;
 			break;
 		case (L_HARD):
-			cleanlevelMenu();
+			levelSelectState = L_EASY;
 			setLevel(LEVEL_3);
 			levelFlag = LEVEL_3;
 			gameState = PLAY;
 			break;
 		case (L_BACK):
-			cleanlevelMenu();
+			levelSelectState = L_EASY;
 			gameState = MENU;
 			break;
 		}
@@ -1387,31 +2184,15 @@ void levelSelectOptions(bool r_val[], bool l_val[]) {
 
 		switch (levelSelectState) {
 		case L_EASY:
-			levelMenu_1->m_fontColor.setWhite();
-			levelMenu_2->m_fontColor.setWhite();
-			levelMenu_3->m_fontColor.setWhite();
-			levelMenu_back->m_fontColor.setRed();
 			levelSelectState = L_BACK;
 			break;
 		case L_MEDIUM:
-			levelMenu_1->m_fontColor.setRed();
-			levelMenu_2->m_fontColor.setWhite();
-			levelMenu_3->m_fontColor.setWhite();
-			levelMenu_back->m_fontColor.setWhite();
 			levelSelectState = L_EASY;
 			break;
 		case L_HARD:
-			levelMenu_1->m_fontColor.setWhite();
-			levelMenu_2->m_fontColor.setRed();
-			levelMenu_3->m_fontColor.setWhite();
-			levelMenu_back->m_fontColor.setWhite();
 			levelSelectState = L_MEDIUM;
 			break;
 		case L_BACK:
-			levelMenu_1->m_fontColor.setWhite();
-			levelMenu_2->m_fontColor.setWhite();
-			levelMenu_3->m_fontColor.setRed();
-			levelMenu_back->m_fontColor.setWhite();
 			levelSelectState = L_HARD;
 			break;
 		}
@@ -1420,31 +2201,15 @@ void levelSelectOptions(bool r_val[], bool l_val[]) {
 	 // iterate upwards in menu
 		switch (levelSelectState) {
 		case L_EASY:
-			levelMenu_1->m_fontColor.setWhite();
-			levelMenu_2->m_fontColor.setRed();
-			levelMenu_3->m_fontColor.setWhite();
-			levelMenu_back->m_fontColor.setWhite();
 			levelSelectState = L_MEDIUM;
 			break;
 		case L_MEDIUM:
-			levelMenu_1->m_fontColor.setWhite();
-			levelMenu_2->m_fontColor.setWhite();
-			levelMenu_3->m_fontColor.setRed();
-			levelMenu_back->m_fontColor.setWhite();
 			levelSelectState = L_HARD;
 			break;
 		case L_HARD:
-			levelMenu_1->m_fontColor.setWhite();
-			levelMenu_2->m_fontColor.setWhite();
-			levelMenu_3->m_fontColor.setWhite();
-			levelMenu_back->m_fontColor.setRed();
 			levelSelectState = L_BACK;
 			break;
 		case L_BACK:
-			levelMenu_1->m_fontColor.setRed();
-			levelMenu_2->m_fontColor.setWhite();
-			levelMenu_3->m_fontColor.setWhite();
-			levelMenu_back->m_fontColor.setWhite();
 			levelSelectState = L_EASY;
 			break;
 		}
@@ -1454,13 +2219,13 @@ void pauseMenuOptions(bool r_val[], bool l_val[], double &a_prev, double &a_curr
 	if (l_val[0] || r_val[0]) { // center button										// refactor
 		switch (pauseState) {
 		case (P_RESUME):
-			cleanPause();
+			pauseState = P_RESUME;
 			gameClock.start(); // start clock back up 
 			gameState = PLAY; // continue playing
 			break;
 		case (P_RESTART):
 			//put restart code
-			cleanPause();
+			pauseState = P_RESUME;
 			cleanLevel();
 			setLevel(levelFlag);
 			gameClock.reset(); // reste the clock for good measure
@@ -1469,14 +2234,13 @@ void pauseMenuOptions(bool r_val[], bool l_val[], double &a_prev, double &a_curr
 			break;
 		case (P_QUIT):
 			cleanLevel(); // remove all level elements, clean up memory
-			cleanPause();
+			pauseState = P_RESUME;
 			gameClock.reset(); // reste the clock for good measure
 			resetClockVars(a_prev, a_current, a_delta_t);
 			gameState = MENU;
 
 			// reset device forces to 0
-			hapticDevice[0]->setForceAndTorqueAndGripperForce(cVector3d(0, 0, 0), cVector3d(0, 0, 0), 0.0);
-			hapticDevice[1]->setForceAndTorqueAndGripperForce(cVector3d(0, 0, 0), cVector3d(0, 0, 0), 0.0);
+			setWingForces(cVector3d(0, 0, 0), cVector3d(0, 0, 0));
 			break;
 		}
 	}
@@ -1484,21 +2248,12 @@ void pauseMenuOptions(bool r_val[], bool l_val[], double &a_prev, double &a_curr
 	   // iterate downwards in menu
 		switch (pauseState) {
 		case P_RESUME:
-			pauseMenu_resume->m_fontColor.setWhite();
-			pauseMenu_restart->m_fontColor.setWhite();
-			pauseMenu_quit->m_fontColor.setRed();
 			pauseState = P_QUIT;
 			break;
 		case P_RESTART:
-			pauseMenu_resume->m_fontColor.setRed();
-			pauseMenu_restart->m_fontColor.setWhite();
-			pauseMenu_quit->m_fontColor.setWhite();
 			pauseState = P_RESUME;
 			break;
 		case P_QUIT:
-			pauseMenu_resume->m_fontColor.setWhite();
-			pauseMenu_restart->m_fontColor.setRed();
-			pauseMenu_quit->m_fontColor.setWhite();
 			pauseState = P_RESTART;
 			break;
 		}
@@ -1507,21 +2262,12 @@ void pauseMenuOptions(bool r_val[], bool l_val[], double &a_prev, double &a_curr
 	   // iterate upwards in menu
 		switch (pauseState) {
 		case P_RESUME:
-			pauseMenu_resume->m_fontColor.setWhite();
-			pauseMenu_restart->m_fontColor.setRed();
-			pauseMenu_quit->m_fontColor.setWhite();
 			pauseState = P_RESTART;
 			break;
 		case P_RESTART:
-			pauseMenu_resume->m_fontColor.setWhite();
-			pauseMenu_restart->m_fontColor.setWhite();
-			pauseMenu_quit->m_fontColor.setRed();
 			pauseState = P_QUIT;
 			break;
 		case P_QUIT:
-			pauseMenu_resume->m_fontColor.setRed();
-			pauseMenu_restart->m_fontColor.setWhite();
-			pauseMenu_quit->m_fontColor.setWhite();
 			pauseState = P_RESUME;
 			break;
 		}
@@ -1537,7 +2283,7 @@ void playOptions(bool r_val[], bool l_val[], double &a_prev, double &a_current,
 	}
 	else if (l_val[2] || r_val[2]) { // front button
 		// restart the level
-		cleanPause();
+		pauseState = P_RESUME;
 		cleanLevel();
 		setLevel(levelFlag);																
 		gameClock.reset(); // reste the clock for good measure
@@ -1573,20 +2319,12 @@ void playOptions(bool r_val[], bool l_val[], double &a_prev, double &a_current,
 	}
 }
 void endGameOptions(bool r_val[], bool l_val[], double &a_prev, double &a_current, double &a_delta_t) {
-	if (winState) {
-		showwinMenu();
-	}
-	else if (loseState) {
-		showgameoverMenu();
-	}
 	// check to see if any button is pressed
 	if ((l_val[0] || r_val[0]) ||
 		(l_val[1] || r_val[1]) ||
 		(l_val[2] || r_val[2]) ||
 		(l_val[3] || r_val[3])) { // center button
 
-		if (winState) cleanwinMenu();
-		else if (loseState) cleangameoverMenu();
 		cleanLevel(); // remove all level elements, clean up memory
 
 		gameClock.reset(); // reste the clock for good measure
@@ -1596,8 +2334,7 @@ void endGameOptions(bool r_val[], bool l_val[], double &a_prev, double &a_curren
 		gameState = MENU;
 
 		// reset device forces to 0
-		hapticDevice[0]->setForceAndTorqueAndGripperForce(cVector3d(0, 0, 0), cVector3d(0, 0, 0), 0.0);
-		hapticDevice[1]->setForceAndTorqueAndGripperForce(cVector3d(0, 0, 0), cVector3d(0, 0, 0), 0.0);
+		setWingForces(cVector3d(0, 0, 0), cVector3d(0, 0, 0));
 	}
 }
 
@@ -1644,138 +2381,160 @@ bool isPressed(bool btn, bool &firstContact) {
 ///////////////////////////////////////////////////////// LEVEL GENERATION FUNCTIONS //////////////////////////////////////////////////////
 
 /**
- * Randomly generate the locations and sizes of the pipes and store them
+ * Randomly generate the locations and sizes of the pipes and store them in the level and as pipe
+ * instances to draw, drawn from the stream of the level
  */
-void pipeGenerator(vector<cShapeCylinder*> *a_pipes, unsigned int a_difficulty) {
+void pipeGenerator(vector<PipeInstance> *a_pipes, LevelModel *a_level, LevelRandom *a_random, unsigned int a_difficulty) {
 	a_pipes->clear(); // make sure pipes array is empty
 
-	
-
-	double pipeExtension = 1.0;
-
-	double minGap;
-	double maxGap;
-	double minDistance;
-	double maxDistance;
-	double numberOfPipes;
+	cColorf pipeColour;
+	pipeColour.setGreenLight();
 
-	switch (a_difficulty) {
-	case 1:
-		minGap = 0.14;
-		maxGap = 0.18;
-		minDistance = 1.2;
-		maxDistance = 2.2;
-		numberOfPipes = 20;
-		break;
-	case 2:
-		minGap = 0.10;
-		maxGap = 0.12;
-		minDistance = 1.2;
-		maxDistance = 2.0;
-		numberOfPipes = 30;
-		break;
-	case 3:
-		minGap = 0.09;
-		maxGap = 0.11;
-		minDistance = 1.2;
-		maxDistance = 1.8;
-		numberOfPipes = 40;
-		break;
-	}
+	PipeSettings settings = getPipeSettings(a_difficulty);
+	a_level->reset(settings);
 
-	cVector3d position(-1.0, 0, 0); // give meter offset
+	double lastX = -1.0; // give meter offset
 
-	for (unsigned int i = 0; i < numberOfPipes; i++) {
-		double distance = ( (rand() % 101 / 100.0) * (maxDistance - minDistance) ) + minDistance;
-		position = cVector3d(position.x() - distance, 0, 0); // update current pipe position placement
+	for (unsigned int i = 0; i < settings.numberOfPipes; i++) {
+		PipePair pair = PipeTrack::generatePipe(settings, lastX, *a_random);
+		lastX = pair.x;
+		a_level->addPipe(pair);
 
-		// calculate gap size to be used to determine placement
-		double gapSize = ((rand() % 101 / 100.0) * (maxGap - minGap)) + minGap; //
+		cVector3d topPos, bottomPos;
+		double topHeight, bottomHeight;
+		a_level->getPipeGeometry(i, topPos, topHeight, bottomPos, bottomHeight);
 
-		// get gap position and move into relation of FLOOR and CEILING
-		double gapPosition = ( (((rand() % 100 + 1) / 100.0) * (CEILING - FLOOR - gapSize) ) + FLOOR + gapSize / 2.0); // ensure no pipe is of height 0
-		
 		// create pipes
-		cShapeCylinder *topPipe = new cShapeCylinder(pipeRadius, pipeRadius, (CEILING - gapPosition) - (gapSize / 2.0) + pipeExtension);
-		topPipe->setLocalPos(cVector3d(position.x(), 0, CEILING - topPipe->getHeight() + pipeExtension)); // set the top pipes position 
-		
-		cShapeCylinder *bottomPipe = new cShapeCylinder(pipeRadius, pipeRadius, (gapPosition - FLOOR) - (gapSize / 2.0) + pipeExtension);
-		bottomPipe->setLocalPos(cVector3d(position.x(), 0, FLOOR - pipeExtension)); // set the bottom pipe position  
-
-		topPipe->m_material->setGreenLight();
-		bottomPipe->m_material->setGreenLight();
-		
-		a_pipes->push_back(topPipe);
-		a_pipes->push_back(bottomPipe);
+		a_pipes->push_back(PipeRenderer::makePipe(topPos, pipeRadius, topHeight, pipeColour));
+		a_pipes->push_back(PipeRenderer::makePipe(bottomPos, pipeRadius, bottomHeight, pipeColour));
 	}
-
+	a_level->buildIndex();
 }
 
 
 /**
- * Randomly generate the turbulence values and store them in the level arrays for turbulence.
+ * Randomly generate the turbulence values and add them to a level freshly generated by pipeGenerator.
  */
-void turbulenceGenerator(vector<turbulence*> *a_turbulence, double a_lastX, unsigned int a_difficulty) {
-	a_turbulence->clear(); // make sure pipes array is empty
+void turbulenceGenerator(LevelModel *a_level, LevelRandom *a_random, unsigned int a_difficulty) {
+	// turbulence is spread up to the last pipe
+	double lastX = (a_level->getPipeCount() > 0) ? a_level->getPipe(a_level->getPipeCount() - 1).x : 0.0;
+
+	TurbulenceSettings settings = getTurbulenceSettings(a_difficulty);
 
 	// how long turblence runs for
-	double minLength; 
-	double maxLength;
+	double minLength = settings.minLength; 
+	double maxLength = settings.maxLength;
 	// how often turbulence happens
-	double minDistance;
+	double minDistance = settings.minDistance;
 	double maxDistance;
-	unsigned int numTurbulence;
-	unsigned int period;
-	unsigned int amplitude;
+	unsigned int numTurbulence = settings.numTurbulence;
+	unsigned int period = settings.period;
+	unsigned int amplitude = settings.amplitude;
 	
-	// tweak values
-	switch (a_difficulty) {
-	case 1:
-		minLength = 1.0;
-		maxLength = 3.0;
-		numTurbulence = 3.0;
-		minDistance = 5.0;
-		period = 50;
-		amplitude = 5;
-		break;
-	case 2:
-		minLength = 3.0;
-		maxLength = 5.0;
-		numTurbulence = 6.0;
-		minDistance = 2.0;
-		period = 50; // TODO re-evaluate values
-		amplitude = 7.5; // TODO re-evaluate values
-		break;
-	case 3:
-		minLength = 5.0;
-		maxLength = 7.0;
-		numTurbulence = 9.0;
-		minDistance = 1.0;
-		period = 50; // TODO re-evaluate values
-		amplitude = 10; // TODO re-evaluate values
-		break;
-	}
-	maxDistance = a_lastX / (double)numTurbulence;
+	maxDistance = lastX / (double)numTurbulence;
 	cVector3d position(0, 0, 0);
 
 	for (unsigned int i = 0; i < numTurbulence; i++) {
-		if (position.x() <= a_lastX) {
+		if (position.x() <= lastX) {
 			break;
 		} else {
 			
 			// generate beginning value
-			double startTurbulence = ((rand() % 100 + 1) / 100.0) * (maxDistance - minDistance) + position.x();
+			double startTurbulence = ((a_random->nextInt(100) + 1) / 100.0) * (maxDistance - minDistance) + position.x();
 			
 			// generate ending value
-			double endTurbulence = startTurbulence - ((rand() % 100 + 1) / 100.0) * (maxLength - minLength);
+			double endTurbulence = startTurbulence - ((a_random->nextInt(100) + 1) / 100.0) * (maxLength - minLength);
 			position = cVector3d(endTurbulence, 0, 0);
 
-			turbulence *t = new turbulence{startTurbulence, endTurbulence, period, amplitude};
-			a_turbulence->push_back(t);
+			// bake the rumble of the region
+			TurbulenceWave wave;
+			wave.bake(period, amplitude, *a_random);
+			a_level->addTurbulence(turbulence{startTurbulence, endTurbulence, period, amplitude}, wave);
 
 		}
 	}
+	a_level->buildIndex();
+}
+
+
+/**
+ * Get the pipe layout of a difficulty.
+ */
+PipeSettings getPipeSettings(unsigned int a_difficulty) {
+	PipeSettings settings;
+	settings.radius = pipeRadius;
+	settings.ceiling = CEILING;
+	settings.floor = FLOOR;
+	settings.extension = pipeExtension;
+
+	switch (a_difficulty) {
+	case 1:
+	default:
+		settings.minGap = 0.14;
+		settings.maxGap = 0.18;
+		settings.minDistance = 1.2;
+		settings.maxDistance = 2.2;
+		settings.numberOfPipes = 20;
+		break;
+	case 2:
+		settings.minGap = 0.10;
+		settings.maxGap = 0.12;
+		settings.minDistance = 1.2;
+		settings.maxDistance = 2.0;
+		settings.numberOfPipes = 30;
+		break;
+	case 3:
+		settings.minGap = 0.09;
+		settings.maxGap = 0.11;
+		settings.minDistance = 1.2;
+		settings.maxDistance = 1.8;
+		settings.numberOfPipes = 40;
+		break;
+	}
+	return settings;
+}
+
+
+/**
+ * Get the turbulence layout of a difficulty.
+ */
+TurbulenceSettings getTurbulenceSettings(unsigned int a_difficulty) {
+	TurbulenceSettings settings;
 
+	// tweak values
+	switch (a_difficulty) {
+	case 1:
+	default:
+		settings.minLength = 1.0;
+		settings.maxLength = 3.0;
+		settings.numTurbulence = 3.0;
+		settings.minDistance = 5.0;
+		settings.period = 50;
+		settings.amplitude = 5;
+		break;
+	case 2:
+		settings.minLength = 3.0;
+		settings.maxLength = 5.0;
+		settings.numTurbulence = 6.0;
+		settings.minDistance = 2.0;
+		settings.period = 50; // TODO re-evaluate values
+		settings.amplitude = 7.5; // TODO re-evaluate values
+		break;
+	case 3:
+		settings.minLength = 5.0;
+		settings.maxLength = 7.0;
+		settings.numTurbulence = 9.0;
+		settings.minDistance = 1.0;
+		settings.period = 50; // TODO re-evaluate values
+		settings.amplitude = 10; // TODO re-evaluate values
+		break;
+	}
+
+	// the endless track spreads its regions like a level of average length
+	PipeSettings pipes = getPipeSettings(a_difficulty);
+	double levelLength = pipes.numberOfPipes * (pipes.minDistance + pipes.maxDistance) / 2.0;
+	settings.maxDistance = settings.minDistance + levelLength / settings.numTurbulence;
+	return settings;
 }
 
 
@@ -1787,19 +2546,12 @@ void turbulenceGenerator(vector<turbulence*> *a_turbulence, double a_lastX, unsi
  * Show the title menu elements
  */
 void showtitleMenu() {
-	if (!isInitialized) {
-		titleMenu->setEnabled(true);
-		titleMenu->setShowEnabled(true);
-		titleMenu_start->setEnabled(true);
-		titleMenu_start->setShowEnabled(true);
-		titleMenu_quit->setEnabled(true);
-		titleMenu_quit->setShowEnabled(true);
-		isInitialized = true;
-	}
-
-	titleMenu->setLocalPos((int)(0.5 * (width - titleMenu->getWidth())), (int)(0.5 * (height - titleMenu->getHeight())));
-	titleMenu_start->setLocalPos((int)(0.5 * (titleMenu->getWidth() - titleMenu_start->getWidth())), (int)(0.5 * (titleMenu->getHeight() - titleMenu_start->getHeight())) + (0.5 * titleMenu_start->getHeight()));
-	titleMenu_quit->setLocalPos((int)(0.5 * (titleMenu->getWidth() - titleMenu_quit->getWidth())), (int)(0.5 * (titleMenu->getHeight() - titleMenu_quit->getHeight())) - titleMenu_start->getHeight()); // translate down 20 pixels
+	titleMenu->setEnabled(true);
+	titleMenu->setShowEnabled(true);
+	titleMenu_start->setEnabled(true);
+	titleMenu_start->setShowEnabled(true);
+	titleMenu_quit->setEnabled(true);
+	titleMenu_quit->setShowEnabled(true);
 }
 
 
@@ -1813,14 +2565,6 @@ void cleanTitle() {
 	titleMenu_start->setShowEnabled(false);
 	titleMenu_quit->setEnabled(false);
 	titleMenu_quit->setShowEnabled(false);
-
-	// reset the colours
-	titleMenu_start->m_fontColor.setRed();
-	titleMenu_quit->m_fontColor.setWhite();
-
-	menuState = M_START;
-
-	isInitialized = false; // reset for game state to repopulate the game
 }
 
 
@@ -1828,28 +2572,18 @@ void cleanTitle() {
  * Show all menu elements
  */
 void showlevelMenu() {
-	if (!isInitialized) {
-		levelMenu->setEnabled(true);
-		levelMenu->setShowEnabled(true);
-		levelMenu_pick->setEnabled(true);
-		levelMenu_pick->setShowEnabled(true);
-		levelMenu_1->setEnabled(true);
-		levelMenu_1->setShowEnabled(true);
-		levelMenu_2->setEnabled(true);
-		levelMenu_2->setShowEnabled(true);
-		levelMenu_3->setEnabled(true);
-		levelMenu_3->setShowEnabled(true);
-		levelMenu_back->setEnabled(true);
-		levelMenu_back->setShowEnabled(true);
-		isInitialized = true;
-	}
-
-	levelMenu->setLocalPos((int)(0.5 * (width - levelMenu->getWidth())), (int)(0.5 * (height - levelMenu->getHeight())));
-	levelMenu_pick->setLocalPos((int)(0.5 * (levelMenu->getWidth() - levelMenu_pick->getWidth())), (int)(levelMenu->getHeight() - (1.5 * levelMenu_pick->getHeight())));
-	levelMenu_1->setLocalPos((int)(0.5 * (levelMenu->getWidth() - levelMenu_1->getWidth())), (int)(levelMenu_pick->getLocalPos().y() - (1.5 * levelMenu_1->getHeight())));
-	levelMenu_2->setLocalPos((int)(0.5 * (levelMenu->getWidth() - levelMenu_2->getWidth())), (int)(levelMenu_1->getLocalPos().y() - (1.5 * levelMenu_2->getHeight())));
-	levelMenu_3->setLocalPos((int)(0.5 * (levelMenu->getWidth() - levelMenu_3->getWidth())), (int)(levelMenu_2->getLocalPos().y() - (1.5 * levelMenu_3->getHeight())));
-	levelMenu_back->setLocalPos((int)(0.5 * (levelMenu->getWidth() - levelMenu_back->getWidth())), (int)(levelMenu_3->getLocalPos().y() - (1.5 * levelMenu_back->getHeight())));
+	levelMenu->setEnabled(true);
+	levelMenu->setShowEnabled(true);
+	levelMenu_pick->setEnabled(true);
+	levelMenu_pick->setShowEnabled(true);
+	levelMenu_1->setEnabled(true);
+	levelMenu_1->setShowEnabled(true);
+	levelMenu_2->setEnabled(true);
+	levelMenu_2->setShowEnabled(true);
+	levelMenu_3->setEnabled(true);
+	levelMenu_3->setShowEnabled(true);
+	levelMenu_back->setEnabled(true);
+	levelMenu_back->setShowEnabled(true);
 }
 
 
@@ -1869,16 +2603,6 @@ void cleanlevelMenu() {
 	levelMenu_3->setShowEnabled(false);
 	levelMenu_back->setEnabled(false);
 	levelMenu_back->setShowEnabled(false);
-
-	// reset the colours
-	levelMenu_1->m_fontColor.setRed();
-	levelMenu_2->m_fontColor.setWhite();
-	levelMenu_3->m_fontColor.setWhite();
-	levelMenu_back->m_fontColor.setWhite();
-
-	levelSelectState = L_EASY;
-
-	isInitialized = false;
 }
 
 
@@ -1886,18 +2610,10 @@ void cleanlevelMenu() {
  * show the menu elements for pausing 
  */
 void showpauseMenu() {
-	if (!isInitialized) {
-		pauseMenu->setEnabled(true);
-		pauseMenu_resume->setEnabled(true);
-		pauseMenu_restart->setEnabled(true);
-		pauseMenu_quit->setEnabled(true);
-		isInitialized = true;
-	}
-
-	pauseMenu->setLocalPos((int)(0.5 * (width - pauseMenu->getWidth())), (int)(0.5 * (height - pauseMenu->getHeight())));
-	pauseMenu_resume->setLocalPos((int)(0.5 * (pauseMenu->getWidth() - pauseMenu_resume->getWidth())), (int)(pauseMenu->getHeight() - ((1.0/4.0) * pauseMenu->getHeight())));
-	pauseMenu_restart->setLocalPos((int)(0.5 * (pauseMenu->getWidth() - pauseMenu_restart->getWidth())), (int)(pauseMenu->getHeight() - ((2.0 / 4.0) * pauseMenu->getHeight())));
-	pauseMenu_quit->setLocalPos((int)(0.5 * (pauseMenu->getWidth() - pauseMenu_quit->getWidth())), (int)(pauseMenu->getHeight() - ((3.0 / 4.0) * pauseMenu->getHeight())));
+	pauseMenu->setEnabled(true);
+	pauseMenu_resume->setEnabled(true);
+	pauseMenu_restart->setEnabled(true);
+	pauseMenu_quit->setEnabled(true);
 }
 
 
@@ -1909,52 +2625,18 @@ void cleanPause() {
 	pauseMenu_resume->setEnabled(false);
 	pauseMenu_restart->setEnabled(false);
 	pauseMenu_quit->setEnabled(false);
-
-	// reset the colours
-	pauseMenu_resume->m_fontColor.setRed();
-	pauseMenu_restart->m_fontColor.setWhite();
-	pauseMenu_quit->m_fontColor.setWhite();
-
-	pauseState = P_RESUME;
-
-	isInitialized = false;
 }
 
 /**
  * show the menu elements for losing
  */
 void showgameoverMenu() {
-	double transparency;
-	if (!isInitialized) {
-		gameoverMenu->setEnabled(true);
-		gameoverMenu->setShowEnabled(true);
-		loseMessage->setEnabled(true);
-		loseMessage->setShowEnabled(true);
-		keyagainLose->setEnabled(true);
-		keyagainLose->setEnabled(true);
-		transparency = 1.0;
-		isInitialized = true;
-	}
-
-	gameoverMenu->setLocalPos((int)(0.5 * (width - gameoverMenu->getWidth())), (int)(0.5 * (height - gameoverMenu->getHeight())));
-	loseMessage->setLocalPos((int)(0.5 * (gameoverMenu->getWidth() - loseMessage->getWidth())), (int)(gameoverMenu->getHeight() - ((1.0 / 3)*(gameoverMenu->getHeight()))));
-	keyagainLose->setLocalPos((int)(0.5 * (gameoverMenu->getWidth() - keyagainLose->getWidth())), (int)(gameoverMenu->getHeight() - ((2.0 / 3)*(gameoverMenu->getHeight()))));
-
-	bool hitMax;
-	bool hitMin;
-	if (transparency == 1.0) {
-		hitMax = true;
-		hitMin = false;
-	}
-	else if (transparency == 0.0) {
-		hitMax = false;
-		hitMin = true;
-	}
-	if (hitMax = true) transparency -= 0.01;
-	else if (hitMin == true) transparency += 0.01;
-
-	keyagainLose->setTransparencyLevel(transparency);
-
+	gameoverMenu->setEnabled(true);
+	gameoverMenu->setShowEnabled(true);
+	loseMessage->setEnabled(true);
+	loseMessage->setShowEnabled(true);
+	keyagainLose->setEnabled(true);
+	keyagainLose->setShowEnabled(true);
 }
 
 /**
@@ -1967,7 +2649,6 @@ void cleangameoverMenu() {
 	loseMessage->setShowEnabled(false);
 	keyagainLose->setEnabled(false);
 	keyagainLose->setShowEnabled(false);
-	isInitialized = false;
 }
 
 
@@ -1975,36 +2656,12 @@ void cleangameoverMenu() {
  * show the menu elements for winning
  */
 void showwinMenu() {
-	double transparency;
-	if (!isInitialized) {
-		winMenu->setEnabled(true);
-		winMenu->setShowEnabled(true);
-		winMessage->setEnabled(true);
-		winMessage->setShowEnabled(true);
-		keyagainWin->setEnabled(true);
-		keyagainWin->setShowEnabled(true);
-		transparency = 1.0;
-		isInitialized = true;
-	}
-
-	winMenu->setLocalPos((int)(0.5 * (width - winMenu->getWidth())), (int)(0.5 * (height - winMenu->getHeight())));
-	winMessage->setLocalPos((int)(0.5 * (winMenu->getWidth() - winMessage->getWidth())), (int)(winMenu->getHeight() - ((1.0 / 3)*(winMenu->getHeight()))));
-	keyagainWin->setLocalPos((int)(0.5 * (winMenu->getWidth() - keyagainWin->getWidth())), (int)(winMenu->getHeight() - ((2.0 / 3)*(winMenu->getHeight()))));
-
-	bool hitMax;
-	bool hitMin;
-	if (transparency == 1.0) {
-		hitMax = true;
-		hitMin = false;
-	}
-	else if (transparency == 0.0) {
-		hitMax = false;
-		hitMin = true;
-	}
-	if (hitMax = true) transparency -= 0.01;
-	else if (hitMin == true) transparency += 0.01;
-
-	keyagainWin->setTransparencyLevel(transparency);
+	winMenu->setEnabled(true);
+	winMenu->setShowEnabled(true);
+	winMessage->setEnabled(true);
+	winMessage->setShowEnabled(true);
+	keyagainWin->setEnabled(true);
+	keyagainWin->setShowEnabled(true);
 }
 
 /**
@@ -2017,98 +2674,281 @@ void cleanwinMenu() {
 	winMessage->setShowEnabled(false);
 	keyagainWin->setEnabled(false);
 	keyagainWin->setShowEnabled(false);
-	isInitialized = false;
 }
 
 
 /**
- * assigns the turbulence array and level pipes array to the current arrays for level playing
+ * To show the widgets of a screen. Graphics thread only.
  */
-void setLevel(int LEVEL) {
-	currentLevel = new vector<cShapeCylinder*>();
+void showScreen(UiScreen a_screen) {
+	switch (a_screen) {
+	case UI_TITLE: showtitleMenu(); break;
+	case UI_LEVEL_SELECT: showlevelMenu(); break;
+	case UI_PAUSE: showpauseMenu(); break;
+	case UI_LOSE: showgameoverMenu(); break;
+	case UI_WIN: showwinMenu(); break;
+	default: break; // the level itself is shown by showLevel()
+	}
+}
+
 
-	switch (LEVEL) {
+/**
+ * To hide the widgets of a screen. Graphics thread only.
+ */
+void cleanScreen(UiScreen a_screen) {
+	switch (a_screen) {
+	case UI_TITLE: cleanTitle(); break;
+	case UI_LEVEL_SELECT: cleanlevelMenu(); break;
+	case UI_PAUSE: cleanPause(); break;
+	case UI_LOSE: cleangameoverMenu(); break;
+	case UI_WIN: cleanwinMenu(); break;
+	default: break;
+	}
+}
+
+
+/**
+ * To colour the row of the menu on screen that is selected red and the others white.
+ */
+void colourMenu() {
+	cLabel* rows[4];
+	unsigned int count = 0;
+	switch (uiScreen) {
+	case UI_TITLE:
+		rows[count++] = titleMenu_start;
+		rows[count++] = titleMenu_quit;
+		break;
+	case UI_LEVEL_SELECT:
+		rows[count++] = levelMenu_1;
+		rows[count++] = levelMenu_2;
+		rows[count++] = levelMenu_3;
+		rows[count++] = levelMenu_back;
+		break;
+	case UI_PAUSE:
+		rows[count++] = pauseMenu_resume;
+		rows[count++] = pauseMenu_restart;
+		rows[count++] = pauseMenu_quit;
+		break;
+	default:
+		break;
+	}
+
+	for (unsigned int i = 0; i < count; i++) {
+		if (i == uiSelection) rows[i]->m_fontColor.setRed();
+		else rows[i]->m_fontColor.setWhite();
+	}
+}
+
+
+/**
+ * To place every panel in the middle of the window and every label on its panel. Only needed when
+ * the window size, a screen or a text changed.
+ */
+void layoutUi() {
+	titleMenu->setLocalPos((int)(0.5 * (width - titleMenu->getWidth())), (int)(0.5 * (height - titleMenu->getHeight())));
+	titleMenu_start->setLocalPos((int)(0.5 * (titleMenu->getWidth() - titleMenu_start->getWidth())), (int)(0.5 * (titleMenu->getHeight() - titleMenu_start->getHeight())) + (0.5 * titleMenu_start->getHeight()));
+	titleMenu_quit->setLocalPos((int)(0.5 * (titleMenu->getWidth() - titleMenu_quit->getWidth())), (int)(0.5 * (titleMenu->getHeight() - titleMenu_quit->getHeight())) - titleMenu_start->getHeight()); // translate down 20 pixels
+
+	levelMenu->setLocalPos((int)(0.5 * (width - levelMenu->getWidth())), (int)(0.5 * (height - levelMenu->getHeight())));
+	levelMenu_pick->setLocalPos((int)(0.5 * (levelMenu->getWidth() - levelMenu_pick->getWidth())), (int)(levelMenu->getHeight() - (1.5 * levelMenu_pick->getHeight())));
+	levelMenu_1->setLocalPos((int)(0.5 * (levelMenu->getWidth() - levelMenu_1->getWidth())), (int)(levelMenu_pick->getLocalPos().y() - (1.5 * levelMenu_1->getHeight())));
+	levelMenu_2->setLocalPos((int)(0.5 * (levelMenu->getWidth() - levelMenu_2->getWidth())), (int)(levelMenu_1->getLocalPos().y() - (1.5 * levelMenu_2->getHeight())));
+	levelMenu_3->setLocalPos((int)(0.5 * (levelMenu->getWidth() - levelMenu_3->getWidth())), (int)(levelMenu_2->getLocalPos().y() - (1.5 * levelMenu_3->getHeight())));
+	levelMenu_back->setLocalPos((int)(0.5 * (levelMenu->getWidth() - levelMenu_back->getWidth())), (int)(levelMenu_3->getLocalPos().y() - (1.5 * levelMenu_back->getHeight())));
+
+	pauseMenu->setLocalPos((int)(0.5 * (width - pauseMenu->getWidth())), (int)(0.5 * (height - pauseMenu->getHeight())));
+	pauseMenu_resume->setLocalPos((int)(0.5 * (pauseMenu->getWidth() - pauseMenu_resume->getWidth())), (int)(pauseMenu->getHeight() - ((1.0/4.0) * pauseMenu->getHeight())));
+	pauseMenu_restart->setLocalPos((int)(0.5 * (pauseMenu->getWidth() - pauseMenu_restart->getWidth())), (int)(pauseMenu->getHeight() - ((2.0 / 4.0) * pauseMenu->getHeight())));
+	pauseMenu_quit->setLocalPos((int)(0.5 * (pauseMenu->getWidth() - pauseMenu_quit->getWidth())), (int)(pauseMenu->getHeight() - ((3.0 / 4.0) * pauseMenu->getHeight())));
+
+	gameoverMenu->setLocalPos((int)(0.5 * (width - gameoverMenu->getWidth())), (int)(0.5 * (height - gameoverMenu->getHeight())));
+	loseMessage->setLocalPos((int)(0.5 * (gameoverMenu->getWidth() - loseMessage->getWidth())), (int)(gameoverMenu->getHeight() - ((1.0 / 3)*(gameoverMenu->getHeight()))));
+	keyagainLose->setLocalPos((int)(0.5 * (gameoverMenu->getWidth() - keyagainLose->getWidth())), (int)(gameoverMenu->getHeight() - ((2.0 / 3)*(gameoverMenu->getHeight()))));
+
+	winMenu->setLocalPos((int)(0.5 * (width - winMenu->getWidth())), (int)(0.5 * (height - winMenu->getHeight())));
+	winMessage->setLocalPos((int)(0.5 * (winMenu->getWidth() - winMessage->getWidth())), (int)(winMenu->getHeight() - ((1.0 / 3)*(winMenu->getHeight()))));
+	keyagainWin->setLocalPos((int)(0.5 * (winMenu->getWidth() - keyagainWin->getWidth())), (int)(winMenu->getHeight() - ((2.0 / 3)*(winMenu->getHeight()))));
+
+	scorePanel->setLocalPos((int)(0.5 * (width - scorePanel->getWidth())), 5);
+	scoreLabel->setLocalPos((int)(0.5 * (scorePanel->getWidth() - scoreLabel->getWidth())), (int)(0.5 * (scorePanel->getHeight() - (scoreLabel->getHeight()))));
+}
+
+
+/**
+ * To put the pipes of a level, the bird and the score panel in the world. Graphics thread only.
+ */
+void showLevel(int a_level) {
+	switch (a_level) {
 	case LEVEL_1:
-		//for (cShapeCylinder *p : *lvl1)
-		//	currentLevel->push_back(new cShapeCylinder(*p));
-		currentLevel = new vector<cShapeCylinder*>(*lvl1); // call copy constructor
-		currentTurbulence = new vector<turbulence*>(*lvl1_turbulence);
+		currentLevel = lvl1;
 		break;
 	case LEVEL_2:
-		for (cShapeCylinder *p : *lvl2)
-			currentLevel->push_back(new cShapeCylinder(*p));
-		currentLevel = new vector<cShapeCylinder*>(*lvl2); // call copy constructor
-		currentTurbulence = new vector<turbulence*>(*lvl2_turbulence);
+		currentLevel = lvl2;
 		break;
 	case LEVEL_3:
-		for (cShapeCylinder *p : *lvl3)
-			currentLevel->push_back(new cShapeCylinder(*p));
-		currentTurbulence = new vector<turbulence*>(*lvl3_turbulence);
+		currentLevel = lvl3;
 		break;
 	}
-	for (cShapeCylinder *p : *currentLevel) { // make the cylinders visible
-		world->addChild(p);
-		p->setShowEnabled(true);
-		p->setEnabled(true);
+	if (endlessMode) currentLevel = NULL; // the pipes of an endless level are drawn by the track renderer
+
+	if (currentLevel != NULL) levelPipes->setPipes(*currentLevel); // make the pipes visible
+
+	levelShown = true;
+	if (birdAttached) {
+		birdBody->body->setEnabled(true, true);
+		birdBody->body->setShowEnabled(true, true);
+	}
+
+	scorePanel->setShowEnabled(true, true);
+	scorePanel->setEnabled(true, true);
+}
+
+
+/**
+ * To take the pipes of the level, the bird and the score panel out of the world. Graphics thread only.
+ */
+void hideLevel() {
+	levelPipes->clear();
+	currentLevel = NULL;
+
+	levelShown = false;
+	if (birdAttached) {
+		birdBody->body->setEnabled(false, true);
+		birdBody->body->setShowEnabled(false, true);
+	}
+
+	scorePanel->setEnabled(false, true);
+	scorePanel->setShowEnabled(false, true);
+}
+
+
+/**
+ * assigns the level layout to the current one for level playing, the graphics thread puts its pipes in the world
+ */
+void setLevel(int LEVEL) {
+	if (endlessMode) {
+		// an endless level only keeps the pipes ahead of the bird, drawn by the graphics thread
+		pipeTrack.reset(getPipeSettings(LEVEL), getTurbulenceSettings(LEVEL), LevelRandom(randomSeed, ENDLESS_STREAM + LEVEL), -1.0, PIPE_TRACK_LOOKAHEAD);
+	} else {
+		switch (LEVEL) {
+		case LEVEL_1:
+			currentModel = &lvl1Model;
+			break;
+		case LEVEL_2:
+			currentModel = &lvl2Model;
+			break;
+		case LEVEL_3:
+			currentModel = &lvl3Model;
+			break;
+		}
 	}
 
 	// set the bird up
-	birdBody->body->setEnabled(true, true);
-	birdBody->body->setShowEnabled(true, true);
-	birdBody->body->setLocalPos(0.0, 0.0, 0.0);
+	birdBody->m_position = cVector3d(0.0, 0.0, 0.0);
+	birdBody->m_velocity = cVector3d(-0.5, 0.0, 0.0); // don't carry the vertical speed over from the last attempt
 
 	// reset wing rotation
-	birdBody->rightWing->setLocalRot(cMatrix3d(1.0, 0.0, 0.0, 0)); // apply transformation
-	birdBody->leftWing->setLocalRot(cMatrix3d(1.0, 0.0, 0.0, 0)); // apply transformation
+	simState.rightWingAngle = 0.0;
+	simState.leftWingAngle = 0.0;
+
+	// start tracking the new level from its first pipe
+	simState.levelId++;
+	simState.firstActivePipe = 0;
+	postUiEvent(UI_LEVEL_START, LEVEL, simState.levelId);
 
 	// set win and lose to false
 	winState = false;
 	loseState = false;
 
 	// reset the camera
-	camera->set(cVector3d(0.5, 0.0, 0.0),    // camera position (eye)
-				cVector3d(0.0, 0.0, 0.0),    // look at position (target)
-				cVector3d(0.0, 0.0, 1.0));   // direction of the (up) vector
+	simState.cameraEye = cVector3d(0.5, 0.0, 0.0);    // camera position (eye)
+	simState.cameraTarget = cVector3d(0.0, 0.0, 0.0); // look at position (target)
+	simState.cameraUp = cVector3d(0.0, 0.0, 1.0);     // direction of the (up) vector
 
-	// update score label
-	SCORE = 0;
-	scorePanel->setShowEnabled(true, true);
-	scorePanel->setEnabled(true, true);
+	// the first frame of the level must not be interpolated from where the last level left off
+	simState.birdPos = birdBody->m_position;
+	simState.previousBirdPos = simState.birdPos;
+	simState.previousCameraEye = simState.cameraEye;
+	simState.previousCameraTarget = simState.cameraTarget;
 
-	scorePanel->setLocalPos((int)(0.5 * (width - scorePanel->getWidth())), 5);
-	scoreLabel->setText("SCORE: " + cStr(SCORE)); // update score label
-	scoreLabel->setLocalPos((int)(0.5 * (scorePanel->getWidth() - scoreLabel->getWidth())), (int)(0.5 * (scorePanel->getHeight() - (scoreLabel->getHeight()))));
-	
+	// reset the score, the label follows through postUiChanges()
+	SCORE = 0;
 }
 
 
 
 /**
- * turn off level pipes being visible, clear the current turbulence list
+ * turn off level pipes being visible
  */
 void cleanLevel() {
-	for (cShapeCylinder *p : *currentLevel) {
-		p->setShowEnabled(false);
-		p->setEnabled(false);
-		world->removeChild(p); // remove from world
-	}
+	// the graphics thread takes the pipes, the bird and the score panel out of the world
+	postUiEvent(UI_LEVEL_END);
 
-	currentTurbulence->clear();
-	delete currentTurbulence; // clean up memory
-	currentLevel->clear();
-	delete currentLevel; // clean up memory
+	// hide the pipes of the endless track
+	pipeTrack.clear();
+	simState.trackPipeCount = 0;
 
 	INIT_PROCESS = false; // reset so that level can go through initialization again
 	GAME_STARTED = false;
-	
-	birdBody->body->setEnabled(false, true);
-	birdBody->body->setShowEnabled(false, true);
 
 	// reset camera perspective
 	cameraAngle = CAMERA_1;
+}
 
-	scorePanel->setEnabled(false, true);
-	scorePanel->setShowEnabled(false, true);
+
+/**
+ * To post a change of the game to the graphics thread. Returns false if the queue was full. Headless
+ * mode has no graphics thread, so nothing is posted.
+ */
+bool postUiEvent(UiEventType a_type, unsigned int a_value, unsigned int a_levelId) {
+	if (headless) return true;
+	return uiEvents.post(a_type, a_value, a_levelId);
+}
+
+
+/**
+ * To post the screen, menu selection and score if they changed since the last tick. Called once
+ * per tick by the haptics thread, which never touches a widget itself. A change that did not fit in
+ * the queue is posted again on the next tick.
+ */
+void postUiChanges() {
+	static int postedScreen = UI_NONE;
+	static int postedSelection = -1;
+	static int postedScore = -1;
+
+	UiScreen screen = UI_PLAY;
+	unsigned int selection = 0;
+	switch (gameState) {
+	case MENU:
+		screen = UI_TITLE;
+		selection = menuState;
+		break;
+	case LEVEL_SELECT:
+		screen = UI_LEVEL_SELECT;
+		selection = levelSelectState;
+		break;
+	case PLAY:
+		screen = UI_PLAY;
+		break;
+	case PAUSE:
+		screen = UI_PAUSE;
+		selection = pauseState;
+		break;
+	case GAME_OVER:
+		screen = winState ? UI_WIN : UI_LOSE;
+		break;
+	}
+
+	if ((screen != postedScreen) && postUiEvent(UI_SCREEN, screen)) {
+		postedScreen = screen;
+		postedSelection = -1; // the new screen needs its selection
+	}
+	if (((int)selection != postedSelection) && postUiEvent(UI_SELECTION, selection)) {
+		postedSelection = selection;
+	}
+	if (((int)SCORE != postedScore) && postUiEvent(UI_SCORE, SCORE)) {
+		postedScore = SCORE;
+	}
 }
 
 /**
@@ -2116,21 +2956,21 @@ void cleanLevel() {
  * first person, or side scroll view.
  */
 void updateCamera(CAMERA_ANGLE a_perspective, cVector3d a_pos) {
+	// only the snapshot is written here, the graphics thread moves the camera
+	simState.cameraUp = cVector3d(0.0, 0.0, 1.0);												// direction of the (up) vector
+
 	switch (a_perspective) {
 	case CAMERA_1: // 3rd person
-		camera->set(cVector3d(a_pos.x(), 0.0, 0.0) + cVector3d(0.5, 0.0, 0.0),				// camera position (eye)
-					cVector3d(a_pos.x(), 0.0, 0.0),											// look at position (target)
-					cVector3d(0.0, 0.0, 1.0));												// direction of the (up) vector
+		simState.cameraEye = cVector3d(a_pos.x(), 0.0, 0.0) + cVector3d(0.5, 0.0, 0.0);		// camera position (eye)
+		simState.cameraTarget = cVector3d(a_pos.x(), 0.0, 0.0);								// look at position (target)
 		break;
 	case CAMERA_2: // 1st person
-		camera->set(cVector3d(a_pos.x(), 0.0, a_pos.z()) + cVector3d(-0.04, 0.0, 0.0),     // camera position (eye)
-					cVector3d(a_pos.x() - 2.0, 0.0, a_pos.z()),									// look at forward
-					cVector3d(0.0, 0.0, 1.0));												// direction of the (up) vector
+		simState.cameraEye = cVector3d(a_pos.x(), 0.0, a_pos.z()) + cVector3d(-0.04, 0.0, 0.0); // camera position (eye)
+		simState.cameraTarget = cVector3d(a_pos.x() - 2.0, 0.0, a_pos.z());					// look at forward
 		break;
 	case CAMERA_3: // side scroll
-		camera->set(cVector3d(a_pos.x(), 0.0, 0.0) + cVector3d(0.0, 1.5, 0.0),				// camera position (eye)
-					cVector3d(a_pos.x(), 0.0, 0.0),											// look at position (target)
-					cVector3d(0.0, 0.0, 1.0));												// direction of the (up) vector
+		simState.cameraEye = cVector3d(a_pos.x(), 0.0, 0.0) + cVector3d(0.0, 1.5, 0.0);		// camera position (eye)
+		simState.cameraTarget = cVector3d(a_pos.x(), 0.0, 0.0);								// look at position (target)
 		break;
 	}
 }
@@ -73,6 +73,8 @@
 #include "devices/CGenericHapticDevice.h"
 #include "devices/CHapticDeviceHandler.h"
 #include "devices/CMyCustomDevice.h"
+#include "devices/CHandTrajectory.h"
+#include "devices/CVirtualFalconDevice.h"
 #include "devices/CDeltaDevices.h"
 #include "devices/CLeapDevices.h"
 #include "devices/CPhantomDevices.h"
@@ -85,10 +87,12 @@
 //---------------------------------------------------------------------------
 #include "graphics/CColor.h"
 #include "graphics/CDisplayList.h"
+#include "graphics/CTessellationCache.h"
 #include "graphics/CDraw3D.h"
 #include "graphics/CFog.h"
 #include "graphics/CFont.h"
 #include "graphics/CImage.h"
+#include "graphics/CMeshOptimizer.h"
 #include "graphics/CMultiImage.h"
 #include "graphics/CVideo.h"
 #include "graphics/CPrimitives.h"
@@ -237,6 +241,7 @@
 //! \brief      Implements a frequency counter and high precision clock.
 //---------------------------------------------------------------------------
 #include "timers/CFrequencyCounter.h"
+#include "timers/CLatencyHistogram.h"
 #include "timers/CPrecisionClock.h"
 
 
@@ -252,6 +257,7 @@
 #include "files/CFileImagePPM.h"
 #include "files/CFileImageRAW.h"
 #include "files/CFileModel3DS.h"
+#include "files/CFileModelCache.h"
 #include "files/CFileModelOBJ.h"
 #include "files/CFileModelSTL.h"
 #include "files/CFileXML.h"
@@ -263,6 +269,7 @@
 //---------------------------------------------------------------------------
 #include "system/CGenericType.h"
 #include "system/CGlobals.h"
+#include "system/CMappedFile.h"
 #include "system/CMutex.h"
 #include "system/CString.h"
 #include "system/CThread.h"
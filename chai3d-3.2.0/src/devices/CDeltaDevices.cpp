@@ -91,6 +91,7 @@ bool cDeltaDevice::s_dhdGetPosition                          = true;
 bool cDeltaDevice::s_dhdGetLinearVelocity                    = true;
 bool cDeltaDevice::s_dhdGetOrientationRad                    = true;
 bool cDeltaDevice::s_dhdGetOrientationFrame                  = true;
+bool cDeltaDevice::s_dhdGetPositionAndOrientationFrame       = true;
 bool cDeltaDevice::s_dhdSetForce                             = true;
 bool cDeltaDevice::s_dhdSetTorque                            = true;
 bool cDeltaDevice::s_dhdSetForceAndTorque                    = true;
@@ -137,6 +138,7 @@ int  (__stdcall *dhdSetForce)                         (double  fx, double  fy, d
 int  (__stdcall *dhdGetOrientationRad)                (double *oa, double *ob, double *og, char ID);
 int  (__stdcall *dhdSetTorque)                        (double  ta, double  tb, double  tg, char ID);
 int  (__stdcall *dhdGetOrientationFrame)              (double matrix[3][3], char ID);
+int  (__stdcall *dhdGetPositionAndOrientationFrame)   (double *px, double *py, double *pz, double matrix[3][3], char ID);
 int  (__stdcall *dhdSetForceAndGripperForce)          (double fx, double fy, double fz, double f, char ID);
 int  (__stdcall *dhdSetForceAndTorque)                (double fx, double fy, double fz, double  ta, double  tb, double  tg, char ID);
 int  (__stdcall *dhdSetForceAndTorqueAndGripperForce) (double fx, double fy, double fz, double  ta, double  tb, double  tg, double f, char ID);
@@ -257,6 +259,9 @@ bool cDeltaDevice::openLibraries()
     }
     if (dhdGetOrientationFrame == NULL) { s_dhdGetOrientationFrame = false; }
 
+    dhdGetPositionAndOrientationFrame = (int (__stdcall*)(double*, double*, double*, double[3][3], char ID))GetProcAddress(fdDLL, "dhdGetPositionAndOrientationFrame");
+    if (dhdGetPositionAndOrientationFrame == NULL) { s_dhdGetPositionAndOrientationFrame = false; }
+
     dhdGetLinearVelocity = (int (__stdcall*)(double *vx, double *vy, double *vz, char ID))GetProcAddress(fdDLL, "dhdGetLinearVelocity");
     if (dhdGetLinearVelocity == NULL) { s_dhdGetLinearVelocity = false; }
 
@@ -1294,6 +1299,7 @@ bool cDeltaDevice::getPosition(cVector3d& a_position)
 #if !defined(MACOSX) & !defined(LINUX)
         estimateLinearVelocity(a_position);
 #endif
+        markPositionSensed();
         return (C_SUCCESS);
     }
     else
@@ -1636,6 +1642,8 @@ bool cDeltaDevice::setForceAndTorqueAndGripperForce(const cVector3d& a_force,
         }
     }
 
+    // the force computed from the latest position is on its way
+    markForceCommitted();
 
     // success
     return (C_SUCCESS);
@@ -1681,8 +1689,8 @@ bool cDeltaDevice::getUserSwitches(unsigned int& a_userSwitches)
         result = result | 1;
     }
 
-    // special case
-    if (dhdGetSystemType (m_deviceID) == 110)
+    // special case (device type is read once when the connection is opened)
+    if (m_deviceType == DHD_CASE_110)
     {
         if (result & 2)
         {
@@ -1697,6 +1705,75 @@ bool cDeltaDevice::getUserSwitches(unsigned int& a_userSwitches)
 }
 
 
+//==============================================================================
+/*!
+    This method returns the position, orientation, velocities, gripper angle
+    and user switches of the haptic device.
+
+    Position and orientation frame are read from the driver in a single
+    transaction. First generation devices, whose orientation is computed
+    from angles, and older drivers fall back to reading the values one by one.
+
+    \param  a_state  Return value.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cDeltaDevice::getState(cHapticDeviceState& a_state)
+{
+    // check if the system is available
+    if (!m_deviceReady) return (C_ERROR);
+
+    // check if DHD-API call is available and applies to this device
+    bool firstGeneration = (m_deviceType == DHD_DEVICE_3DOF) ||
+                           (m_deviceType == DHD_DEVICE_6DOF) ||
+                           (m_deviceType == DHD_DEVICE_6DOF_500) ||
+                           (m_deviceType == DHD_DEVICE_DELTA6);
+
+    if (firstGeneration || !s_dhdGetPositionAndOrientationFrame)
+    {
+        return (cGenericHapticDevice::getState(a_state));
+    }
+
+    // get position and orientation frame
+    double x,y,z;
+    double rot[3][3];
+    int error = dhdGetPositionAndOrientationFrame(&x, &y, &z, rot, m_deviceID);
+    if (error < 0)
+    {
+        a_state.m_position.set(0.0, 0.0, 0.0);
+        a_state.m_rotation.identity();
+        a_state.m_linearVelocity.set(0.0, 0.0, 0.0);
+        a_state.m_angularVelocity.set(0.0, 0.0, 0.0);
+        a_state.m_gripperAngle = 0.0;
+        a_state.m_gripperAngularVelocity = 0.0;
+        a_state.m_userSwitches = 0;
+        return (C_ERROR);
+    }
+
+    a_state.m_position.set(x + m_posWorkspaceOffset(0),
+                           y + m_posWorkspaceOffset(1),
+                           z + m_posWorkspaceOffset(2));
+    a_state.m_rotation.set(rot);
+    markPositionSensed();
+
+#if !defined(MACOSX) & !defined(LINUX)
+    estimateLinearVelocity(a_state.m_position);
+#endif
+    estimateAngularVelocity(a_state.m_rotation);
+
+    // remaining values are either cached or cheap driver reads
+    bool result = C_SUCCESS;
+    result = getLinearVelocity(a_state.m_linearVelocity) && result;
+    result = getGripperAngleRad(a_state.m_gripperAngle) && result;
+    result = getUserSwitches(a_state.m_userSwitches) && result;
+    a_state.m_angularVelocity = m_angularVelocity;
+    a_state.m_gripperAngularVelocity = m_gripperAngularVelocity;
+
+    return (result);
+}
+
+
 //==============================================================================
 /*!
     This method enables or disables the motors of the haptic device.
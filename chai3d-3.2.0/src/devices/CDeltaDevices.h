@@ -206,6 +206,9 @@ public:
     //! This method returns the status of all user switches [__true__ = __ON__ / __false__ = __OFF__].
     virtual bool getUserSwitches(unsigned int& a_userSwitches);
 
+    //! This method returns the position, orientation, velocities, gripper and user switches of the haptic device in one call.
+    virtual bool getState(cHapticDeviceState& a_state);
+
     //! This method sends a force, torque, and gripper force to the haptic device.
     virtual bool setForceAndTorqueAndGripperForce(const cVector3d& a_force, const cVector3d& a_torque, double a_gripperForce);
 
@@ -312,6 +315,7 @@ protected:
     static bool s_dhdGetOrientationRad;
     static bool s_dhdSetTorque;
     static bool s_dhdGetOrientationFrame;
+    static bool s_dhdGetPositionAndOrientationFrame;
     static bool s_dhdSetForce;
     static bool s_dhdSetForceAndTorque;
     static bool s_dhdSetForceAndGripperForce;
@@ -144,6 +144,10 @@ cGenericHapticDevice::cGenericHapticDevice(unsigned int a_deviceNumber) : cGener
     m_virtualGripperAngularVelocity		= cDegToRad(80.0);
     m_virtualGripperAngle				= m_virtualGripperAngleMin;
     m_virtualGripperClock.reset();
+
+    // no position read yet for the latency histogram
+    m_latencySenseTime = 0.0;
+    m_latencySensed = false;
 }
 
 
@@ -178,6 +182,36 @@ bool cGenericHapticDevice::getUserSwitch(int a_switchIndex, bool& a_status)
 }
 
 
+//==============================================================================
+/*!
+    This method returns the position, orientation, linear and angular
+    velocities, gripper angle and user switches of the device in one call.
+
+    Drivers that can read several of these values in a single transaction
+    should override this method. This default implementation simply calls
+    the individual access methods in turn.
+
+    \param  a_state  Returned device state.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cGenericHapticDevice::getState(cHapticDeviceState& a_state)
+{
+    bool result = C_SUCCESS;
+
+    result = getPosition(a_state.m_position) && result;
+    result = getRotation(a_state.m_rotation) && result;
+    result = getLinearVelocity(a_state.m_linearVelocity) && result;
+    result = getAngularVelocity(a_state.m_angularVelocity) && result;
+    result = getGripperAngleRad(a_state.m_gripperAngle) && result;
+    result = getGripperAngularVelocity(a_state.m_gripperAngularVelocity) && result;
+    result = getUserSwitches(a_state.m_userSwitches) && result;
+
+    return (result);
+}
+
+
 //==============================================================================
 /*!
     This method returns the position and orientation of the device through a 
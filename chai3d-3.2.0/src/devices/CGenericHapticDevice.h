@@ -48,6 +48,7 @@
 #include "devices/CGenericDevice.h"
 #include "math/CMaths.h"
 #include "system/CGlobals.h"
+#include "timers/CLatencyHistogram.h"
 #include "timers/CPrecisionClock.h"
 //------------------------------------------------------------------------------
 
@@ -260,6 +261,48 @@ struct cHapticDeviceInfo
     bool m_rightHand;
 };
 
+
+//==============================================================================
+/*!
+    \struct     cHapticDeviceState
+    \ingroup    devices
+
+    \brief
+    This structure stores the state of a haptic device read in a single call.
+
+    \details
+    This structure is filled by cGenericHapticDevice::getState(). It holds
+    everything a haptic loop usually reads from a device on every cycle so
+    that drivers can retrieve it with as few transactions as possible.
+*/
+//==============================================================================
+struct cHapticDeviceState
+{
+    //! Position of the device [m].
+    cVector3d m_position;
+
+    //! Orientation frame of the device end-effector.
+    cMatrix3d m_rotation;
+
+    //! Linear velocity of the device [m/s].
+    cVector3d m_linearVelocity;
+
+    //! Angular velocity of the device [rad/s].
+    cVector3d m_angularVelocity;
+
+    //! Gripper angle [rad].
+    double m_gripperAngle;
+
+    //! Angular velocity of the gripper [rad/s].
+    double m_gripperAngularVelocity;
+
+    //! Bitmask of the user switches (bit __i__ set if switch __i__ is __ON__).
+    unsigned int m_userSwitches;
+
+    //! This method returns the status of user switch __a_switchIndex__.
+    inline bool getUserSwitch(int a_switchIndex) const { return (cCheckBit(m_userSwitches, a_switchIndex)); }
+};
+
 //------------------------------------------------------------------------------
 class cGenericHapticDevice;
 typedef std::shared_ptr<cGenericHapticDevice> cGenericHapticDevicePtr;
@@ -352,6 +395,9 @@ public:
     //! This method returns the status of all user switches [__true__ = __ON__ / __false__ = __OFF__].
     virtual bool getUserSwitches(unsigned int& a_userSwitches) { a_userSwitches = 0; return (m_deviceReady); }
 
+    //! This method returns the position, orientation, velocities, gripper and user switches of the haptic device in one call.
+    virtual bool getState(cHapticDeviceState& a_state);
+
     //! This method returns the technical specifications of this haptic device.
     cHapticDeviceInfo getSpecifications() { return (m_specifications); }
 
@@ -371,6 +417,19 @@ public:
     virtual bool setForceAndTorqueAndGripperForce(const cVector3d& a_force, const cVector3d& a_torque, double a_gripperForce) { cSleepMs(1); return (m_deviceReady); }
 
 
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - LATENCY:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the histogram of the time from reading a position to committing the force computed from it. It can be read from any thread.
+    const cLatencyHistogram& getLatencyHistogram() const { return (m_latencyHistogram); }
+
+    //! This method clears the latency histogram. It must not be called while the device is being read or commanded.
+    void resetLatencyHistogram() { m_latencyHistogram.reset(); m_latencySensed = false; }
+
+
     //--------------------------------------------------------------------------
     // PUBLIC STATIC METHODS:
     //--------------------------------------------------------------------------
@@ -462,6 +521,22 @@ protected:
     cPrecisionClock m_clockGeneral;
 
 
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS - LATENCY:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Histogram of the time from reading a position to committing the following force.
+    cLatencyHistogram m_latencyHistogram;
+
+    //! CPU time in seconds when the latest position was read.
+    double m_latencySenseTime;
+
+    //! If __true__ then a position was read since the last force was committed.
+    bool m_latencySensed;
+
+
     //--------------------------------------------------------------------------
     // PROTECTED MEMBERS - GRIPPER USER SWITCH:
     //--------------------------------------------------------------------------
@@ -522,6 +597,28 @@ protected:
     void estimateGripperVelocity(double a_newGripperPosition);
 
 
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS - LATENCY:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Drivers call this method when a position sample has been acquired.
+    inline void markPositionSensed()
+    {
+        m_latencySenseTime = cPrecisionClock::getCPUTimeSeconds();
+        m_latencySensed = true;
+    }
+
+    //! Drivers call this method once a force has been committed to the device.
+    inline void markForceCommitted()
+    {
+        if (!m_latencySensed) return;
+        m_latencyHistogram.record(cPrecisionClock::getCPUTimeSeconds() - m_latencySenseTime);
+        m_latencySensed = false;
+    }
+
+
     //--------------------------------------------------------------------------
     // PROTECTED METHODS - GRIPPER USER SWITCH:
     //--------------------------------------------------------------------------
@@ -0,0 +1,168 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Brandon Sieu, Glenn Skelton
+    \version   3.2.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "devices/CHandTrajectory.h"
+#include "math/CConstants.h"
+//------------------------------------------------------------------------------
+#include <cmath>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cSineHandTrajectory.
+
+    \param  a_amplitude  Amplitude of the motion along each axis [m].
+    \param  a_frequency  Frequency of the motion [Hz].
+    \param  a_center     Position the hand oscillates around [m].
+    \param  a_phase      Phase of the motion [rad].
+*/
+//==============================================================================
+cSineHandTrajectory::cSineHandTrajectory(const cVector3d& a_amplitude,
+                                         const double a_frequency,
+                                         const cVector3d& a_center,
+                                         const double a_phase)
+{
+    m_amplitude = a_amplitude;
+    m_frequency = a_frequency;
+    m_center = a_center;
+    m_phase = a_phase;
+}
+
+
+//==============================================================================
+/*!
+    This method returns the hand position and user switches at a given time.
+    No user switches are ever pressed.
+
+    \param  a_time           Time [s].
+    \param  a_position       Returned hand position [m].
+    \param  a_userSwitches   Returned user switch bitmask.
+*/
+//==============================================================================
+void cSineHandTrajectory::getHand(const double a_time, cVector3d& a_position, unsigned int& a_userSwitches)
+{
+    double s = sin(C_TWO_PI * m_frequency * a_time + m_phase);
+    a_position = m_center + s * m_amplitude;
+    a_userSwitches = 0;
+}
+
+
+//==============================================================================
+/*!
+    Constructor of cNoiseHandTrajectory.
+
+    \param  a_amplitude  Maximum excursion from the center along each axis [m].
+    \param  a_bandwidth  Number of random knots per second [Hz].
+    \param  a_seed       Seed of the motion.
+    \param  a_center     Position the hand moves around [m].
+*/
+//==============================================================================
+cNoiseHandTrajectory::cNoiseHandTrajectory(const cVector3d& a_amplitude,
+                                           const double a_bandwidth,
+                                           const uint64_t a_seed,
+                                           const cVector3d& a_center)
+{
+    m_amplitude = a_amplitude;
+    m_bandwidth = a_bandwidth;
+    m_seed = a_seed;
+    m_center = a_center;
+}
+
+
+//==============================================================================
+/*!
+    This method returns the hand position and user switches at a given time.
+    The position is a smoothstep interpolation between the two surrounding
+    random knots. No user switches are ever pressed.
+
+    \param  a_time           Time [s].
+    \param  a_position       Returned hand position [m].
+    \param  a_userSwitches   Returned user switch bitmask.
+*/
+//==============================================================================
+void cNoiseHandTrajectory::getHand(const double a_time, cVector3d& a_position, unsigned int& a_userSwitches)
+{
+    double u = a_time * m_bandwidth;
+    double k = floor(u);
+    double f = u - k;
+    f = f * f * (3.0 - 2.0 * f);
+
+    int64_t k0 = (int64_t)k;
+    for (unsigned int i=0; i<3; i++)
+    {
+        double v = (1.0 - f) * knot(k0, i) + f * knot(k0 + 1, i);
+        a_position(i) = m_center(i) + m_amplitude(i) * v;
+    }
+    a_userSwitches = 0;
+}
+
+
+//==============================================================================
+/*!
+    This method hashes a knot index, axis and the seed into a random value
+    (splitmix64 finalizer).
+
+    \param  a_knot  Index of the knot.
+    \param  a_axis  Axis (0, 1 or 2).
+
+    \return Random value in [-1, 1].
+*/
+//==============================================================================
+double cNoiseHandTrajectory::knot(const int64_t a_knot, const unsigned int a_axis) const
+{
+    uint64_t z = m_seed + 0x9E3779B97F4A7C15ULL * ((uint64_t)a_knot * 3 + a_axis + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+
+    return ((double)(z >> 11) * (1.0 / 9007199254740992.0)) * 2.0 - 1.0;
+}
+
+//------------------------------------------------------------------------------
+}       // namespace chai3d
+//------------------------------------------------------------------------------
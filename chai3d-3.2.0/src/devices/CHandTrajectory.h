@@ -0,0 +1,269 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Brandon Sieu, Glenn Skelton
+    \version   3.2.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CHandTrajectoryH
+#define CHandTrajectoryH
+//------------------------------------------------------------------------------
+#include "math/CVector3d.h"
+//------------------------------------------------------------------------------
+#include <memory>
+#include <cstdint>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CHandTrajectory.h
+
+    \brief
+    Implements generators of hand motion for simulated haptic devices.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+class cGenericHandTrajectory;
+typedef std::shared_ptr<cGenericHandTrajectory> cGenericHandTrajectoryPtr;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \class      cGenericHandTrajectory
+    \ingroup    devices
+
+    \brief
+    This class is an abstract generator of hand motion.
+
+    \details
+    A hand trajectory describes where the hand of a simulated user is and
+    which buttons it presses at any point in time. Simulated devices such as
+    cVirtualFalconDevice pull their end-effector towards this position.
+    Generators must be deterministic functions of time so that a simulation
+    driven by a virtual clock is repeatable.
+*/
+//==============================================================================
+class cGenericHandTrajectory
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cGenericHandTrajectory.
+    cGenericHandTrajectory() {}
+
+    //! Destructor of cGenericHandTrajectory.
+    virtual ~cGenericHandTrajectory() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the hand position [m] and user switch bitmask at time __a_time__ [s].
+    virtual void getHand(const double a_time, cVector3d& a_position, unsigned int& a_userSwitches) = 0;
+};
+
+
+//------------------------------------------------------------------------------
+class cSineHandTrajectory;
+typedef std::shared_ptr<cSineHandTrajectory> cSineHandTrajectoryPtr;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \class      cSineHandTrajectory
+    \ingroup    devices
+
+    \brief
+    This class generates a sinusoidal (flapping) hand motion.
+
+    \details
+    The hand oscillates around a center position. Each axis has its own
+    amplitude, all axes share the same frequency and phase.
+*/
+//==============================================================================
+class cSineHandTrajectory : public cGenericHandTrajectory
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cSineHandTrajectory.
+    cSineHandTrajectory(const cVector3d& a_amplitude = cVector3d(0.0, 0.0, 0.03),
+                        const double a_frequency = 2.0,
+                        const cVector3d& a_center = cVector3d(0.0, 0.0, 0.0),
+                        const double a_phase = 0.0);
+
+    //! Shared cSineHandTrajectory allocator.
+    static cSineHandTrajectoryPtr create(const cVector3d& a_amplitude = cVector3d(0.0, 0.0, 0.03),
+                                         const double a_frequency = 2.0,
+                                         const cVector3d& a_center = cVector3d(0.0, 0.0, 0.0),
+                                         const double a_phase = 0.0) { return (std::make_shared<cSineHandTrajectory>(a_amplitude, a_frequency, a_center, a_phase)); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the hand position [m] and user switch bitmask at time __a_time__ [s].
+    virtual void getHand(const double a_time, cVector3d& a_position, unsigned int& a_userSwitches);
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC MEMBERS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Amplitude of the motion along each axis [m].
+    cVector3d m_amplitude;
+
+    //! Frequency of the motion [Hz].
+    double m_frequency;
+
+    //! Position the hand oscillates around [m].
+    cVector3d m_center;
+
+    //! Phase of the motion [rad].
+    double m_phase;
+};
+
+
+//------------------------------------------------------------------------------
+class cNoiseHandTrajectory;
+typedef std::shared_ptr<cNoiseHandTrajectory> cNoiseHandTrajectoryPtr;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \class      cNoiseHandTrajectory
+    \ingroup    devices
+
+    \brief
+    This class generates a smooth random hand motion.
+
+    \details
+    Random knots are placed at a fixed rate and the hand is smoothly
+    interpolated between them. The knots are hashed from their index and a
+    seed rather than drawn from a running generator, so the position at any
+    time only depends on the seed and the time.
+*/
+//==============================================================================
+class cNoiseHandTrajectory : public cGenericHandTrajectory
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cNoiseHandTrajectory.
+    cNoiseHandTrajectory(const cVector3d& a_amplitude = cVector3d(0.01, 0.01, 0.03),
+                         const double a_bandwidth = 4.0,
+                         const uint64_t a_seed = 0,
+                         const cVector3d& a_center = cVector3d(0.0, 0.0, 0.0));
+
+    //! Shared cNoiseHandTrajectory allocator.
+    static cNoiseHandTrajectoryPtr create(const cVector3d& a_amplitude = cVector3d(0.01, 0.01, 0.03),
+                                          const double a_bandwidth = 4.0,
+                                          const uint64_t a_seed = 0,
+                                          const cVector3d& a_center = cVector3d(0.0, 0.0, 0.0)) { return (std::make_shared<cNoiseHandTrajectory>(a_amplitude, a_bandwidth, a_seed, a_center)); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the hand position [m] and user switch bitmask at time __a_time__ [s].
+    virtual void getHand(const double a_time, cVector3d& a_position, unsigned int& a_userSwitches);
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC MEMBERS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Maximum excursion from the center along each axis [m].
+    cVector3d m_amplitude;
+
+    //! Number of random knots per second [Hz].
+    double m_bandwidth;
+
+    //! Seed of the motion.
+    uint64_t m_seed;
+
+    //! Position the hand moves around [m].
+    cVector3d m_center;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method returns a random value in [-1, 1] for knot __a_knot__ on axis __a_axis__.
+    double knot(const int64_t a_knot, const unsigned int a_axis) const;
+};
+
+//------------------------------------------------------------------------------
+}       // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
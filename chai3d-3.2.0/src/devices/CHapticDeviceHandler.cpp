@@ -71,12 +71,19 @@
 #if defined(C_ENABLE_CUSTOM_DEVICE_SUPPORT)
 #include "devices/CMyCustomDevice.h"
 #endif
+
+#include "devices/CVirtualFalconDevice.h"
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+bool cHapticDeviceHandler::s_enableVirtualDevices = false;
+bool cHapticDeviceHandler::s_replaceHardwareByVirtualDevices = false;
+//------------------------------------------------------------------------------
+
 //==============================================================================
 /*!
     Constructor of cHapticDeviceHandler.
@@ -234,6 +241,57 @@ void cHapticDeviceHandler::update()
     }
 
     #endif
+
+
+    //--------------------------------------------------------------------------
+    // search for virtual Falcon devices
+    //--------------------------------------------------------------------------
+    if (s_enableVirtualDevices)
+    {
+        // simulated devices replace the hardware if requested
+        if (s_replaceHardwareByVirtualDevices)
+        {
+            m_numDevices = 0;
+            for (unsigned int i=0; i<C_MAX_HAPTIC_DEVICES; i++)
+            {
+                m_devices[i] = nullptr;
+            }
+        }
+
+        // otherwise they only stand in when no hardware is connected
+        if (m_numDevices == 0)
+        {
+            // check for how many devices are requested for this class of devices
+            count = cMin((unsigned int)cVirtualFalconDevice::getNumDevices(), (unsigned int)C_MAX_HAPTIC_DEVICES);
+
+            // create all devices
+            for (int i=0; i<count; i++)
+            {
+                device = cVirtualFalconDevice::create(i);
+                m_devices[m_numDevices] = device;
+                m_numDevices++;
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method enables the listing of virtual Falcons (see cVirtualFalconDevice)
+    the next time update() is called. By default the virtual Falcons are only
+    listed when no other haptic device is found. The number of virtual Falcons
+    is set with cVirtualFalconDevice::setNumDevices().
+
+    \param  a_enabled          If __true__ then virtual Falcons are listed.
+    \param  a_replaceHardware  If __true__ then virtual Falcons are listed in
+                               place of the hardware devices that are found.
+*/
+//==============================================================================
+void cHapticDeviceHandler::setEnableVirtualDevices(const bool a_enabled, const bool a_replaceHardware)
+{
+    s_enableVirtualDevices = a_enabled;
+    s_replaceHardwareByVirtualDevices = a_replaceHardware;
 }
 
 
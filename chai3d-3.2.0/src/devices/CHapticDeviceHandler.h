@@ -113,6 +113,16 @@ public:
         unsigned int a_index = 0);
 
 
+    //--------------------------------------------------------------------------
+    // PUBLIC STATIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method enables the listing of virtual Falcons by update(), either when no hardware is found or in place of it.
+    static void setEnableVirtualDevices(const bool a_enabled, const bool a_replaceHardware = false);
+
+
     //--------------------------------------------------------------------------
     // PRIVATE MEMBERS:
     //--------------------------------------------------------------------------
@@ -127,6 +137,19 @@ private:
 
     //! A default device with no functionalities.
     cGenericHapticDevicePtr m_nullHapticDevice;
+
+
+    //--------------------------------------------------------------------------
+    // PRIVATE STATIC MEMBERS:
+    //--------------------------------------------------------------------------
+
+private:
+
+    //! If __true__ then virtual Falcons are listed.
+    static bool s_enableVirtualDevices;
+
+    //! If __true__ then virtual Falcons are listed even if hardware is found, and replace it.
+    static bool s_replaceHardwareByVirtualDevices;
 };
 
 //------------------------------------------------------------------------------
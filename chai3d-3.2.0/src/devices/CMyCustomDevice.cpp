@@ -443,6 +443,9 @@ bool cMyCustomDevice::getPosition(cVector3d& a_position)
     // estimate linear velocity
     estimateLinearVelocity(a_position);
 
+    // time the sample for the latency histogram
+    markPositionSensed();
+
     // exit
     return (result);
 }
@@ -616,6 +619,8 @@ bool cMyCustomDevice::setForceAndTorqueAndGripperForce(const cVector3d& a_force,
     // setTorqueToMyDevice(tx, ty, tz);
     // setForceToGripper(fg);
 
+    // the force computed from the latest position is on its way
+    markForceCommitted();
 
     // exit
     return (result);
@@ -741,6 +741,9 @@ bool cPhantomDevice::getPosition(cVector3d& a_position)
     // estimate velocity
     estimateLinearVelocity(a_position);
 
+    // time the sample for the latency histogram
+    markPositionSensed();
+
     // return result
     return (error != 0);
 }
@@ -816,6 +819,9 @@ bool cPhantomDevice::setForceAndTorqueAndGripperForce(const cVector3d& a_force,
     m_prevForce  = a_force;
     m_prevTorque = a_torque;
 
+    // the force computed from the latest position is on its way
+    markForceCommitted();
+
     // return success
     return (C_SUCCESS);
 }
@@ -0,0 +1,408 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Brandon Sieu, Glenn Skelton
+    \version   3.2.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "system/CGlobals.h"
+#include "devices/CVirtualFalconDevice.h"
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// number of virtual Falcons listed by the haptic device handler
+unsigned int cVirtualFalconDevice::s_numDevices = 2;
+
+// longest time span integrated in one update [s]. If the device has not been
+// accessed for longer than this (application paused, debugger) the model
+// skips ahead instead of integrating thousands of steps at once.
+const double C_VIRTUAL_FALCON_MAX_CATCH_UP = 0.1;
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    Constructor of cVirtualFalconDevice.
+
+    \param  a_deviceNumber  Index number of the device.
+*/
+//==============================================================================
+cVirtualFalconDevice::cVirtualFalconDevice(unsigned int a_deviceNumber) : cGenericHapticDevice(a_deviceNumber)
+{
+    // the connection to the device has not yet been established.
+    m_deviceReady = false;
+
+    // same characteristics as the real device (see CDeltaDevices.cpp)
+    m_specifications.m_model                         = C_HAPTIC_DEVICE_VIRTUAL;
+    m_specifications.m_manufacturerName              = "CHAI3D";
+    m_specifications.m_modelName                     = "Virtual Falcon";
+    m_specifications.m_maxLinearForce                =    8.0;   // [N]
+    m_specifications.m_maxAngularTorque              =    0.0;   // [N*m]
+    m_specifications.m_maxGripperForce               =    0.0;   // [N]
+    m_specifications.m_maxLinearStiffness            = 3000.0;   // [N/m]
+    m_specifications.m_maxAngularStiffness           =    0.0;   // [N*m/Rad]
+    m_specifications.m_maxGripperLinearStiffness     =    0.0;   // [N*m/Rad]
+    m_specifications.m_maxLinearDamping              =   20.0;   // [N/(m/s)]
+    m_specifications.m_maxAngularDamping             =    0.0;   // [N*m/(Rad/s)]
+    m_specifications.m_maxGripperAngularDamping      =    0.0;   // [N*m/(Rad/s)]
+    m_specifications.m_workspaceRadius               =    0.04;  // [m]
+    m_specifications.m_gripperMaxAngleRad            = cDegToRad(0.0);
+    m_specifications.m_sensedPosition                = true;
+    m_specifications.m_sensedRotation                = false;
+    m_specifications.m_sensedGripper                 = false;
+    m_specifications.m_actuatedPosition              = true;
+    m_specifications.m_actuatedRotation              = false;
+    m_specifications.m_actuatedGripper               = false;
+    m_specifications.m_leftHand                      = true;
+    m_specifications.m_rightHand                     = true;
+
+    // model of the end-effector and of the hand holding it
+    m_mass          = 0.15;     // [kg]
+    m_handStiffness = 300.0;    // [N/m]
+    m_handDamping   = 4.0;      // [N/(m/s)]
+    m_timeStep      = 0.00025;  // [s]
+
+    // by default the simulated hand flaps the device up and down
+    m_trajectory = cSineHandTrajectory::create();
+
+    m_time = 0.0;
+    m_position.zero();
+    m_velocity.zero();
+    m_force.zero();
+    m_userSwitches = 0;
+
+    // a simulated device is always available
+    m_deviceAvailable = true;
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cVirtualFalconDevice.
+*/
+//==============================================================================
+cVirtualFalconDevice::~cVirtualFalconDevice()
+{
+    // close connection to device
+    if (m_deviceReady)
+    {
+        close();
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method opens a connection to the device. The end-effector is placed
+    in the hand of the simulated user at rest.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cVirtualFalconDevice::open()
+{
+    // if system is already opened then return
+    if (m_deviceReady) return (C_ERROR);
+
+    // start the internal clock
+    m_deviceClock.start(true);
+    m_time = m_clock ? m_clock() : m_deviceClock.getCurrentTimeSeconds();
+
+    // place the end-effector in the hand
+    m_userSwitches = 0;
+    if (m_trajectory != nullptr)
+    {
+        m_trajectory->getHand(m_time, m_position, m_userSwitches);
+    }
+    else
+    {
+        m_position.zero();
+    }
+    m_velocity.zero();
+    m_force.zero();
+
+    m_deviceReady = true;
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method closes the connection to the device.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cVirtualFalconDevice::close()
+{
+    // check if the system has been opened previously
+    if (!m_deviceReady) return (C_ERROR);
+
+    m_deviceClock.stop();
+    m_force.zero();
+    m_deviceReady = false;
+
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This method calibrates the device. A simulated device is always calibrated.
+
+    \param  a_forceCalibration  Unused.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cVirtualFalconDevice::calibrate(bool /*a_forceCalibration*/)
+{
+    return (m_deviceReady);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the position of the end-effector.
+
+    \param  a_position  Return value.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cVirtualFalconDevice::getPosition(cVector3d& a_position)
+{
+    updateModel();
+    a_position = m_position;
+    markPositionSensed();
+    return (m_deviceReady);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the velocity of the end-effector. The velocity comes
+    straight from the model so no estimation filter is involved.
+
+    \param  a_linearVelocity  Return value.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cVirtualFalconDevice::getLinearVelocity(cVector3d& a_linearVelocity)
+{
+    updateModel();
+    m_linearVelocity = m_velocity;
+    a_linearVelocity = m_velocity;
+    return (m_deviceReady);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the user switches pressed by the simulated hand.
+
+    \param  a_userSwitches  Return value.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cVirtualFalconDevice::getUserSwitches(unsigned int& a_userSwitches)
+{
+    updateModel();
+    a_userSwitches = m_userSwitches;
+    return (m_deviceReady);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the full state of the device. The model is only
+    brought up to date once for all values.
+
+    \param  a_state  Return value.
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cVirtualFalconDevice::getState(cHapticDeviceState& a_state)
+{
+    updateModel();
+
+    m_linearVelocity = m_velocity;
+
+    a_state.m_position = m_position;
+    a_state.m_rotation.identity();
+    a_state.m_linearVelocity = m_velocity;
+    a_state.m_angularVelocity.zero();
+    a_state.m_gripperAngle = 0.0;
+    a_state.m_gripperAngularVelocity = 0.0;
+    a_state.m_userSwitches = m_userSwitches;
+    markPositionSensed();
+
+    return (m_deviceReady);
+}
+
+
+//==============================================================================
+/*!
+    This method sends a force to the device. The force is saturated at the
+    maximum force of a Falcon and held until the next command.
+
+    \param  a_force         Force command [N].
+    \param  a_torque        Torque command [N*m] (unused).
+    \param  a_gripperForce  Gripper force command [N] (unused).
+
+    \return __true__ if the operation succeeds, __false__ otherwise.
+*/
+//==============================================================================
+bool cVirtualFalconDevice::setForceAndTorqueAndGripperForce(const cVector3d& a_force, const cVector3d& a_torque, double a_gripperForce)
+{
+    // integrate up to now with the previous force before switching to the new one
+    updateModel();
+
+    m_force = a_force;
+    double norm = m_force.length();
+    if (norm > m_specifications.m_maxLinearForce)
+    {
+        m_force.mul(m_specifications.m_maxLinearForce / norm);
+    }
+
+    // store new commanded values
+    m_prevForce = a_force;
+    m_prevTorque = a_torque;
+    m_prevGripperForce = a_gripperForce;
+    markForceCommitted();
+
+    return (m_deviceReady);
+}
+
+
+//==============================================================================
+/*!
+    This method integrates the mass-spring-damper model from the last update
+    to the current time in fixed steps:
+
+    m * a = k * (hand - x) - b * v + force
+
+    The end-effector is kept inside the workspace as if it hit the
+    mechanical end stops.
+*/
+//==============================================================================
+void cVirtualFalconDevice::updateModel()
+{
+    if (!m_deviceReady) return;
+
+    double now = m_clock ? m_clock() : m_deviceClock.getCurrentTimeSeconds();
+    if (now - m_time > C_VIRTUAL_FALCON_MAX_CATCH_UP)
+    {
+        m_time = now - C_VIRTUAL_FALCON_MAX_CATCH_UP;
+    }
+
+    double radius = 1.5 * m_specifications.m_workspaceRadius;
+    cVector3d hand;
+
+    while (m_time + m_timeStep <= now + 1e-9)
+    {
+        m_time += m_timeStep;
+
+        // where the simulated user holds the device
+        hand = m_position;
+        if (m_trajectory != nullptr)
+        {
+            m_trajectory->getHand(m_time, hand, m_userSwitches);
+        }
+
+        // semi-implicit Euler
+        cVector3d accel = (1.0 / m_mass) * (m_handStiffness * (hand - m_position) - m_handDamping * m_velocity + m_force);
+        m_velocity += m_timeStep * accel;
+        m_position += m_timeStep * m_velocity;
+
+        // end stops
+        double dist = m_position.length();
+        if (dist > radius)
+        {
+            cVector3d n = m_position / dist;
+            m_position = radius * n;
+            double vn = m_velocity.dot(n);
+            if (vn > 0.0)
+            {
+                m_velocity -= vn * n;
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method returns the number of virtual Falcons listed by the haptic
+    device handler.
+
+    \return Number of devices.
+*/
+//==============================================================================
+unsigned int cVirtualFalconDevice::getNumDevices()
+{
+    return (s_numDevices);
+}
+
+
+//==============================================================================
+/*!
+    This method sets the number of virtual Falcons listed by the haptic
+    device handler the next time it is updated.
+
+    \param  a_numDevices  Number of devices.
+*/
+//==============================================================================
+void cVirtualFalconDevice::setNumDevices(unsigned int a_numDevices)
+{
+    s_numDevices = a_numDevices;
+}
+
+//------------------------------------------------------------------------------
+}       // namespace chai3d
+//------------------------------------------------------------------------------
+
@@ -0,0 +1,239 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Brandon Sieu, Glenn Skelton
+    \version   3.2.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CVirtualFalconDeviceH
+#define CVirtualFalconDeviceH
+//------------------------------------------------------------------------------
+#include "devices/CGenericHapticDevice.h"
+#include "devices/CHandTrajectory.h"
+//------------------------------------------------------------------------------
+#include <functional>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CVirtualFalconDevice.h
+
+    \brief
+    Implements a simulated Novint Falcon haptic device.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+class cVirtualFalconDevice;
+typedef std::shared_ptr<cVirtualFalconDevice> cVirtualFalconDevicePtr;
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \class      cVirtualFalconDevice
+    \ingroup    devices
+
+    \brief
+    This class implements a simulated Novint Falcon.
+
+    \details
+    The end-effector is modelled as a point mass held by the hand of a
+    simulated user through a spring and damper. The hand follows a
+    pluggable trajectory (see cGenericHandTrajectory) and the forces sent
+    with setForceAndTorqueAndGripperForce() push the end-effector away
+    from it, so the device closes the haptic loop like real hardware.
+    The model is integrated with semi-implicit Euler in fixed steps up to
+    the current time every time the device is accessed.\n\n
+
+    Time is read from a precision clock started by open(). A simulation
+    running in virtual time can provide its own clock with setClock().\n\n
+
+    Applications can create virtual Falcons directly with create(). After
+    cHapticDeviceHandler::setEnableVirtualDevices() is called, the haptic
+    device handler also lists getNumDevices() virtual Falcons when no other
+    haptic device is found, so that applications run unchanged on machines
+    without hardware.
+*/
+//==============================================================================
+class cVirtualFalconDevice : public cGenericHapticDevice
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cVirtualFalconDevice.
+    cVirtualFalconDevice(unsigned int a_deviceNumber = 0);
+
+    //! Destructor of cVirtualFalconDevice.
+    virtual ~cVirtualFalconDevice();
+
+    //! Shared cVirtualFalconDevice allocator.
+    static cVirtualFalconDevicePtr create(unsigned int a_deviceNumber = 0) { return (std::make_shared<cVirtualFalconDevice>(a_deviceNumber)); }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method opens a connection to the haptic device.
+    virtual bool open();
+
+    //! This method closes the connection to the haptic device.
+    virtual bool close();
+
+    //! This method calibrates the haptic device.
+    virtual bool calibrate(bool a_forceCalibration = false);
+
+    //! This method returns the position of the device.
+    virtual bool getPosition(cVector3d& a_position);
+
+    //! This method returns the linear velocity of the device.
+    virtual bool getLinearVelocity(cVector3d& a_linearVelocity);
+
+    //! This method returns the status of all user switches [__true__ = __ON__ / __false__ = __OFF__].
+    virtual bool getUserSwitches(unsigned int& a_userSwitches);
+
+    //! This method returns the position, orientation, velocities, gripper and user switches of the haptic device in one call.
+    virtual bool getState(cHapticDeviceState& a_state);
+
+    //! This method sends a force [N] and a torque [N*m] and gripper force [N] to the haptic device.
+    virtual bool setForceAndTorqueAndGripperForce(const cVector3d& a_force, const cVector3d& a_torque, double a_gripperForce);
+
+    //! This method sets the generator of the simulated hand motion.
+    void setHandTrajectory(cGenericHandTrajectoryPtr a_trajectory) { m_trajectory = a_trajectory; }
+
+    //! This method returns the generator of the simulated hand motion.
+    cGenericHandTrajectoryPtr getHandTrajectory() const { return (m_trajectory); }
+
+    //! This method replaces the precision clock by a clock returning the current time [s].
+    void setClock(std::function<double(void)> a_clock) { m_clock = a_clock; }
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC STATIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the number of devices available from this class of device.
+    static unsigned int getNumDevices();
+
+    //! This method sets the number of devices listed by the haptic device handler.
+    static void setNumDevices(unsigned int a_numDevices);
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC MEMBERS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Mass of the end-effector [kg].
+    double m_mass;
+
+    //! Stiffness of the coupling between the hand and the end-effector [N/m].
+    double m_handStiffness;
+
+    //! Damping of the coupling between the hand and the end-effector [N/(m/s)].
+    double m_handDamping;
+
+    //! Integration step of the model [s].
+    double m_timeStep;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method integrates the model up to the current time.
+    void updateModel();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Generator of the simulated hand motion.
+    cGenericHandTrajectoryPtr m_trajectory;
+
+    //! Optional external clock.
+    std::function<double(void)> m_clock;
+
+    //! Internal clock used when no external clock is set.
+    cPrecisionClock m_deviceClock;
+
+    //! Time the model has been integrated to [s].
+    double m_time;
+
+    //! Position of the end-effector [m].
+    cVector3d m_position;
+
+    //! Velocity of the end-effector [m/s].
+    cVector3d m_velocity;
+
+    //! Force currently applied by the device [N].
+    cVector3d m_force;
+
+    //! User switches of the simulated hand.
+    unsigned int m_userSwitches;
+
+    //! Number of devices listed by the haptic device handler.
+    static unsigned int s_numDevices;
+};
+
+//------------------------------------------------------------------------------
+}       // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
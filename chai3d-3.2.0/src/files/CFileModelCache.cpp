@@ -0,0 +1,537 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Brandon Sieu, Glenn Skelton
+    \version   3.2.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "files/CFileModelCache.h"
+//------------------------------------------------------------------------------
+#include "materials/CTexture2d.h"
+#include "system/CMappedFile.h"
+//------------------------------------------------------------------------------
+#include <cstdio>
+#include <cstring>
+//------------------------------------------------------------------------------
+using namespace std;
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//==============================================================================
+// INTERNAL DEFINITIONS FOR MODEL CACHES:
+//==============================================================================
+
+//! Identifies a model cache file.
+const char C_MODEL_CACHE_MAGIC[8] = { 'C', '3', 'D', 'M', 'E', 'S', 'H', '\0' };
+
+//! Memory layout of the arrays stored in a cache. Caches written with another layout are ignored.
+const unsigned int C_MODEL_CACHE_LAYOUT = (unsigned int)(sizeof(cVector3d) | (sizeof(cColorf) << 8) | (sizeof(unsigned int) << 16) | (sizeof(int) << 24));
+
+// vertex arrays stored for a mesh
+const unsigned int C_MODEL_CACHE_NORMAL     = 0x01;
+const unsigned int C_MODEL_CACHE_TEXCOORD   = 0x02;
+const unsigned int C_MODEL_CACHE_COLOR      = 0x04;
+const unsigned int C_MODEL_CACHE_TANGENT    = 0x08;
+const unsigned int C_MODEL_CACHE_BITANGENT  = 0x10;
+const unsigned int C_MODEL_CACHE_USER_DATA  = 0x20;
+
+// rendering options of an object
+const unsigned int C_MODEL_CACHE_USE_MATERIAL       = 0x01;
+const unsigned int C_MODEL_CACHE_USE_TRANSPARENCY   = 0x02;
+const unsigned int C_MODEL_CACHE_USE_VERTEX_COLORS  = 0x04;
+const unsigned int C_MODEL_CACHE_USE_TEXTURE        = 0x08;
+
+//! Header at the start of a model cache, followed by one cModelCacheMesh per mesh.
+struct cModelCacheHeader
+{
+    char m_magic[8];
+    unsigned int m_version;
+    unsigned int m_layout;
+    unsigned long long m_sourceHash;
+    unsigned int m_numMeshes;
+    unsigned int m_options;
+};
+
+//! Entry of the material table. The data of the meshes follows the table, in the same order.
+struct cModelCacheMesh
+{
+    unsigned int m_numVertices;
+    unsigned int m_numTriangles;
+    unsigned int m_arrays;
+    unsigned int m_options;
+    unsigned int m_nameLength;
+    unsigned int m_textureLength;
+    float m_ambient[4];
+    float m_diffuse[4];
+    float m_specular[4];
+    float m_emission[4];
+    unsigned int m_shininess;
+    unsigned int m_reserved;
+};
+
+//------------------------------------------------------------------------------
+
+// every block of a cache starts on an 8 byte boundary
+static size_t padModelCacheSize(size_t a_size)
+{
+    return ((a_size + 7) & ~(size_t)7);
+}
+
+//------------------------------------------------------------------------------
+
+// bytes of data following the material table for a mesh
+static size_t getModelCacheMeshSize(const cModelCacheMesh& a_mesh)
+{
+    size_t n = a_mesh.m_numVertices;
+    size_t size = padModelCacheSize((size_t)a_mesh.m_nameLength + (size_t)a_mesh.m_textureLength);
+    size += n * sizeof(cVector3d);
+    if (a_mesh.m_arrays & C_MODEL_CACHE_NORMAL)     { size += n * sizeof(cVector3d); }
+    if (a_mesh.m_arrays & C_MODEL_CACHE_TEXCOORD)   { size += n * sizeof(cVector3d); }
+    if (a_mesh.m_arrays & C_MODEL_CACHE_COLOR)      { size += padModelCacheSize(n * sizeof(cColorf)); }
+    if (a_mesh.m_arrays & C_MODEL_CACHE_TANGENT)    { size += n * sizeof(cVector3d); }
+    if (a_mesh.m_arrays & C_MODEL_CACHE_BITANGENT)  { size += n * sizeof(cVector3d); }
+    if (a_mesh.m_arrays & C_MODEL_CACHE_USER_DATA)  { size += padModelCacheSize(n * sizeof(int)); }
+    size += padModelCacheSize(3 * (size_t)a_mesh.m_numTriangles * sizeof(unsigned int));
+    return (size);
+}
+
+//------------------------------------------------------------------------------
+
+// rendering options of an object as stored in a cache
+static unsigned int getModelCacheOptions(cGenericObject* a_object)
+{
+    unsigned int options = 0;
+    if (a_object->getUseMaterial())      { options |= C_MODEL_CACHE_USE_MATERIAL; }
+    if (a_object->getUseTransparency())  { options |= C_MODEL_CACHE_USE_TRANSPARENCY; }
+    if (a_object->getUseVertexColors())  { options |= C_MODEL_CACHE_USE_VERTEX_COLORS; }
+    if (a_object->getUseTexture())       { options |= C_MODEL_CACHE_USE_TEXTURE; }
+    return (options);
+}
+
+//------------------------------------------------------------------------------
+
+// applies rendering options read from a cache to an object only
+static void setModelCacheOptions(cGenericObject* a_object, const unsigned int a_options)
+{
+    a_object->setUseMaterial((a_options & C_MODEL_CACHE_USE_MATERIAL) != 0, false);
+    a_object->setUseTransparency((a_options & C_MODEL_CACHE_USE_TRANSPARENCY) != 0, false);
+    a_object->setUseVertexColors((a_options & C_MODEL_CACHE_USE_VERTEX_COLORS) != 0, false);
+    a_object->setUseTexture((a_options & C_MODEL_CACHE_USE_TEXTURE) != 0, false);
+}
+
+//------------------------------------------------------------------------------
+
+// copies an array out of the mapped cache and advances past it
+static void readModelCacheArray(void* a_array, const unsigned char*& a_data, const size_t a_size, const bool a_padded = false)
+{
+    if (a_size > 0)
+    {
+        memcpy(a_array, a_data, a_size);
+    }
+    a_data += a_padded ? padModelCacheSize(a_size) : a_size;
+}
+
+//------------------------------------------------------------------------------
+
+// writes an array to a cache, padded to the next block if requested
+static void writeModelCacheArray(const void* a_array, FILE* a_file, const size_t a_size, const bool a_padded = false)
+{
+    if (a_size > 0)
+    {
+        fwrite(a_array, 1, a_size, a_file);
+    }
+    if (a_padded)
+    {
+        const char zeros[8] = { 0 };
+        fwrite(zeros, 1, padModelCacheSize(a_size) - a_size, a_file);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// material colors are stored without their color flag
+static void copyModelCacheColor(float a_values[4], const cColorf& a_color)
+{
+    for (int i=0; i<4; i++) { a_values[i] = a_color.m_color[i]; }
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    This function loads a model cache into a cMultiMesh structure. The cache
+    is memory mapped and every vertex and triangle array is copied straight
+    into the storage of the new meshes. The cache is only loaded if its
+    version and memory layout match this build and if it was built from
+    source files with the given hash. Otherwise the function returns
+    __false__ and leaves the object untouched, and the caller should load the
+    source files instead.
+
+    \param  a_object      Multimesh object.
+    \param  a_filename    Filename of the cache.
+    \param  a_sourceHash  Hash of the source files the cache must be built from.
+
+    \return __true__ if in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cLoadFileModelCache(cMultiMesh* a_object, const std::string& a_filename, const unsigned long long a_sourceHash)
+{
+    cMappedFile file;
+    if (!file.open(a_filename)) { return (C_ERROR); }
+
+    const unsigned char* data = file.getData();
+    size_t size = file.getSize();
+
+    /////////////////////////////////////////////////////////////////////////
+    // CHECK THAT THE CACHE IS CURRENT AND COMPLETE
+    /////////////////////////////////////////////////////////////////////////
+
+    cModelCacheHeader header;
+    if (size < sizeof(header)) { return (C_ERROR); }
+    memcpy(&header, data, sizeof(header));
+
+    if ((memcmp(header.m_magic, C_MODEL_CACHE_MAGIC, sizeof(C_MODEL_CACHE_MAGIC)) != 0) ||
+        (header.m_version != C_MODEL_CACHE_VERSION) ||
+        (header.m_layout != C_MODEL_CACHE_LAYOUT) ||
+        (header.m_sourceHash != a_sourceHash))
+    {
+        return (C_ERROR);
+    }
+
+    // read the material table
+    size_t offset = sizeof(header);
+    if (header.m_numMeshes > (size - offset) / sizeof(cModelCacheMesh)) { return (C_ERROR); }
+
+    vector<cModelCacheMesh> meshes(header.m_numMeshes);
+    vector<size_t> offsets(header.m_numMeshes);
+    if (header.m_numMeshes > 0)
+    {
+        memcpy(&meshes[0], data + offset, header.m_numMeshes * sizeof(cModelCacheMesh));
+    }
+    offset += header.m_numMeshes * sizeof(cModelCacheMesh);
+
+    // every mesh must lie within the file, and nothing may follow the last one
+    for (unsigned int i=0; i<header.m_numMeshes; i++)
+    {
+        size_t meshSize = getModelCacheMeshSize(meshes[i]);
+        if (meshSize > size - offset) { return (C_ERROR); }
+        offsets[i] = offset;
+        offset += meshSize;
+
+        // a damaged cache must not leave triangles pointing outside the vertex array
+        size_t numIndices = 3 * (size_t)meshes[i].m_numTriangles;
+        const unsigned int* indices = (const unsigned int*)(data + offset - padModelCacheSize(numIndices * sizeof(unsigned int)));
+        for (size_t j=0; j<numIndices; j++)
+        {
+            if (indices[j] >= meshes[i].m_numVertices) { return (C_ERROR); }
+        }
+    }
+    if (offset != size) { return (C_ERROR); }
+
+    /////////////////////////////////////////////////////////////////////////
+    // BUILD THE MESHES
+    /////////////////////////////////////////////////////////////////////////
+
+    try
+    {
+        // clear all vertices and triangle of current mesh
+        a_object->deleteAllMeshes();
+
+        for (unsigned int i=0; i<header.m_numMeshes; i++)
+        {
+            const cModelCacheMesh& entry = meshes[i];
+            const unsigned char* block = data + offsets[i];
+            cMesh* mesh = a_object->newMesh();
+
+            // name and material
+            mesh->m_name.assign((const char*)(block), entry.m_nameLength);
+            string textureFilename((const char*)(block + entry.m_nameLength), entry.m_textureLength);
+            block += padModelCacheSize((size_t)entry.m_nameLength + (size_t)entry.m_textureLength);
+
+            mesh->m_material->m_ambient.set(entry.m_ambient[0], entry.m_ambient[1], entry.m_ambient[2], entry.m_ambient[3]);
+            mesh->m_material->m_diffuse.set(entry.m_diffuse[0], entry.m_diffuse[1], entry.m_diffuse[2], entry.m_diffuse[3]);
+            mesh->m_material->m_specular.set(entry.m_specular[0], entry.m_specular[1], entry.m_specular[2], entry.m_specular[3]);
+            mesh->m_material->m_emission.set(entry.m_emission[0], entry.m_emission[1], entry.m_emission[2], entry.m_emission[3]);
+            mesh->m_material->setShininess(entry.m_shininess);
+
+            // textures are not cached, they are loaded from the file the model used
+            unsigned int options = entry.m_options;
+            if (textureFilename.size() > 0)
+            {
+                cTexture2dPtr texture = cTexture2d::create();
+                if (texture->loadFromFile(textureFilename))
+                {
+                    mesh->setTexture(texture);
+                }
+                else
+                {
+                    options &= ~C_MODEL_CACHE_USE_TEXTURE;
+                }
+            }
+            setModelCacheOptions(mesh, options);
+
+            // vertices
+            size_t n = entry.m_numVertices;
+            cVertexArrayPtr vertices = mesh->m_vertices;
+            if (n > 0)
+            {
+                vertices->allocateData((int)n,
+                                       (entry.m_arrays & C_MODEL_CACHE_NORMAL) != 0,
+                                       (entry.m_arrays & C_MODEL_CACHE_TEXCOORD) != 0,
+                                       (entry.m_arrays & C_MODEL_CACHE_COLOR) != 0,
+                                       (entry.m_arrays & C_MODEL_CACHE_TANGENT) != 0,
+                                       (entry.m_arrays & C_MODEL_CACHE_BITANGENT) != 0,
+                                       (entry.m_arrays & C_MODEL_CACHE_USER_DATA) != 0);
+
+                readModelCacheArray(&vertices->m_localPos[0], block, n * sizeof(cVector3d));
+                if (entry.m_arrays & C_MODEL_CACHE_NORMAL)      { readModelCacheArray(&vertices->m_normal[0], block, n * sizeof(cVector3d)); }
+                if (entry.m_arrays & C_MODEL_CACHE_TEXCOORD)    { readModelCacheArray(&vertices->m_texCoord[0], block, n * sizeof(cVector3d)); }
+                if (entry.m_arrays & C_MODEL_CACHE_COLOR)       { readModelCacheArray(&vertices->m_color[0], block, n * sizeof(cColorf), true); }
+                if (entry.m_arrays & C_MODEL_CACHE_TANGENT)     { readModelCacheArray(&vertices->m_tangent[0], block, n * sizeof(cVector3d)); }
+                if (entry.m_arrays & C_MODEL_CACHE_BITANGENT)   { readModelCacheArray(&vertices->m_bitangent[0], block, n * sizeof(cVector3d)); }
+                if (entry.m_arrays & C_MODEL_CACHE_USER_DATA)   { readModelCacheArray(&vertices->m_userData[0], block, n * sizeof(int), true); }
+            }
+
+            // triangles
+            size_t numIndices = 3 * (size_t)entry.m_numTriangles;
+            cTriangleArrayPtr triangles = mesh->m_triangles;
+            triangles->m_indices.resize(numIndices);
+            readModelCacheArray(numIndices > 0 ? &triangles->m_indices[0] : NULL, block, numIndices * sizeof(unsigned int), true);
+            triangles->m_allocated.assign(entry.m_numTriangles, true);
+            triangles->m_flagMarkForResize = true;
+            triangles->m_flagMarkForUpdate = true;
+
+            mesh->markForUpdate(false);
+        }
+
+        setModelCacheOptions(a_object, header.m_options);
+
+        // compute boundary boxes
+        a_object->computeBoundaryBox(true);
+
+        // update global position in world
+        a_object->computeGlobalPositionsFromRoot(true);
+
+        return (C_SUCCESS);
+    }
+    catch (...)
+    {
+        return (C_ERROR);
+    }
+}
+
+
+//==============================================================================
+/*!
+    This function saves the meshes of a cMultiMesh structure to a model cache,
+    tagged with the hash of the source files they were loaded from. Textures
+    are referenced by the filename of their image. The cache is written under
+    a temporary name and renamed once complete, so a partly written cache is
+    never loaded.
+
+    \param  a_object      Multimesh object.
+    \param  a_filename    Filename of the cache.
+    \param  a_sourceHash  Hash of the source files the object was loaded from.
+
+    \return __true__ if in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cSaveFileModelCache(cMultiMesh* a_object, const std::string& a_filename, const unsigned long long a_sourceHash)
+{
+    /////////////////////////////////////////////////////////////////////////
+    // BUILD THE MATERIAL TABLE
+    /////////////////////////////////////////////////////////////////////////
+
+    unsigned int numMeshes = a_object->getNumMeshes();
+    vector<cModelCacheMesh> meshes(numMeshes);
+    vector<string> textures(numMeshes);
+
+    for (unsigned int i=0; i<numMeshes; i++)
+    {
+        cMesh* mesh = a_object->getMesh(i);
+        cVertexArrayPtr vertices = mesh->m_vertices;
+        cModelCacheMesh& entry = meshes[i];
+        memset(&entry, 0, sizeof(entry));
+
+        if ((mesh->m_texture != nullptr) && (mesh->m_texture->m_image != nullptr))
+        {
+            textures[i] = mesh->m_texture->m_image->getFilename();
+        }
+
+        entry.m_numVertices = vertices->getNumElements();
+        for (unsigned int j=0; j<mesh->m_triangles->getNumElements(); j++)
+        {
+            if (mesh->m_triangles->m_allocated[j]) { entry.m_numTriangles++; }
+        }
+
+        if (vertices->getUseNormalData())       { entry.m_arrays |= C_MODEL_CACHE_NORMAL; }
+        if (vertices->getUseTexCoordData())     { entry.m_arrays |= C_MODEL_CACHE_TEXCOORD; }
+        if (vertices->getUseColorData())        { entry.m_arrays |= C_MODEL_CACHE_COLOR; }
+        if (vertices->getUseTangentData())      { entry.m_arrays |= C_MODEL_CACHE_TANGENT; }
+        if (vertices->getUseBitangentData())    { entry.m_arrays |= C_MODEL_CACHE_BITANGENT; }
+        if (vertices->getUseUserData())         { entry.m_arrays |= C_MODEL_CACHE_USER_DATA; }
+
+        entry.m_options = getModelCacheOptions(mesh);
+        entry.m_nameLength = (unsigned int)(mesh->m_name.size());
+        entry.m_textureLength = (unsigned int)(textures[i].size());
+
+        copyModelCacheColor(entry.m_ambient, mesh->m_material->m_ambient);
+        copyModelCacheColor(entry.m_diffuse, mesh->m_material->m_diffuse);
+        copyModelCacheColor(entry.m_specular, mesh->m_material->m_specular);
+        copyModelCacheColor(entry.m_emission, mesh->m_material->m_emission);
+        entry.m_shininess = mesh->m_material->getShininess();
+    }
+
+    cModelCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_magic, C_MODEL_CACHE_MAGIC, sizeof(C_MODEL_CACHE_MAGIC));
+    header.m_version = C_MODEL_CACHE_VERSION;
+    header.m_layout = C_MODEL_CACHE_LAYOUT;
+    header.m_sourceHash = a_sourceHash;
+    header.m_numMeshes = numMeshes;
+    header.m_options = getModelCacheOptions(a_object);
+
+    /////////////////////////////////////////////////////////////////////////
+    // WRITE THE CACHE
+    /////////////////////////////////////////////////////////////////////////
+
+    string tempFilename = a_filename + ".tmp";
+    FILE* file = fopen(tempFilename.c_str(), "wb");
+    if (file == NULL) { return (C_ERROR); }
+
+    fwrite(&header, sizeof(header), 1, file);
+    if (numMeshes > 0)
+    {
+        fwrite(&meshes[0], sizeof(cModelCacheMesh), numMeshes, file);
+    }
+
+    for (unsigned int i=0; i<numMeshes; i++)
+    {
+        cMesh* mesh = a_object->getMesh(i);
+        cVertexArrayPtr vertices = mesh->m_vertices;
+        const cModelCacheMesh& entry = meshes[i];
+        size_t n = entry.m_numVertices;
+
+        string strings = mesh->m_name + textures[i];
+        writeModelCacheArray(strings.c_str(), file, strings.size(), true);
+
+        if (n > 0)
+        {
+            writeModelCacheArray(&vertices->m_localPos[0], file, n * sizeof(cVector3d));
+            if (entry.m_arrays & C_MODEL_CACHE_NORMAL)      { writeModelCacheArray(&vertices->m_normal[0], file, n * sizeof(cVector3d)); }
+            if (entry.m_arrays & C_MODEL_CACHE_TEXCOORD)    { writeModelCacheArray(&vertices->m_texCoord[0], file, n * sizeof(cVector3d)); }
+            if (entry.m_arrays & C_MODEL_CACHE_COLOR)       { writeModelCacheArray(&vertices->m_color[0], file, n * sizeof(cColorf), true); }
+            if (entry.m_arrays & C_MODEL_CACHE_TANGENT)     { writeModelCacheArray(&vertices->m_tangent[0], file, n * sizeof(cVector3d)); }
+            if (entry.m_arrays & C_MODEL_CACHE_BITANGENT)   { writeModelCacheArray(&vertices->m_bitangent[0], file, n * sizeof(cVector3d)); }
+            if (entry.m_arrays & C_MODEL_CACHE_USER_DATA)   { writeModelCacheArray(&vertices->m_userData[0], file, n * sizeof(int), true); }
+        }
+
+        // free triangle slots are left out
+        vector<unsigned int> indices;
+        indices.reserve(3 * (size_t)entry.m_numTriangles);
+        cTriangleArrayPtr triangles = mesh->m_triangles;
+        for (unsigned int j=0; j<triangles->getNumElements(); j++)
+        {
+            if (triangles->m_allocated[j])
+            {
+                indices.push_back(triangles->m_indices[3*j+0]);
+                indices.push_back(triangles->m_indices[3*j+1]);
+                indices.push_back(triangles->m_indices[3*j+2]);
+            }
+        }
+        writeModelCacheArray(indices.size() > 0 ? &indices[0] : NULL, file, indices.size() * sizeof(unsigned int), true);
+    }
+
+    bool failed = (ferror(file) != 0);
+    if ((fclose(file) != 0) || failed)
+    {
+        remove(tempFilename.c_str());
+        return (C_ERROR);
+    }
+
+    // replace any previous cache
+    remove(a_filename.c_str());
+    if (rename(tempFilename.c_str(), a_filename.c_str()) != 0)
+    {
+        remove(tempFilename.c_str());
+        return (C_ERROR);
+    }
+
+    return (C_SUCCESS);
+}
+
+
+//==============================================================================
+/*!
+    This function accumulates a block of data into a 64 bit FNV-1a hash, used
+    to tell whether a model cache was built from the current source files.
+    Several blocks are hashed by passing the result of one call to the next.
+
+    \param  a_data  Data to hash.
+    \param  a_size  Size of the data in bytes.
+    \param  a_hash  Hash of the preceding blocks.
+
+    \return Hash including the block.
+*/
+//==============================================================================
+unsigned long long cHashModelCacheData(const void* a_data, const size_t a_size, const unsigned long long a_hash)
+{
+    const unsigned char* data = (const unsigned char*)(a_data);
+    unsigned long long hash = a_hash;
+    for (size_t i=0; i<a_size; i++)
+    {
+        hash = (hash ^ data[i]) * 1099511628211ULL;
+    }
+    return (hash);
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,115 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Brandon Sieu, Glenn Skelton
+    \version   3.2.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CFileModelCacheH
+#define CFileModelCacheH
+//------------------------------------------------------------------------------
+#include "world/CMultiMesh.h"
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CFileModelCache.h
+    \ingroup    files
+
+    \brief
+    Implements precompiled binary model caches.
+
+    \details
+    A model cache holds a cMultiMesh exactly as a model loader built it: the
+    material table of its meshes followed by their vertex and triangle arrays,
+    packed in the memory layout of cVertexArray and cTriangleArray. Loading a
+    cache maps the file into memory and copies each array into place with a
+    single block copy, so no text is parsed and no vertex is created one at a
+    time. \n
+    Every cache records a hash of the source files it was built from. A cache
+    whose version, memory layout or hash does not match is ignored, and the
+    loader is expected to parse the source again and write a new cache.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// GENERAL CONSTANTS
+//------------------------------------------------------------------------------
+
+//! Version of the model cache format. Caches of any other version are ignored.
+const unsigned int C_MODEL_CACHE_VERSION = 1;
+
+//! Extension appended to the name of a model file to name its cache.
+const char C_MODEL_CACHE_EXTENSION[] = ".cmesh";
+
+//! Initial value of a model cache hash.
+const unsigned long long C_MODEL_CACHE_HASH_SEED = 14695981039346656037ULL;
+
+
+//------------------------------------------------------------------------------
+/*!
+    \addtogroup files
+*/
+//------------------------------------------------------------------------------
+
+//@{
+
+//! This function loads a model cache if it was built from sources matching a hash.
+bool cLoadFileModelCache(cMultiMesh* a_object, const std::string& a_filename, const unsigned long long a_sourceHash);
+
+//! This function saves a model cache.
+bool cSaveFileModelCache(cMultiMesh* a_object, const std::string& a_filename, const unsigned long long a_sourceHash);
+
+//! This function accumulates a block of data into a model cache hash.
+unsigned long long cHashModelCacheData(const void* a_data, const size_t a_size, const unsigned long long a_hash = C_MODEL_CACHE_HASH_SEED);
+
+//@}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
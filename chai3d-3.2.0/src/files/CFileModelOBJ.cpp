@@ -44,6 +44,8 @@
 
 //------------------------------------------------------------------------------
 #include "files/CFileModelOBJ.h"
+#include "files/CFileModelCache.h"
+#include "system/CMappedFile.h"
 //------------------------------------------------------------------------------
 #include <iostream>
 #include <iomanip>
@@ -52,6 +54,7 @@
 #include <algorithm>
 #include <string>
 #include <cstring>
+#include <thread>
 //------------------------------------------------------------------------------
 using namespace std;
 //------------------------------------------------------------------------------
@@ -63,6 +66,8 @@ namespace chai3d {
 
 //------------------------------------------------------------------------------
 bool g_objLoaderShouldGenerateExtraVertices = false;
+bool g_objLoaderShouldUseCache = false;
+unsigned int g_objLoaderNumThreads = 0;
 //------------------------------------------------------------------------------
 
 //==============================================================================
@@ -80,6 +85,15 @@ bool g_objLoaderShouldGenerateExtraVertices = false;
 //==============================================================================
 bool cLoadFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
 {
+    // load the precompiled cache instead if it was built from this very file
+    unsigned long long sourceHash = 0;
+    string cacheFilename = a_filename + C_MODEL_CACHE_EXTENSION;
+    if (g_objLoaderShouldUseCache)
+    {
+        if (!cHashFileOBJ(a_filename, sourceHash)) { return (C_ERROR); }
+        if (cLoadFileModelCache(a_object, cacheFilename, sourceHash)) { return (C_SUCCESS); }
+    }
+
     try
     {
         cOBJModel fileObj;
@@ -354,6 +368,12 @@ bool cLoadFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
         // update global position in world
         a_object->computeGlobalPositionsFromRoot(true);
 
+        // write the cache for the next load, a model that cannot be cached still loaded fine
+        if (g_objLoaderShouldUseCache)
+        {
+            cSaveFileModelCache(a_object, cacheFilename, sourceHash);
+        }
+
         // return success
         return (C_SUCCESS);
     }
@@ -586,8 +606,323 @@ bool cSaveFileOBJ(cMultiMesh* a_object, const std::string& a_filename)
 }
 
 
+//==============================================================================
+/*!
+    This function computes the hash identifying the model cache of an OBJ
+    file. The hash covers the content of the OBJ file, of the material
+    libraries it references and the loader options that change the meshes
+    built from them, so any edit to these files gives a different hash.
+
+    \param  a_filename  Filename.
+    \param  a_hash      Returned hash.
+
+    \return __true__ if in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cHashFileOBJ(const std::string& a_filename, unsigned long long& a_hash)
+{
+    cMappedFile file;
+    if (!file.open(a_filename)) { return (C_ERROR); }
+
+    const char* data = (const char*)(file.getData());
+    size_t size = file.getSize();
+    unsigned long long hash = cHashModelCacheData(data, size);
+
+    // the same file gives other meshes when vertices are not shared
+    unsigned char options = g_objLoaderShouldGenerateExtraVertices ? 1 : 0;
+    hash = cHashModelCacheData(&options, sizeof(options), hash);
+
+    // material libraries are found relative to the model, as the parser does
+    size_t slash = a_filename.find_last_of("/\\");
+    string basePath = (slash == string::npos) ? "" : a_filename.substr(0, slash + 1);
+    size_t idLength = strlen(C_OBJ_MTL_LIB_ID);
+
+    size_t start = 0;
+    while (start < size)
+    {
+        size_t end = start;
+        while ((end < size) && (data[end] != '\n')) { end++; }
+
+        // "mtllib" followed by the name of the library
+        size_t i = start;
+        while ((i < end) && ((data[i] == ' ') || (data[i] == '\t'))) { i++; }
+        if ((end - i > idLength) &&
+            (strncmp(data + i, C_OBJ_MTL_LIB_ID, idLength) == 0) &&
+            ((data[i + idLength] == ' ') || (data[i + idLength] == '\t')))
+        {
+            i = i + idLength;
+            while ((i < end) && ((data[i] == ' ') || (data[i] == '\t'))) { i++; }
+            size_t last = end;
+            while ((last > i) && (data[last - 1] == '\r')) { last--; }
+
+            cMappedFile library;
+            if (library.open(basePath + string(data + i, last - i)))
+            {
+                hash = cHashModelCacheData(library.getData(), library.getSize(), hash);
+            }
+        }
+
+        start = end + 1;
+    }
+
+    a_hash = hash;
+
+    return (C_SUCCESS);
+}
+
+
 //------------------------------------------------------------------------------
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+//==============================================================================
+// OBJ PARSER HELPERS:
+//==============================================================================
+
+// powers of ten exactly representable as doubles
+static const double s_objPowersOfTen[] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+//------------------------------------------------------------------------------
+
+// white space separating the strings of a line
+static inline bool isOBJSpace(const char a_char)
+{
+    return ((a_char == ' ') || (a_char == '\t') || (a_char == '\r') || (a_char == '\v') || (a_char == '\f'));
+}
+
+//------------------------------------------------------------------------------
+
+// compares the first string of a line with an identifier
+static inline bool isOBJToken(const char* a_token, const size_t a_length, const char* a_id)
+{
+    return ((a_length == strlen(a_id)) && (memcmp(a_token, a_id, a_length) == 0));
+}
+
+//------------------------------------------------------------------------------
+
+// skips the character a_char if it is next in the line
+static inline bool matchOBJChar(const char*& a_str, const char* a_end, const char a_char)
+{
+    if ((a_str < a_end) && (*a_str == a_char))
+    {
+        a_str++;
+        return (true);
+    }
+    return (false);
+}
+
+//------------------------------------------------------------------------------
+
+// start of the parameter following the first string of a line
+static const char* getOBJParameter(const char* a_str, const char* a_end)
+{
+    while ((a_str < a_end) && (*a_str == ' ')) { a_str++; }
+    return (a_str);
+}
+
+//------------------------------------------------------------------------------
+
+// end of the parameter of a line, without the carriage return of DOS files
+static const char* getOBJParameterEnd(const char* a_str, const char* a_end)
+{
+    if ((a_end > a_str) && (a_end[-1] == '\r')) { a_end--; }
+    return (a_end);
+}
+
+//------------------------------------------------------------------------------
+
+// copies the string starting at a_str into a null terminated buffer
+static size_t copyOBJString(const char* a_str, const char* a_end, char* a_buffer, const size_t a_size)
+{
+    size_t length = 0;
+    while ((a_str + length < a_end) && (length + 1 < a_size) && !isOBJSpace(a_str[length]))
+    {
+        a_buffer[length] = a_str[length];
+        length++;
+    }
+    a_buffer[length] = '\0';
+    return (length);
+}
+
+//------------------------------------------------------------------------------
+
+// reads a float like fscanf "%f" would, returns false if there is none
+static bool parseOBJFloat(const char*& a_str, const char* a_end, float& a_value)
+{
+    const char* str = a_str;
+    while ((str < a_end) && isOBJSpace(*str)) { str++; }
+    const char* start = str;
+
+    // sign, digits, decimals and exponent of a plain decimal number
+    bool negative = false;
+    if ((str < a_end) && ((*str == '-') || (*str == '+')))
+    {
+        negative = (*str == '-');
+        str++;
+    }
+
+    unsigned long long mantissa = 0;
+    int numDigits = 0;
+    int numSignificant = 0;
+    int exponent = 0;
+    while ((str < a_end) && (*str >= '0') && (*str <= '9'))
+    {
+        mantissa = 10 * mantissa + (*str - '0');
+        if (mantissa > 0) { numSignificant++; }
+        numDigits++;
+        str++;
+    }
+    if ((str < a_end) && (*str == '.'))
+    {
+        str++;
+        while ((str < a_end) && (*str >= '0') && (*str <= '9'))
+        {
+            mantissa = 10 * mantissa + (*str - '0');
+            if (mantissa > 0) { numSignificant++; }
+            numDigits++;
+            exponent--;
+            str++;
+        }
+    }
+    bool plain = (numDigits > 0) && (numSignificant <= 18);
+    if (plain && (str < a_end) && ((*str == 'e') || (*str == 'E')))
+    {
+        str++;
+        bool negativeExponent = false;
+        if ((str < a_end) && ((*str == '-') || (*str == '+')))
+        {
+            negativeExponent = (*str == '-');
+            str++;
+        }
+        int value = 0;
+        int numExponentDigits = 0;
+        while ((str < a_end) && (*str >= '0') && (*str <= '9') && (numExponentDigits < 4))
+        {
+            value = 10 * value + (*str - '0');
+            numExponentDigits++;
+            str++;
+        }
+        plain = (numExponentDigits > 0);
+        exponent += negativeExponent ? -value : value;
+    }
+    plain = plain && ((str == a_end) || isOBJSpace(*str));
+
+    // numbers whose exact value rounds once to the nearest float are converted
+    // directly, as they give the same float as the C library would
+    const double maxExact = 9007199254740992.0;
+    if (plain && (mantissa < (1ULL << 53)))
+    {
+        double value = -1.0;
+        if ((exponent >= 0) && (exponent <= 22))
+        {
+            value = (double)(mantissa) * s_objPowersOfTen[exponent];
+            if (value >= maxExact) { value = -1.0; }
+        }
+        else if ((exponent < 0) && (exponent >= -10))
+        {
+            value = (double)(mantissa) / s_objPowersOfTen[-exponent];
+        }
+
+        if (value >= 0.0)
+        {
+            a_value = (float)(negative ? -value : value);
+            a_str = str;
+            return (true);
+        }
+    }
+
+    // anything else is left to the C library
+    char buffer[128];
+    copyOBJString(start, a_end, buffer, sizeof(buffer));
+    char* end = NULL;
+    float value = strtof(buffer, &end);
+    if (end == buffer)
+    {
+        return (false);
+    }
+    a_value = value;
+    a_str = start + (end - buffer);
+    return (true);
+}
+
+//------------------------------------------------------------------------------
+
+// reads an integer like fscanf "%i" would, returns false if there is none
+static bool parseOBJInt(const char*& a_str, const char* a_end, int& a_value)
+{
+    const char* str = a_str;
+    while ((str < a_end) && isOBJSpace(*str)) { str++; }
+    const char* start = str;
+
+    // plain decimal numbers
+    bool negative = false;
+    if ((str < a_end) && ((*str == '-') || (*str == '+')))
+    {
+        negative = (*str == '-');
+        str++;
+    }
+    if ((str < a_end) && (*str >= '1') && (*str <= '9'))
+    {
+        int value = 0;
+        int numDigits = 0;
+        while ((str < a_end) && (*str >= '0') && (*str <= '9') && (numDigits < 9))
+        {
+            value = 10 * value + (*str - '0');
+            numDigits++;
+            str++;
+        }
+        if ((str == a_end) || (*str < '0') || (*str > '9'))
+        {
+            a_value = negative ? -value : value;
+            a_str = str;
+            return (true);
+        }
+    }
+
+    // octal, hexadecimal and large numbers are left to the C library
+    char buffer[128];
+    copyOBJString(start, a_end, buffer, sizeof(buffer));
+    char* end = NULL;
+    long value = strtol(buffer, &end, 0);
+    if (end == buffer)
+    {
+        return (false);
+    }
+    a_value = (int)(value);
+    a_str = start + (end - buffer);
+    return (true);
+}
+
+//------------------------------------------------------------------------------
+
+// runs a_function on every chunk, the first one on the calling thread
+static void runOBJChunks(std::vector<cOBJChunk>& a_chunks, void (*a_function)(cOBJChunk*))
+{
+    std::vector<std::thread> threads;
+    for (size_t i=1; i<a_chunks.size(); i++)
+    {
+        try
+        {
+            threads.push_back(std::thread(a_function, &a_chunks[i]));
+        }
+        catch (...)
+        {
+            // no more threads available
+            a_function(&a_chunks[i]);
+        }
+    }
+
+    a_function(&a_chunks[0]);
+
+    for (size_t i=0; i<threads.size(); i++)
+    {
+        threads[i].join();
+    }
+}
+
 //------------------------------------------------------------------------------
 //==============================================================================
 // OBJ PARSER IMPLEMENTATION:
@@ -638,35 +973,90 @@ cOBJModel::~cOBJModel()
 bool cOBJModel::LoadModel(const char a_fileName[])
 {
     /////////////////////////////////////////////////////////////////////////
-    // LOAD A OBJ FILE AND RENDER ITS DATA INTO A DISPLAY LIST
+    // LOAD A OBJ FILE BY PARSING CHUNKS OF IT IN PARALLEL
     /////////////////////////////////////////////////////////////////////////
 
     cOBJFileInfo currentIndex;          // current array index
-    char str[C_OBJ_MAX_STR_SIZE] = "";  // buffer string for reading the file
     char basePath[C_OBJ_SIZE_PATH];     // path were all paths in the OBJ start
-    unsigned int curMaterial = 0;       // current material
 
     // get base path
     strcpy(basePath, a_fileName);
     makePath(basePath);
 
     /////////////////////////////////////////////////////////////////////////
-    // OPEN THE OBJ FILE
+    // MAP THE OBJ FILE INTO MEMORY
     /////////////////////////////////////////////////////////////////////////
-    FILE *hFile = fopen(a_fileName, "r");
+    cMappedFile file;
 
     // success opening file?
-    if (!hFile)
+    if (!file.open(a_fileName))
     {
         return (false);
     }
 
+    const char* data = (const char*)(file.getData());
+    size_t size = file.getSize();
+
+    /////////////////////////////////////////////////////////////////////////
+    // SPLIT THE FILE INTO CHUNKS AT LINE BOUNDARIES AND PARSE THEM
+    /////////////////////////////////////////////////////////////////////////
+
+    unsigned int numThreads = g_objLoaderNumThreads;
+    if (numThreads == 0)
+    {
+        numThreads = cMax(std::thread::hardware_concurrency(), 1u);
+    }
+    size_t numChunks = cMax(cMin((size_t)(numThreads), size / C_OBJ_MIN_CHUNK_SIZE), (size_t)(1));
+
+    vector<cOBJChunk> chunks(numChunks);
+    const char* begin = data;
+    for (size_t i=0; i<numChunks; i++)
+    {
+        // each chunk ends after the first end of line past its share of the file
+        const char* end = data + size;
+        if (i+1 < numChunks)
+        {
+            end = cMax(data + (size * (i+1)) / numChunks, begin);
+            const char* newline = (const char*)(memchr(end, '\n', (data + size) - end));
+            end = (newline != NULL) ? newline + 1 : data + size;
+        }
+
+        chunks[i].m_model = this;
+        chunks[i].m_begin = begin;
+        chunks[i].m_end = end;
+        chunks[i].m_valid = false;
+        begin = end;
+    }
+
+    // vertices, normals, texture coordinates and faces of every chunk are read at once
+    runOBJChunks(chunks, parseChunk);
+
     /////////////////////////////////////////////////////////////////////////
     // ALLOCATE SPACE FOR STRUCTURES THAT HOLD THE MODEL DATA
     /////////////////////////////////////////////////////////////////////////
 
     // which data types are stored in the file? how many of each type?
-    getFileInfo(hFile, &m_OBJInfo, basePath);
+    m_OBJInfo.init();
+    for (size_t i=0; i<numChunks; i++)
+    {
+        if (!chunks[i].m_valid) { return (false); }
+
+        chunks[i].m_firstFace = m_OBJInfo.m_faceCount;
+        m_OBJInfo.m_vertexCount += (unsigned int)(chunks[i].m_vertices.size());
+        m_OBJInfo.m_texCoordCount += (unsigned int)(chunks[i].m_texCoords.size());
+        m_OBJInfo.m_normalCount += (unsigned int)(chunks[i].m_normals.size());
+        m_OBJInfo.m_faceCount += (unsigned int)(chunks[i].m_faces.size());
+
+        // materials of every library are counted before any of them is read
+        for (size_t j=0; j<chunks[i].m_records.size(); j++)
+        {
+            if (chunks[i].m_records[j].m_type == C_OBJ_RECORD_MTL_LIB)
+            {
+                string libraryFile = basePath + chunks[i].m_records[j].m_parameter;
+                m_OBJInfo.m_materialCount += countMaterials(libraryFile.c_str());
+            }
+        }
+    }
 
     // vertices and faces
     if (m_pVertices) delete [] m_pVertices;
@@ -691,146 +1081,78 @@ bool cOBJModel::LoadModel(const char a_fileName[])
     currentIndex.init();
 
     /////////////////////////////////////////////////////////////////////////
-    // READ THE FILE CONTENTS
+    // MERGE THE CHUNKS IN FILE ORDER
     /////////////////////////////////////////////////////////////////////////
 
-    // start reading the file from the start
-    rewind(hFile);
+    unsigned int curMaterial = 0;       // current material
 
-    // quit reading when end of file has been reached
-    while (!feof(hFile))
+    for (size_t i=0; i<numChunks; i++)
     {
-        // get next string
-        readNextString(str, sizeof(str), hFile);
-
-        // next three elements are floats of a vertex
-        if (!strncmp(str, C_OBJ_VERTEX_ID, sizeof(C_OBJ_VERTEX_ID)))
+        cOBJChunk& chunk = chunks[i];
+
+        // vertex data goes after the data of the previous chunks
+        std::copy(chunk.m_vertices.begin(), chunk.m_vertices.end(), m_pVertices + currentIndex.m_vertexCount);
+        std::copy(chunk.m_colors.begin(), chunk.m_colors.end(), m_pColors + currentIndex.m_vertexCount);
+        std::copy(chunk.m_normals.begin(), chunk.m_normals.end(), m_pNormals + currentIndex.m_normalCount);
+        std::copy(chunk.m_texCoords.begin(), chunk.m_texCoords.end(), m_pTexCoords + currentIndex.m_texCoordCount);
+        currentIndex.m_vertexCount += (unsigned int)(chunk.m_vertices.size());
+        currentIndex.m_normalCount += (unsigned int)(chunk.m_normals.size());
+        currentIndex.m_texCoordCount += (unsigned int)(chunk.m_texCoords.size());
+
+        // groups and materials depend on every record before them in the file
+        chunk.m_numGroupsBefore = (unsigned int)(m_groupNames.size());
+        chunk.m_materialBefore = curMaterial;
+
+        for (size_t j=0; j<chunk.m_records.size(); j++)
         {
-            // read three floats out of the file
-            float fx = 0.0f, fy = 0.0f, fz = 0.0f, cr = 0.0f, cg = 0.0f, cb = 0.0f;
-            if (fscanf(hFile, "%f %f %f %f %f %f", &fx, &fy, &fz, &cr, &cg, &cb) > 0)
-            {
-                m_pVertices[currentIndex.m_vertexCount](0)  = fx;
-                m_pVertices[currentIndex.m_vertexCount](1)  = fy;
-                m_pVertices[currentIndex.m_vertexCount](2)  = fz;
-                m_pColors[currentIndex.m_vertexCount].set(cr, cg, cb);
-                m_pColors[currentIndex.m_vertexCount].m_flag_color = true;
-            }
-            else if (fscanf(hFile, "%f %f %f", &fx, &fy, &fz) > 0)
-            {
-                m_pVertices[currentIndex.m_vertexCount](0)  = fx;
-                m_pVertices[currentIndex.m_vertexCount](1)  = fy;
-                m_pVertices[currentIndex.m_vertexCount](2)  = fz;
-                m_pColors[currentIndex.m_vertexCount].set(0,0,0);
-                m_pColors[currentIndex.m_vertexCount].m_flag_color = false;
-            }
-
-            // next vertex
-            currentIndex.m_vertexCount++;
-        }
-
-        // next two elements are floats of a texture coordinate
-        else if (!strncmp(str, C_OBJ_TEXCOORD_ID, sizeof(C_OBJ_TEXCOORD_ID)))
-        {
-            // read two floats out of the file
-            float fx = 0.0f, fy = 0.0f, fz = 0.0f;
-            if (fscanf(hFile, "%f %f %f", &fx, &fy, &fz) > 0)
-            {
-                m_pTexCoords[currentIndex.m_texCoordCount](0)  = fx;
-                m_pTexCoords[currentIndex.m_texCoordCount](1)  = fy;
-                m_pTexCoords[currentIndex.m_texCoordCount](2)  = fz;
-            }
+            cOBJRecord& record = chunk.m_records[j];
 
-            // next texture coordinate
-            currentIndex.m_texCoordCount++;
-        }
-
-        // next three elements are floats of a vertex normal
-        else if (!strncmp(str, C_OBJ_NORMAL_ID, sizeof(C_OBJ_NORMAL_ID)))
-        {
-            // read three floats out of the file
-            float fx = 0.0f, fy = 0.0f, fz = 0.0f;
-            if (fscanf(hFile, "%f %f %f", &fx, &fy, &fz) > 0)
+            // name of the faces that follow
+            if (record.m_type == C_OBJ_RECORD_GROUP)
             {
-                m_pNormals[currentIndex.m_normalCount](0)  = fx;
-                m_pNormals[currentIndex.m_normalCount](1)  = fy;
-                m_pNormals[currentIndex.m_normalCount](2)  = fz;
+                char* name = new char[record.m_parameter.size()+1];
+                strcpy(name, record.m_parameter.c_str());
+                m_groupNames.push_back(name);
             }
 
-            // next normal
-            currentIndex.m_normalCount++;
-        }
-
-        // rest of the line contains face information
-        else if (!strncmp(str, C_OBJ_FACE_ID, sizeof(C_OBJ_FACE_ID)))
-        {
-            // read the rest of the line (the complete face)
-            getTokenParameter(str, sizeof(str) ,hFile);
-
-            // convert string into a face structure
-            parseFaceString(str, &m_pFaces[currentIndex.m_faceCount],
-            m_pVertices, m_pNormals, m_pTexCoords, curMaterial);
-            
-            // next face
-            currentIndex.m_faceCount++;
-        }
-
-        // rest of the line contains face information
-        else if (!strncmp(str, C_OBJ_NAME_ID, sizeof(C_OBJ_NAME_ID)))
-        {
-            // read the rest of the line (the complete face)
-            getTokenParameter(str, sizeof(str) ,hFile);
-
-            char* name = new char[strlen(str)+1];
-            strcpy(name,str);
-            m_groupNames.push_back(name);
-        }
-
-        // process material information only if needed
-        if (m_pMaterials)
-        {
-            // rest of the line contains the name of a material
-            if (!strncmp(str, C_OBJ_USE_MTL_ID, sizeof(C_OBJ_USE_MTL_ID)))
+            // process material information only if needed
+            else if (m_pMaterials)
             {
-                // read the rest of the line (the complete material name)
-                getTokenParameter(str, sizeof(str), hFile);
-
-                // are any materials loaded ?
-                if (m_pMaterials)
+                // name of the material of the faces that follow
+                if (record.m_type == C_OBJ_RECORD_USE_MTL)
                 {
                     // find material array index for the material name
-                    for (unsigned i=0; i<m_OBJInfo.m_materialCount; i++)
-                    if (!strncmp(m_pMaterials[i].m_name, str, sizeof(str)))
+                    for (unsigned k=0; k<m_OBJInfo.m_materialCount; k++)
+                    if (!strncmp(m_pMaterials[k].m_name, record.m_parameter.c_str(), C_OBJ_MAX_STR_SIZE))
                     {
-                        curMaterial = i;
+                        curMaterial = k;
                         break;
                     }
                 }
-            }
 
-            // rest of the line contains the filename of a material library
-            else if (!strncmp(str, C_OBJ_MTL_LIB_ID, sizeof(C_OBJ_MTL_LIB_ID)))
-            {
-                // read the rest of the line (the complete filename)
-                getTokenParameter(str, sizeof(str), hFile);
-
-                // append material library filename to the model's base path
-                char libraryFile[C_OBJ_SIZE_PATH];
-                strcpy(libraryFile, basePath);
-                strcat(libraryFile, str);
-
-                // append .mtl
-                // strcat(szLibraryFile, ".mtl");
+                // filename of a material library
+                else if (record.m_type == C_OBJ_RECORD_MTL_LIB)
+                {
+                    // append material library filename to the model's base path
+                    string libraryFile = basePath + record.m_parameter;
 
-                // load the material library
-                loadMaterialLib(libraryFile, m_pMaterials,
-                    &currentIndex.m_materialCount, basePath);
+                    // load the material library
+                    loadMaterialLib(libraryFile.c_str(), m_pMaterials,
+                        &currentIndex.m_materialCount, basePath);
+                }
             }
+
+            record.m_material = curMaterial;
         }
     }
 
-    // close OBJ file
-    fclose(hFile);
+    // faces copy the vertex data they use, so they are built once it is all in place
+    runOBJChunks(chunks, buildFaces);
+
+    for (size_t i=0; i<numChunks; i++)
+    {
+        if (!chunks[i].m_valid) { return (false); }
+    }
 
     /////////////////////////////////////////////////////////////////////////
     // SUCCESS
@@ -840,205 +1162,300 @@ bool cOBJModel::LoadModel(const char a_fileName[])
 
 //------------------------------------------------------------------------------
 
-void cOBJModel::parseFaceString(char a_faceString[], cFace *a_faceOut,
-                const cVector3d *a_pVertices,
-                const cVector3d *a_pNormals,
-                const cVector3d *a_pTexCoords,
-                const unsigned int a_materialIndex)
+void cOBJModel::parseChunk(cOBJChunk* a_chunk)
 {
     /////////////////////////////////////////////////////////////////////////
-    // CONVERT FACE STRING FROM THE OBJ FILE INTO A FACE STRUCTURE
+    // READ THE RECORDS OF A CHUNK, ONE LINE AT A TIME
     /////////////////////////////////////////////////////////////////////////
 
-    unsigned int i;
-    int iVertex = 0;
-    int iTextureCoord = 0;
-    int iNormal = 0;
+    try
+    {
+        vector<const char*> triplets;   // start of each vertex of a face
+        unsigned int numGroups = 0;     // g records read so far
+        int lastUseMtl = -1;            // last usemtl record read so far
 
-    // pointer to the face string. will be incremented later to
-    // advance to the next triplet in the string.
-    char *pFaceString = a_faceString;
+        const char* line = a_chunk->m_begin;
+        while (line < a_chunk->m_end)
+        {
+            const char* lineEnd = (const char*)(memchr(line, '\n', a_chunk->m_end - line));
+            if (lineEnd == NULL) { lineEnd = a_chunk->m_end; }
+
+            // the first string of the line tells what it holds
+            const char* token = line;
+            while ((token < lineEnd) && isOBJSpace(*token)) { token++; }
+            const char* tokenEnd = token;
+            while ((tokenEnd < lineEnd) && !isOBJSpace(*tokenEnd)) { tokenEnd++; }
+            size_t length = tokenEnd - token;
+
+            // next three elements are floats of a vertex, possibly followed by a color
+            if (isOBJToken(token, length, C_OBJ_VERTEX_ID))
+            {
+                float values[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+                int numValues = 0;
+                const char* str = tokenEnd;
+                while ((numValues < 6) && parseOBJFloat(str, lineEnd, values[numValues])) { numValues++; }
+
+                cColorf color;
+                if (numValues > 0)
+                {
+                    color.set(values[3], values[4], values[5]);
+                    color.m_flag_color = true;
+                }
+                a_chunk->m_vertices.push_back(cVector3d(values[0], values[1], values[2]));
+                a_chunk->m_colors.push_back(color);
+            }
+
+            // next elements are floats of a texture coordinate
+            else if (isOBJToken(token, length, C_OBJ_TEXCOORD_ID))
+            {
+                float values[3] = { 0.0f, 0.0f, 0.0f };
+                const char* str = tokenEnd;
+                for (int i=0; (i<3) && parseOBJFloat(str, lineEnd, values[i]); i++) {}
+                a_chunk->m_texCoords.push_back(cVector3d(values[0], values[1], values[2]));
+            }
+
+            // next three elements are floats of a vertex normal
+            else if (isOBJToken(token, length, C_OBJ_NORMAL_ID))
+            {
+                float values[3] = { 0.0f, 0.0f, 0.0f };
+                const char* str = tokenEnd;
+                for (int i=0; (i<3) && parseOBJFloat(str, lineEnd, values[i]); i++) {}
+                a_chunk->m_normals.push_back(cVector3d(values[0], values[1], values[2]));
+            }
 
-    // save the string positions of all triplets
-    int iTripletPos[C_OBJ_MAX_VERTICES];
-    int iCurTriplet = 0;
+            // rest of the line contains face information
+            else if (isOBJToken(token, length, C_OBJ_FACE_ID))
+            {
+                const char* parameter = getOBJParameter(tokenEnd, lineEnd);
+                parseFace(a_chunk, parameter, getOBJParameterEnd(parameter, lineEnd), triplets);
+                a_chunk->m_faces.back().m_numGroups = numGroups;
+                a_chunk->m_faces.back().m_lastUseMtl = lastUseMtl;
+            }
+
+            // rest of the line contains a group name, a material name or a material library
+            else if (isOBJToken(token, length, C_OBJ_NAME_ID) ||
+                     isOBJToken(token, length, C_OBJ_USE_MTL_ID) ||
+                     isOBJToken(token, length, C_OBJ_MTL_LIB_ID))
+            {
+                const char* parameter = getOBJParameter(tokenEnd, lineEnd);
 
-    // init the face structure
-    a_faceOut->init();
+                cOBJRecord record;
+                record.m_parameter.assign(parameter, getOBJParameterEnd(parameter, lineEnd));
+                record.m_material = 0;
 
-    // the first vertex always starts at position 0 in the string
-    iTripletPos[0] = 0;
-    a_faceOut->m_numVertices = 1;
-    iCurTriplet++;
-      
-    if (m_groupNames.size() > 0) a_faceOut->m_groupIndex = (int)(m_groupNames.size() - 1);
-    else a_faceOut->m_groupIndex = -1;
+                if (isOBJToken(token, length, C_OBJ_NAME_ID))
+                {
+                    record.m_type = C_OBJ_RECORD_GROUP;
+                    numGroups++;
+                }
+                else if (isOBJToken(token, length, C_OBJ_USE_MTL_ID))
+                {
+                    record.m_type = C_OBJ_RECORD_USE_MTL;
+                    lastUseMtl = (int)(a_chunk->m_records.size());
+                }
+                else
+                {
+                    record.m_type = C_OBJ_RECORD_MTL_LIB;
+                }
+                a_chunk->m_records.push_back(record);
+            }
 
+            // comments and other records are skipped
+            line = lineEnd + 1;
+        }
+
+        a_chunk->m_valid = true;
+    }
+    catch (...)
+    {
+        a_chunk->m_valid = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+
+void cOBJModel::parseFace(cOBJChunk* a_chunk, const char* a_begin, const char* a_end, vector<const char*>& a_triplets)
+{
     /////////////////////////////////////////////////////////////////////////
-    // GET NUMBER OF VERTICES IN THE FACE
+    // GET THE POSITION OF EACH VERTEX IN THE FACE
     /////////////////////////////////////////////////////////////////////////
 
-    // loop trough the whole string
+    // the first vertex always starts at position 0 in the string, each
+    // following one after a group of spaces
+    a_triplets.clear();
+    a_triplets.push_back(a_begin);
+
     bool detectedSpace = false;
-    for (i=0; i<strlen(a_faceString); i++)
+    for (const char* str = a_begin; str < a_end; str++)
     {
         if (!detectedSpace)
         {
-            // each triplet is separated by spaces
-            if (a_faceString[i] == ' ')
-            {
-                detectedSpace = true;
-            }
+            if (*str == ' ') { detectedSpace = true; }
         }
-        else
+        else if (*str != ' ')
         {
-            if (a_faceString[i] != ' ')
-            {
-                // one more vertex
-                a_faceOut->m_numVertices++;
-                
-                // save position of triplet
-                iTripletPos[iCurTriplet] = i;
-                
-                // next triplet
-                iCurTriplet++;
-
-                // reset for next group of spaces
-                detectedSpace = false;
-            }
+            a_triplets.push_back(str);
+            detectedSpace = false;
         }
     }
 
-
     /////////////////////////////////////////////////////////////////////////
     // CHECK DATA FORMAT OF FACE: (i, i/j, i/j/k, i//k)
     /////////////////////////////////////////////////////////////////////////
 
-    // mode
-    int mode = 0;
-
-    // copy a vertex block
-    char vertexStr[100];
-    strncpy (vertexStr, pFaceString, iTripletPos[1]);
-
-    char* p = strstr(vertexStr, "//");
-    if (p != NULL)
+    const char* firstEnd = (a_triplets.size() > 1) ? a_triplets[1] : a_end;
+    int numSlashes = 0;
+    bool doubleSlash = false;
+    for (const char* str = a_begin; str < firstEnd; str++)
     {
-        // format: i//k
-        mode = 3;
-    }
-    else
-    {
-        char* first = strstr(vertexStr, "/");
-        if (first == NULL)
+        if (*str == '/')
         {
-            // format i
-            mode = 1;
+            if ((str+1 < firstEnd) && (str[1] == '/')) { doubleSlash = true; }
+            numSlashes++;
         }
-        else
+    }
+
+    int mode = 1;
+    if (doubleSlash)            { mode = 3; }
+    else if (numSlashes == 1)   { mode = 2; }
+    else if (numSlashes > 1)    { mode = 4; }
+
+    /////////////////////////////////////////////////////////////////////////
+    // READ THE VERTEX, TEXTURE COORDINATE AND NORMAL INDICES
+    /////////////////////////////////////////////////////////////////////////
+
+    cOBJFaceRecord face;
+    face.m_numVertices = (unsigned int)(a_triplets.size());
+    face.m_mode = mode;
+    face.m_firstIndex = (unsigned int)(a_chunk->m_indices.size() / 3);
+    face.m_numGroups = 0;
+    face.m_lastUseMtl = -1;
+
+    // a triplet missing an index keeps the one of the previous triplet
+    int iVertex = 0;
+    int iTextureCoord = 0;
+    int iNormal = 0;
+
+    for (size_t i=0; i<a_triplets.size(); i++)
+    {
+        const char* str = a_triplets[i];
+        if (parseOBJInt(str, a_end, iVertex))
         {
-            char* second = strstr(first, "/");
-            if (second != NULL)
+            if (mode == 4)
             {
-                // format i/j/k
-                mode = 4;
+                // vertices, texture coordinates and normals
+                if (matchOBJChar(str, a_end, '/') && parseOBJInt(str, a_end, iTextureCoord) && matchOBJChar(str, a_end, '/'))
+                {
+                    parseOBJInt(str, a_end, iNormal);
+                }
             }
-            else
+            else if (mode == 3)
             {
-                // format: i/j
-                mode = 2;
+                // vertices and normals but no texture coordinates
+                if (matchOBJChar(str, a_end, '/') && matchOBJChar(str, a_end, '/'))
+                {
+                    parseOBJInt(str, a_end, iNormal);
+                }
+            }
+            else if (mode == 2)
+            {
+                // vertices and texture coordinates but no normals
+                if (matchOBJChar(str, a_end, '/'))
+                {
+                    parseOBJInt(str, a_end, iTextureCoord);
+                }
             }
         }
+
+        a_chunk->m_indices.push_back(iVertex);
+        a_chunk->m_indices.push_back(iTextureCoord);
+        a_chunk->m_indices.push_back(iNormal);
     }
 
+    a_chunk->m_faces.push_back(face);
+}
+
+//------------------------------------------------------------------------------
+
+void cOBJModel::buildFaces(cOBJChunk* a_chunk)
+{
     /////////////////////////////////////////////////////////////////////////
-    // ALLOCATE SPACE FOR STRUCTURES THAT HOLD THE FACE DATA
+    // CONVERT THE FACES OF A CHUNK INTO FACE STRUCTURES
     /////////////////////////////////////////////////////////////////////////
 
-    // vertices
-    a_faceOut->m_pVertices = new cVector3d[a_faceOut->m_numVertices];
-    a_faceOut->m_pVertexIndices = new int[a_faceOut->m_numVertices];
-
-    // allocate space for normals and texture coordinates only if present
-    if ((mode == 3) || (mode == 4))
-    {
-        a_faceOut->m_pNormals = new cVector3d[a_faceOut->m_numVertices];
-        a_faceOut->m_pNormalIndices = new int[a_faceOut->m_numVertices];
-    }
-    else
+    try
     {
-        a_faceOut->m_pNormals = NULL;
-        a_faceOut->m_pNormalIndices = NULL;
-    }
+        cOBJModel* model = a_chunk->m_model;
+        const cOBJFileInfo& info = model->m_OBJInfo;
 
-    // allocate space for texture coordinates
-    if ((mode == 2) || (mode == 4)) 
-    {  
-        a_faceOut->m_pTexCoords = new cVector3d[a_faceOut->m_numVertices];
-        a_faceOut->m_pTextureIndices = new int[a_faceOut->m_numVertices];
-    }
-    else 
-    {
-        a_faceOut->m_pTexCoords = NULL;
-        a_faceOut->m_pTextureIndices = NULL;
-    }
+        for (size_t i=0; i<a_chunk->m_faces.size(); i++)
+        {
+            const cOBJFaceRecord& record = a_chunk->m_faces[i];
+            cFace* face = &model->m_pFaces[a_chunk->m_firstFace + i];
+            face->init();
+            face->m_numVertices = record.m_numVertices;
 
-    /////////////////////////////////////////////////////////////////////////
-    // COPY VERTEX, NORMAL, MATERIAL AND TEXTURE DATA INTO THE STRUCTURE
-    /////////////////////////////////////////////////////////////////////////
+            // group and material in effect where the face was read
+            unsigned int numGroups = a_chunk->m_numGroupsBefore + record.m_numGroups;
+            face->m_groupIndex = (numGroups > 0) ? (int)(numGroups - 1) : -1;
+            face->m_materialIndex = (record.m_lastUseMtl >= 0) ? a_chunk->m_records[record.m_lastUseMtl].m_material : a_chunk->m_materialBefore;
 
-    // set material
-    a_faceOut->m_materialIndex = a_materialIndex;
+            bool useNormals = ((record.m_mode == 3) || (record.m_mode == 4));
+            bool useTexCoords = ((record.m_mode == 2) || (record.m_mode == 4));
 
-    // process per-vertex data
-    for (i=0; i<(unsigned int) a_faceOut->m_numVertices; i++)
-    {
-        // read one triplet from the face string
+            // vertices
+            face->m_pVertices = new cVector3d[face->m_numVertices];
+            face->m_pVertexIndices = new int[face->m_numVertices];
 
-        // are vertices, normals and texture coordinates present ?
-        if (mode == 4)
-        {
-            sscanf(pFaceString, "%i/%i/%i",
-            &iVertex, &iTextureCoord, &iNormal);
-        }
-        else if (mode == 3)
-        {
-            // vertices and normals but no texture coordinates
-            sscanf(pFaceString, "%i//%i", &iVertex, &iNormal);
-        }
-        else if (mode == 2)
-        {
-            // vertices and texture coordinates but no normals
-            sscanf(pFaceString, "%i/%i", &iVertex, &iTextureCoord);
-        }
-        else if (mode == 1)
-        {
-            // only vertices
-            sscanf(pFaceString, "%i", &iVertex);
-        }
+            // allocate space for normals and texture coordinates only if present
+            if (useNormals)
+            {
+                face->m_pNormals = new cVector3d[face->m_numVertices];
+                face->m_pNormalIndices = new int[face->m_numVertices];
+            }
+            if (useTexCoords)
+            {
+                face->m_pTexCoords = new cVector3d[face->m_numVertices];
+                face->m_pTextureIndices = new int[face->m_numVertices];
+            }
 
-        // copy vertex into the face. Also check for normals and texture
-        // coordinates and copy them if present.
-        memcpy(&a_faceOut->m_pVertices[i], &m_pVertices[iVertex - 1],
-        sizeof(cVector3d));
-        a_faceOut->m_pVertexIndices[i] = iVertex-1;
-
-        if ((mode == 2) || (mode == 4)) 
-        {    
-            memcpy(&a_faceOut->m_pTexCoords[i],
-            &m_pTexCoords[iTextureCoord - 1], sizeof(cVector3d));
-            a_faceOut->m_pTextureIndices[i] = iTextureCoord-1;
-        }
-        if ((mode == 3) || (mode == 4)) 
-        {
-            memcpy(&a_faceOut->m_pNormals[i],
-            &m_pNormals[iNormal - 1], sizeof(cVector3d));
-            a_faceOut->m_pNormals[i].normalize();
-            a_faceOut->m_pNormalIndices[i] = iNormal-1;
-        }
+            // copy vertex, normal and texture data into the structure
+            for (unsigned int j=0; j<face->m_numVertices; j++)
+            {
+                const int* index = &a_chunk->m_indices[3 * (record.m_firstIndex + j)];
+                int iVertex = index[0] - 1;
+                int iTextureCoord = index[1] - 1;
+                int iNormal = index[2] - 1;
+
+                // an index outside the file fails the load instead of reading past the arrays
+                if ((iVertex < 0) || (iVertex >= (int)(info.m_vertexCount)) ||
+                    (useTexCoords && ((iTextureCoord < 0) || (iTextureCoord >= (int)(info.m_texCoordCount)))) ||
+                    (useNormals && ((iNormal < 0) || (iNormal >= (int)(info.m_normalCount)))))
+                {
+                    a_chunk->m_valid = false;
+                    return;
+                }
 
-        // set string pointer to the next triplet
-        pFaceString = &a_faceString[iTripletPos[i+1]];
+                face->m_pVertices[j] = model->m_pVertices[iVertex];
+                face->m_pVertexIndices[j] = iVertex;
+
+                if (useTexCoords)
+                {
+                    face->m_pTexCoords[j] = model->m_pTexCoords[iTextureCoord];
+                    face->m_pTextureIndices[j] = iTextureCoord;
+                }
+                if (useNormals)
+                {
+                    face->m_pNormals[j] = model->m_pNormals[iNormal];
+                    face->m_pNormals[j].normalize();
+                    face->m_pNormalIndices[j] = iNormal;
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        a_chunk->m_valid = false;
     }
 }
 
@@ -1187,88 +1604,41 @@ bool cOBJModel::loadMaterialLib(const char a_fileName[],
 
 //------------------------------------------------------------------------------
 
-void cOBJModel::getFileInfo(FILE *a_hStream, cOBJFileInfo *a_info, const char a_constBasePath[])
+unsigned int cOBJModel::countMaterials(const char a_fileName[])
 {
     /////////////////////////////////////////////////////////////////////////
-    // READ THE COUNT OF ALL IMPORTANT IDENTIFIERS OUT OF THE GIVEN STREAM
+    // COUNT THE MATERIALS DEFINED IN A MATERIAL LIBRARY
     /////////////////////////////////////////////////////////////////////////
 
-    char str[C_OBJ_MAX_STR_SIZE];    // Buffer for reading the file
-    char basePath[C_OBJ_SIZE_PATH];  // Needed to append a filename to the base path
-
-    // init structure
-    a_info->init();
+    char str[C_OBJ_MAX_STR_SIZE];   // Buffer for reading the file
+    unsigned int count = 0;
 
-    // rollback the stream
-    rewind(a_hStream);
+    // open the library file
+    FILE *hMaterialLib = fopen(a_fileName, "r");
 
-    // quit reading when end of file has been reached
-    while (!feof(a_hStream))
+    // success?
+    if (hMaterialLib)
     {
-        // get next string
-        readNextString(str, sizeof(str), a_hStream);
-
-        // vertex?
-        if (!strncmp(str, C_OBJ_VERTEX_ID, sizeof(C_OBJ_VERTEX_ID)))
-        a_info->m_vertexCount++;
-
-        // texture coordinate?
-        if (!strncmp(str, C_OBJ_TEXCOORD_ID, sizeof(C_OBJ_TEXCOORD_ID)))
-        a_info->m_texCoordCount++;
-        
-        // vertex normal?
-        if (!strncmp(str, C_OBJ_NORMAL_ID, sizeof(C_OBJ_NORMAL_ID)))
-        a_info->m_normalCount++;
-        
-        // face?
-        if (!strncmp(str, C_OBJ_FACE_ID, sizeof(C_OBJ_FACE_ID)))
-        a_info->m_faceCount++;
-
-        // material library definition?
-        if (!strncmp(str, C_OBJ_MTL_LIB_ID, sizeof(C_OBJ_MTL_LIB_ID)))
+        // quit reading when end of file has been reached
+        while (!feof(hMaterialLib))
         {
-            // read the filename of the library
-            getTokenParameter(str, sizeof(str), a_hStream);
-
-            // copy the model's base path into a none-constant string
-            strcpy(basePath, a_constBasePath);
-
-            // append material library filename to the model's base path
-            strcat(basePath, str);
-
-            // append .mtl
-            //strcat(szBasePath, ".mtl");
-
-            // open the library file
-            FILE *hMaterialLib = fopen(basePath, "r");
-
-            // success?
-            if (hMaterialLib)
+            // read next string
+            if (fscanf(hMaterialLib, "%1024s" ,str) > 0)
             {
-                // quit reading when end of file has been reached
-                while (!feof(hMaterialLib))
+                // is it a "new material" identifier ?
+                if (!strncmp(str, C_OBJ_NEW_MTL_ID, sizeof(C_OBJ_NEW_MTL_ID)))
                 {
-                    // read next string
-                    if (fscanf(hMaterialLib, "%1024s" ,str) > 0)
-                    {
-
-                        // is it a "new material" identifier ?
-                        if (!strncmp(str, C_OBJ_NEW_MTL_ID, sizeof(C_OBJ_NEW_MTL_ID)))
-                        {
-                            // one more material defined
-                            a_info->m_materialCount++;
-                        }
-                    }
+                    // one more material defined
+                    count++;
                 }
-
-                // close material library
-                fclose(hMaterialLib);
             }
         }
 
-       // clear string two avoid counting something twice
-       memset(str, '\0', sizeof(str));
+        // close material library
+        fclose(hMaterialLib);
     }
+
+    return (count);
 }
 
 //------------------------------------------------------------------------------
@@ -49,6 +49,8 @@
 #include "world/CMultiMesh.h"
 //------------------------------------------------------------------------------
 #include <map>
+#include <string>
+#include <vector>
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -79,6 +81,9 @@ bool cLoadFileOBJ(cMultiMesh* a_object, const std::string& a_filename);
 //! This function saves an OBJ model file.
 bool cSaveFileOBJ(cMultiMesh* a_object, const std::string& a_filename);
 
+//! This function computes the hash of an OBJ model file and its material libraries.
+bool cHashFileOBJ(const std::string& a_filename, unsigned long long& a_hash);
+
 //@}
 
 
@@ -93,6 +98,32 @@ bool cSaveFileOBJ(cMultiMesh* a_object, const std::string& a_filename);
 extern bool g_objLoaderShouldGenerateExtraVertices;
 
 
+//------------------------------------------------------------------------------
+/*!
+    Clients can use this to tell the OBJ file loader to keep a precompiled
+    model cache next to each OBJ file. \n
+    If __true__, the first load of a file parses it and writes its meshes to
+    a binary cache named after the file with \ref C_MODEL_CACHE_EXTENSION
+    appended. Later loads map that cache into memory instead of parsing the
+    file, for as long as the OBJ file and its material libraries are
+    unchanged. If __false__ (default), OBJ files are always parsed.
+*/
+//------------------------------------------------------------------------------
+extern bool g_objLoaderShouldUseCache;
+
+
+//------------------------------------------------------------------------------
+/*!
+    Clients can use this to set the number of threads parsing an OBJ file. \n
+    The file is memory mapped and split at line boundaries into one chunk per
+    thread, but never into chunks smaller than \ref C_OBJ_MIN_CHUNK_SIZE, so
+    small files are parsed by the calling thread alone. If __0__ (default),
+    one thread per processor is used.
+*/
+//------------------------------------------------------------------------------
+extern unsigned int g_objLoaderNumThreads;
+
+
 //------------------------------------------------------------------------------
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 //------------------------------------------------------------------------------
@@ -180,6 +211,9 @@ typedef std::map<vertexIndexSet,unsigned int,ltVertexIndexSet> vertexIndexSet_ui
 // Maximum number of vertices a that a single face can have
 #define C_OBJ_MAX_VERTICES 256
 
+// Smallest part of an OBJ file parsed by a thread of its own
+#define C_OBJ_MIN_CHUNK_SIZE (1 << 20)
+
 // Image File information.
 struct cOBJFileInfo
 {
@@ -270,6 +304,57 @@ struct cMaterialInfo
     }
 };
 
+class cOBJModel;
+
+// Kinds of records that change the state of the faces following them.
+enum cOBJRecordType
+{
+    C_OBJ_RECORD_GROUP,
+    C_OBJ_RECORD_USE_MTL,
+    C_OBJ_RECORD_MTL_LIB
+};
+
+// A g, usemtl or mtllib record of a chunk, applied in file order once all chunks are parsed.
+struct cOBJRecord
+{
+    cOBJRecordType m_type;
+    std::string    m_parameter;
+    unsigned int   m_material;      // current material after the record
+};
+
+// A face as read from its line, before the vertex data is attached.
+struct cOBJFaceRecord
+{
+    unsigned int m_numVertices;
+    int          m_mode;            // 1: i, 2: i/j, 3: i//k, 4: i/j/k
+    unsigned int m_firstIndex;      // first vertex/texture/normal triplet in the chunk indices
+    unsigned int m_numGroups;       // g records of the chunk preceding the face
+    int          m_lastUseMtl;      // last usemtl record of the chunk preceding the face, -1 if none
+};
+
+// Part of an OBJ file parsed by one thread, starting and ending at a line boundary.
+struct cOBJChunk
+{
+    cOBJModel*                  m_model;
+    const char*                 m_begin;
+    const char*                 m_end;
+    bool                        m_valid;
+
+    // data read from the chunk
+    std::vector<cVector3d>      m_vertices;
+    std::vector<cColorf>        m_colors;
+    std::vector<cVector3d>      m_normals;
+    std::vector<cVector3d>      m_texCoords;
+    std::vector<cOBJFaceRecord> m_faces;
+    std::vector<int>            m_indices;
+    std::vector<cOBJRecord>     m_records;
+
+    // state of the file at the start of the chunk, set once all chunks are parsed
+    unsigned int                m_firstFace;
+    unsigned int                m_numGroupsBefore;
+    unsigned int                m_materialBefore;
+};
+
 
 //==============================================================================
 /*!
@@ -339,6 +424,9 @@ class cOBJModel
 
     //! Read next string of file.
     void readNextString(char *a_str, int a_size, FILE *a_hStream);
+
+    //! Count the materials of a material file [mtl].
+    unsigned int countMaterials(const char a_fileName[]);
     
     //! Get next token from file.
     void getTokenParameter(char a_str[], const unsigned int a_strSize, FILE *a_hFile);
@@ -350,12 +438,14 @@ class cOBJModel
     bool loadMaterialLib(const char a_fFileName[], cMaterialInfo *a_pMaterials,
         unsigned int *a_curMaterialIndex, char a_basePath[]);
 
-    //! Parse information about face.
-    void  parseFaceString(char a_faceString[], cFace *a_faceOut, const cVector3d *a_pVertices,
-        const cVector3d *a_pNormals, const cVector3d *a_pTexCoords, const unsigned int a_materialIndex);
+    //! Read the vertices, faces and records of a chunk.
+    static void parseChunk(cOBJChunk* a_chunk);
+
+    //! Read the vertex triplets of a face.
+    static void parseFace(cOBJChunk* a_chunk, const char* a_begin, const char* a_end, std::vector<const char*>& a_triplets);
 
-    //! Read information about file.
-    void  getFileInfo(FILE *a_hStream, cOBJFileInfo *a_stat, const char a_constBasePath[]);
+    //! Build the faces of a chunk from the merged vertex data.
+    static void buildFaces(cOBJChunk* a_chunk);
 };
 
 //! Internal: get a (possibly new) vertex index for a vertex.
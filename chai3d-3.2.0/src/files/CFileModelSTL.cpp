@@ -44,10 +44,14 @@
 //------------------------------------------------------------------------------
 #include "files/CFileModelSTL.h"
 //------------------------------------------------------------------------------
+#include "system/CMappedFile.h"
+//------------------------------------------------------------------------------
 #include "stdint.h"
 #include <stdio.h>
 #include <math.h>
+#include <cstring>
 #include <fstream>
+#include <vector>
 //------------------------------------------------------------------------------
 using namespace std;
 //------------------------------------------------------------------------------
@@ -57,10 +61,25 @@ using namespace chai3d;
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+bool g_stlLoaderShouldWeldVertices = false;
+//------------------------------------------------------------------------------
+
 //------------------------------------------------------------------------------
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 //------------------------------------------------------------------------------
 
+//! Size of the header of a binary STL file, including the number of triangles.
+const size_t C_STL_HEADER_SIZE = 84;
+
+//! Size of a triangle in a binary STL file.
+const size_t C_STL_TRIANGLE_SIZE = 50;
+
+//! Offset of the first vertex in a triangle of a binary STL file.
+const size_t C_STL_VERTEX_OFFSET = 12;
+
+//------------------------------------------------------------------------------
+
 struct cHeaderSTL
 {
     char m_header[80];
@@ -76,6 +95,22 @@ struct cTriangleSTL
     int m_attribute;
 };
 
+//------------------------------------------------------------------------------
+
+// hashes a vertex position, with -0 and +0 hashing alike since they are welded
+static inline unsigned int hashSTLVertex(const float* a_position)
+{
+    unsigned int hash = 2166136261u;
+    for (int i=0; i<3; i++)
+    {
+        float value = a_position[i] + 0.0f;
+        unsigned int bits;
+        memcpy(&bits, &value, sizeof(bits));
+        hash = (hash ^ bits) * 16777619u;
+    }
+    return (hash ^ (hash >> 15));
+}
+
 //------------------------------------------------------------------------------
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 //------------------------------------------------------------------------------
@@ -86,6 +121,8 @@ struct cTriangleSTL
     This function loads an STL (binary format) 3D model from a file into a cMultiMesh structure.
     If the operation succeeds, then the functions returns __true__ and the
     3D model is loaded into cMultiMesh as a single mesh.
+    The file is memory mapped and its vertices are welded as described by
+    \ref g_stlLoaderShouldWeldVertices.
     If the operation fails, then the function returns __false__.
 
     \param  a_object    Multimesh object.
@@ -100,63 +137,105 @@ bool cLoadFileSTL(cMultiMesh* a_object, const std::string& a_filename)
     if (a_object == NULL)
         return (C_ERROR);
 
-    // open file
-    ifstream file(a_filename.c_str(), ios::binary);
-    if (!file)
+    // map file into memory
+    cMappedFile file;
+    if (!file.open(a_filename))
         return (C_ERROR);
 
-    // get length of file
-    file.seekg (0, file.end);
-    int length = (int)(file.tellg());
-    file.seekg (0, file.beg);
-    if (length < 84)
-    {
-        file.close();
+    const unsigned char* data = file.getData();
+    size_t length = file.getSize();
+    if (length < C_STL_HEADER_SIZE)
         return (C_ERROR);
-    }
-
-    // read header
-    cHeaderSTL header;
-    file.read((char*)(&header), 84);
 
     // read number of triangles
-    unsigned int numTriangles = header.m_numTriangles;
+    uint32_t numTriangles;
+    memcpy(&numTriangles, data + 80, sizeof(numTriangles));
     if (numTriangles == 0)
-    {
-        file.close();
         return (C_ERROR);
+
+    // check that the file holds the number of triangles found
+    if ((unsigned long long)(length - C_STL_HEADER_SIZE) < (unsigned long long)(numTriangles) * C_STL_TRIANGLE_SIZE)
+        return (C_ERROR);
+
+    // positions of the vertices, three per triangle in file order
+    size_t numPositions = 3 * (size_t)numTriangles;
+    vector<float> positions(3 * numPositions);
+    for (size_t i=0; i<numTriangles; i++)
+    {
+        memcpy(&positions[9*i], data + C_STL_HEADER_SIZE + i * C_STL_TRIANGLE_SIZE + C_STL_VERTEX_OFFSET, 9 * sizeof(float));
     }
 
-    // check if the length of the file correspond to the number of triangles found
-    double num = (double)(length - sizeof(cHeaderSTL)) / 50.0;
-    if ((num != floor(num)) && ((int)num != numTriangles))
+    // vertex used by each triangle corner. Corners at the same position share
+    // a vertex when welding, found through a hash table of the positions
+    // sized for the case where no corners are shared
+    vector<unsigned int> indices(numPositions);
+    vector<unsigned int> vertices;
+    if (g_stlLoaderShouldWeldVertices)
     {
-        file.close();
-        return (C_ERROR);
+        size_t tableSize = 1;
+        while (tableSize < 2 * numPositions) { tableSize <<= 1; }
+        vector<unsigned int> table(tableSize, 0xffffffff);
+        vertices.reserve(numPositions / 2);
+
+        for (size_t i=0; i<numPositions; i++)
+        {
+            const float* position = &positions[3*i];
+            size_t slot = hashSTLVertex(position) & (tableSize - 1);
+            while (true)
+            {
+                unsigned int vertex = table[slot];
+                if (vertex == 0xffffffff)
+                {
+                    vertex = (unsigned int)(vertices.size());
+                    vertices.push_back((unsigned int)i);
+                    table[slot] = vertex;
+                    indices[i] = vertex;
+                    break;
+                }
+
+                const float* other = &positions[3*vertices[vertex]];
+                if ((other[0] == position[0]) && (other[1] == position[1]) && (other[2] == position[2]))
+                {
+                    indices[i] = vertex;
+                    break;
+                }
+                slot = (slot + 1) & (tableSize - 1);
+            }
+        }
+    }
+    else
+    {
+        vertices.resize(numPositions);
+        for (size_t i=0; i<numPositions; i++)
+        {
+            vertices[i] = (unsigned int)i;
+            indices[i] = (unsigned int)i;
+        }
     }
 
     // create mesh
     cMesh* mesh = a_object->newMesh();
 
-    // load triangles
-    for (int i=0; i<(int)numTriangles; i++)
+    // allocate all vertices at once
+    cVertexArrayPtr vertexArray = mesh->m_vertices;
+    unsigned int numVertices = (unsigned int)(vertices.size());
+    vertexArray->newVertices(numVertices);
+    for (unsigned int i=0; i<numVertices; i++)
     {
-        cTriangleSTL triangle;
-
-        // read triangle data from file
-        file.read((char*)(&triangle), 50);
-
-        // create triangle entity
-        mesh->newTriangle(cVector3d(triangle.m_vertex0[0], triangle.m_vertex0[1], triangle.m_vertex0[2]),
-                          cVector3d(triangle.m_vertex1[0], triangle.m_vertex1[1], triangle.m_vertex1[2]),
-                          cVector3d(triangle.m_vertex2[0], triangle.m_vertex2[1], triangle.m_vertex2[2]));
+        const float* position = &positions[3*vertices[i]];
+        vertexArray->m_localPos[i].set(position[0], position[1], position[2]);
     }
 
+    // allocate all triangles at once
+    cTriangleArrayPtr triangleArray = mesh->m_triangles;
+    triangleArray->m_indices.swap(indices);
+    triangleArray->m_allocated.assign(numTriangles, true);
+    triangleArray->m_flagMarkForResize = true;
+    triangleArray->m_flagMarkForUpdate = true;
+
     // compute normals
     mesh->computeAllNormals();
-
-    // close file
-    file.close();
+    mesh->markForUpdate(false);
 
     // return success
     return (C_SUCCESS);
@@ -76,6 +76,19 @@ bool cSaveFileSTL(cMultiMesh* a_object, const std::string& a_filename);
 
 //@}
 
+
+//------------------------------------------------------------------------------
+/*!
+    Clients can use this to tell the STL file loader how to behave in terms
+    of vertex merging. \n
+    If __true__, triangle corners at exactly the same position share a single
+    vertex, so vertex normals are smoothed across the triangles, including
+    across sharp edges. If __false__ (default), loaded STL files have three
+    _distinct_ vertices per triangle and keep flat shading.
+*/
+//------------------------------------------------------------------------------
+extern bool g_stlLoaderShouldWeldVertices;
+
 //------------------------------------------------------------------------------
 } // namespace chai3d
 //------------------------------------------------------------------------------
@@ -1489,6 +1489,12 @@ bool cImage::loadFromFile(const string& a_filename)
         result = cLoadFileRAW(this, a_filename);
     }
 
+    // remember where the image came from
+    if (result)
+    {
+        m_filename = a_filename;
+    }
+
     return (result);
 }
 
@@ -1569,6 +1575,12 @@ bool cImage::saveToFile(const string& a_filename)
         result = cSaveFileRAW(image, a_filename);
     }
 
+    // remember where the image went
+    if (result)
+    {
+        m_filename = a_filename;
+    }
+
     return (result);
 }
 
@@ -0,0 +1,435 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Brandon Sieu, Glenn Skelton
+    \version   3.2.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "graphics/CMeshOptimizer.h"
+//------------------------------------------------------------------------------
+#include "math/CMaths.h"
+//------------------------------------------------------------------------------
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//! Marks the end of a list of vertices or triangles.
+const unsigned int C_OPTIMIZER_NONE = (unsigned int)(-1);
+
+//------------------------------------------------------------------------------
+
+// cell of the grid vertices are hashed into while welding
+struct cWeldCell
+{
+    long long m_x;
+    long long m_y;
+    long long m_z;
+
+    bool operator==(const cWeldCell& a_cell) const
+    {
+        return ((m_x == a_cell.m_x) && (m_y == a_cell.m_y) && (m_z == a_cell.m_z));
+    }
+};
+
+//------------------------------------------------------------------------------
+
+struct cWeldCellHash
+{
+    size_t operator()(const cWeldCell& a_cell) const
+    {
+        unsigned long long hash = (unsigned long long)(a_cell.m_x) * 73856093ULL;
+        hash ^= (unsigned long long)(a_cell.m_y) * 19349663ULL;
+        hash ^= (unsigned long long)(a_cell.m_z) * 83492791ULL;
+        return ((size_t)(hash ^ (hash >> 32)));
+    }
+};
+
+//------------------------------------------------------------------------------
+
+// coordinate of the cell holding a_value, or its exact bits without a tolerance
+static long long getWeldCellCoordinate(const double a_value, const double a_cellSize)
+{
+    if (a_cellSize > 0.0)
+    {
+        return ((long long)(floor(cClamp(a_value / a_cellSize, -1e18, 1e18))));
+    }
+
+    // adding zero turns -0 into +0, so both land in the same cell
+    double value = a_value + 0.0;
+    long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits);
+}
+
+//------------------------------------------------------------------------------
+
+static inline bool isWeldable(const cVector3d& a_v0, const cVector3d& a_v1, const double a_tolerance)
+{
+    return ((cAbs(a_v0(0) - a_v1(0)) <= a_tolerance) &&
+            (cAbs(a_v0(1) - a_v1(1)) <= a_tolerance) &&
+            (cAbs(a_v0(2) - a_v1(2)) <= a_tolerance));
+}
+
+//------------------------------------------------------------------------------
+
+// two vertices are welded if all the data the array holds for them matches
+static bool isWeldable(cVertexArrayPtr a_vertices, const unsigned int a_index0, const unsigned int a_index1, const double a_tolerance)
+{
+    if (!isWeldable(a_vertices->m_localPos[a_index0], a_vertices->m_localPos[a_index1], a_tolerance)) { return (false); }
+    if (a_vertices->getUseNormalData() && !isWeldable(a_vertices->m_normal[a_index0], a_vertices->m_normal[a_index1], a_tolerance)) { return (false); }
+    if (a_vertices->getUseTexCoordData() && !isWeldable(a_vertices->m_texCoord[a_index0], a_vertices->m_texCoord[a_index1], a_tolerance)) { return (false); }
+    if (a_vertices->getUseTangentData() && !isWeldable(a_vertices->m_tangent[a_index0], a_vertices->m_tangent[a_index1], a_tolerance)) { return (false); }
+    if (a_vertices->getUseBitangentData() && !isWeldable(a_vertices->m_bitangent[a_index0], a_vertices->m_bitangent[a_index1], a_tolerance)) { return (false); }
+    if (a_vertices->getUseColorData())
+    {
+        for (int i=0; i<4; i++)
+        {
+            if (cAbs(a_vertices->m_color[a_index0].m_color[i] - a_vertices->m_color[a_index1].m_color[i]) > a_tolerance) { return (false); }
+        }
+    }
+    if (a_vertices->getUseUserData() && (a_vertices->m_userData[a_index0] != a_vertices->m_userData[a_index1])) { return (false); }
+    return (true);
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    This function maps every vertex of an array to the first vertex whose
+    position, normal, texture coordinate, color, tangent and bitangent, as
+    far as the array holds them, differ by no more than a tolerance.
+    Vertices are hashed into a grid of cells the size of the tolerance, so
+    only vertices of neighbouring cells are compared. Without a tolerance,
+    only vertices holding exactly the same data are welded.
+
+    \param  a_vertices   Vertex array.
+    \param  a_remap      Returns the index each vertex has once welded.
+    \param  a_tolerance  Largest difference of any value of two welded vertices.
+
+    \return Number of vertices left once welded.
+*/
+//==============================================================================
+unsigned int cComputeVertexWeld(cVertexArrayPtr a_vertices,
+    std::vector<unsigned int>& a_remap,
+    const double a_tolerance)
+{
+    unsigned int numVertices = a_vertices->getNumElements();
+    double tolerance = cMax(a_tolerance, 0.0);
+    int range = (tolerance > 0.0) ? 1 : 0;
+
+    // first vertex kept in each cell, and the next one kept in the same cell
+    std::unordered_map<cWeldCell, unsigned int, cWeldCellHash> cells;
+    std::vector<unsigned int> next(numVertices, C_OPTIMIZER_NONE);
+    cells.reserve(numVertices);
+
+    a_remap.assign(numVertices, C_OPTIMIZER_NONE);
+    unsigned int numWelded = 0;
+
+    for (unsigned int i=0; i<numVertices; i++)
+    {
+        const cVector3d& pos = a_vertices->m_localPos[i];
+        cWeldCell cell;
+        cell.m_x = getWeldCellCoordinate(pos(0), tolerance);
+        cell.m_y = getWeldCellCoordinate(pos(1), tolerance);
+        cell.m_z = getWeldCellCoordinate(pos(2), tolerance);
+
+        // look for a vertex already kept in this cell or its neighbours
+        unsigned int match = C_OPTIMIZER_NONE;
+        for (int x=-range; (x<=range) && (match == C_OPTIMIZER_NONE); x++)
+        {
+            for (int y=-range; (y<=range) && (match == C_OPTIMIZER_NONE); y++)
+            {
+                for (int z=-range; (z<=range) && (match == C_OPTIMIZER_NONE); z++)
+                {
+                    cWeldCell neighbour = { cell.m_x + x, cell.m_y + y, cell.m_z + z };
+                    std::unordered_map<cWeldCell, unsigned int, cWeldCellHash>::const_iterator it = cells.find(neighbour);
+                    if (it == cells.end()) { continue; }
+
+                    for (unsigned int j=it->second; j!=C_OPTIMIZER_NONE; j=next[j])
+                    {
+                        if (isWeldable(a_vertices, i, j, tolerance))
+                        {
+                            match = j;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (match != C_OPTIMIZER_NONE)
+        {
+            a_remap[i] = a_remap[match];
+        }
+        else
+        {
+            // keep the vertex, first in its cell
+            std::unordered_map<cWeldCell, unsigned int, cWeldCellHash>::iterator it = cells.find(cell);
+            if (it != cells.end())
+            {
+                next[i] = it->second;
+                it->second = i;
+            }
+            else
+            {
+                cells[cell] = i;
+            }
+            a_remap[i] = numWelded;
+            numWelded++;
+        }
+    }
+
+    return (numWelded);
+}
+
+
+//==============================================================================
+/*!
+    This function computes an order of triangles that reuses the vertices
+    left in the post-transform vertex cache, using the Tipsify algorithm of
+    Sander, Nehab and Barczak (2007). Triangles are emitted by fanning around
+    a vertex, and the next vertex to fan around is picked among the vertices
+    of the last triangles by how likely it still is in the cache.
+
+    \param  a_indices      Vertex indices, three per triangle.
+    \param  a_numVertices  Number of vertices the indices refer to.
+    \param  a_order        Returns the triangles in their new order.
+    \param  a_cacheSize    Number of vertices of the cache.
+*/
+//==============================================================================
+void cComputeTriangleOrder(const std::vector<unsigned int>& a_indices,
+    const unsigned int a_numVertices,
+    std::vector<unsigned int>& a_order,
+    const unsigned int a_cacheSize)
+{
+    unsigned int numTriangles = (unsigned int)(a_indices.size() / 3);
+    int cacheSize = (int)(cMax(a_cacheSize, 3u));
+
+    a_order.clear();
+    a_order.reserve(numTriangles);
+
+    // triangles using each vertex, and how many of them are not emitted yet
+    std::vector<unsigned int> live(a_numVertices, 0);
+    for (unsigned int i=0; i<3*numTriangles; i++)
+    {
+        live[a_indices[i]]++;
+    }
+
+    std::vector<unsigned int> offsets(a_numVertices + 1, 0);
+    for (unsigned int i=0; i<a_numVertices; i++)
+    {
+        offsets[i+1] = offsets[i] + live[i];
+    }
+
+    std::vector<unsigned int> adjacency(3*numTriangles);
+    std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+    for (unsigned int i=0; i<3*numTriangles; i++)
+    {
+        adjacency[fill[a_indices[i]]++] = i / 3;
+    }
+
+    // time each vertex last entered the cache
+    std::vector<int> cacheTime(a_numVertices, 0);
+    std::vector<bool> emitted(numTriangles, false);
+    std::vector<unsigned int> deadEnds;
+    std::vector<unsigned int> candidates;
+    int time = cacheSize + 1;
+    unsigned int cursor = 0;
+    unsigned int fanning = C_OPTIMIZER_NONE;
+
+    while (true)
+    {
+        // when no vertex of the last triangles is left, go back to the most
+        // recent vertex with triangles left, or else to the next one in order
+        if (fanning == C_OPTIMIZER_NONE)
+        {
+            while (!deadEnds.empty() && (fanning == C_OPTIMIZER_NONE))
+            {
+                unsigned int vertex = deadEnds.back();
+                deadEnds.pop_back();
+                if (live[vertex] > 0) { fanning = vertex; }
+            }
+            while ((cursor < a_numVertices) && (fanning == C_OPTIMIZER_NONE))
+            {
+                if (live[cursor] > 0) { fanning = cursor; }
+                cursor++;
+            }
+            if (fanning == C_OPTIMIZER_NONE) { break; }
+        }
+
+        // emit every triangle left around the fanning vertex
+        candidates.clear();
+        for (unsigned int i=offsets[fanning]; i<offsets[fanning+1]; i++)
+        {
+            unsigned int triangle = adjacency[i];
+            if (emitted[triangle]) { continue; }
+
+            for (unsigned int j=0; j<3; j++)
+            {
+                unsigned int vertex = a_indices[3*triangle+j];
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+                live[vertex]--;
+                if (time - cacheTime[vertex] > cacheSize)
+                {
+                    cacheTime[vertex] = time;
+                    time++;
+                }
+            }
+            emitted[triangle] = true;
+            a_order.push_back(triangle);
+        }
+
+        // fan next around the candidate that is in the cache the longest
+        // while still having all its triangles emitted before it leaves it
+        fanning = C_OPTIMIZER_NONE;
+        int best = -1;
+        for (unsigned int i=0; i<candidates.size(); i++)
+        {
+            unsigned int vertex = candidates[i];
+            if (live[vertex] == 0) { continue; }
+
+            int priority = 0;
+            if (time - cacheTime[vertex] + 2 * (int)(live[vertex]) <= cacheSize)
+            {
+                priority = time - cacheTime[vertex];
+            }
+            if (priority > best)
+            {
+                best = priority;
+                fanning = vertex;
+            }
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This function maps every vertex to its position in the order triangles
+    first use them, so vertices are fetched from memory mostly in sequence.
+    Vertices no triangle uses are moved after all others in their order.
+
+    \param  a_indices      Vertex indices, three per triangle.
+    \param  a_numVertices  Number of vertices the indices refer to.
+    \param  a_remap        Returns the new index of every vertex.
+*/
+//==============================================================================
+void cComputeVertexFetchOrder(const std::vector<unsigned int>& a_indices,
+    const unsigned int a_numVertices,
+    std::vector<unsigned int>& a_remap)
+{
+    a_remap.assign(a_numVertices, C_OPTIMIZER_NONE);
+
+    unsigned int count = 0;
+    for (size_t i=0; i<a_indices.size(); i++)
+    {
+        unsigned int vertex = a_indices[i];
+        if (a_remap[vertex] == C_OPTIMIZER_NONE)
+        {
+            a_remap[vertex] = count;
+            count++;
+        }
+    }
+
+    for (unsigned int i=0; i<a_numVertices; i++)
+    {
+        if (a_remap[i] == C_OPTIMIZER_NONE)
+        {
+            a_remap[i] = count;
+            count++;
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This function computes the average cache miss ratio of triangles drawn in
+    the order of their indices through a first-in first-out vertex cache:
+    the number of vertices transformed divided by the number of triangles.
+
+    \param  a_indices      Vertex indices, three per triangle.
+    \param  a_numVertices  Number of vertices the indices refer to.
+    \param  a_cacheSize    Number of vertices of the cache.
+
+    \return Average number of cache misses per triangle.
+*/
+//==============================================================================
+double cComputeACMR(const std::vector<unsigned int>& a_indices,
+    const unsigned int a_numVertices,
+    const unsigned int a_cacheSize)
+{
+    unsigned int numTriangles = (unsigned int)(a_indices.size() / 3);
+    if (numTriangles == 0) { return (0.0); }
+
+    // number of misses when each vertex entered the cache, zero if never
+    std::vector<unsigned int> entered(a_numVertices, 0);
+    unsigned int misses = 0;
+
+    for (unsigned int i=0; i<3*numTriangles; i++)
+    {
+        unsigned int vertex = a_indices[i];
+        if ((entered[vertex] == 0) || (misses - entered[vertex] >= a_cacheSize))
+        {
+            misses++;
+            entered[vertex] = misses;
+        }
+    }
+
+    return ((double)(misses) / (double)(numTriangles));
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
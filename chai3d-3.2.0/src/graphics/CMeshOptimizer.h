@@ -0,0 +1,176 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Brandon Sieu, Glenn Skelton
+    \version   3.2.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CMeshOptimizerH
+#define CMeshOptimizerH
+//------------------------------------------------------------------------------
+#include "graphics/CVertexArray.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CMeshOptimizer.h
+    \ingroup    graphics
+
+    \brief
+    Implements functions that weld and reorder vertices and triangles for
+    the post-transform vertex cache.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// GENERAL CONSTANTS
+//------------------------------------------------------------------------------
+//! Number of vertices of the post-transform cache the triangle order is optimized for.
+const unsigned int C_VERTEX_CACHE_SIZE = 16;
+
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    \struct     cMeshOptimizationReport
+    \ingroup    graphics
+
+    \brief
+    This structure reports what an optimization did to a mesh.
+
+    \details
+    The average cache miss ratio (ACMR) is the number of vertices transformed
+    per triangle drawn through a FIFO post-transform cache of the size the
+    mesh was optimized for. It lies between about 0.5 for a perfect order and
+    3.0 when no vertex is ever reused.
+*/
+//==============================================================================
+struct cMeshOptimizationReport
+{
+    //! Constructor of cMeshOptimizationReport.
+    cMeshOptimizationReport()
+    {
+        m_numVerticesBefore = 0;
+        m_numVerticesAfter = 0;
+        m_numTriangles = 0;
+        m_acmrBefore = 0.0;
+        m_acmrAfter = 0.0;
+    }
+
+    //! This method adds the report of another mesh, weighting the miss ratios by the number of triangles.
+    void add(const cMeshOptimizationReport& a_report)
+    {
+        unsigned int numTriangles = m_numTriangles + a_report.m_numTriangles;
+        if (numTriangles > 0)
+        {
+            m_acmrBefore = (m_acmrBefore * m_numTriangles + a_report.m_acmrBefore * a_report.m_numTriangles) / numTriangles;
+            m_acmrAfter = (m_acmrAfter * m_numTriangles + a_report.m_acmrAfter * a_report.m_numTriangles) / numTriangles;
+        }
+        m_numVerticesBefore += a_report.m_numVerticesBefore;
+        m_numVerticesAfter += a_report.m_numVerticesAfter;
+        m_numTriangles = numTriangles;
+    }
+
+    //! Number of vertices before the optimization.
+    unsigned int m_numVerticesBefore;
+
+    //! Number of vertices after the optimization.
+    unsigned int m_numVerticesAfter;
+
+    //! Number of triangles.
+    unsigned int m_numTriangles;
+
+    //! Average cache miss ratio before the optimization.
+    double m_acmrBefore;
+
+    //! Average cache miss ratio after the optimization.
+    double m_acmrAfter;
+};
+
+
+//------------------------------------------------------------------------------
+// GENERAL PURPOSE FUNCTIONS
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/*!
+    \addtogroup graphics
+*/
+//------------------------------------------------------------------------------
+
+//@{
+
+//! This function maps every vertex of an array to the first one whose data differs by no more than a tolerance.
+unsigned int cComputeVertexWeld(cVertexArrayPtr a_vertices,
+    std::vector<unsigned int>& a_remap,
+    const double a_tolerance = 0.0);
+
+//! This function computes an order of triangles for the post-transform vertex cache (Tipsify).
+void cComputeTriangleOrder(const std::vector<unsigned int>& a_indices,
+    const unsigned int a_numVertices,
+    std::vector<unsigned int>& a_order,
+    const unsigned int a_cacheSize = C_VERTEX_CACHE_SIZE);
+
+//! This function maps every vertex to its position in the order triangles first use them.
+void cComputeVertexFetchOrder(const std::vector<unsigned int>& a_indices,
+    const unsigned int a_numVertices,
+    std::vector<unsigned int>& a_remap);
+
+//! This function computes the average cache miss ratio of triangles drawn through a FIFO vertex cache.
+double cComputeACMR(const std::vector<unsigned int>& a_indices,
+    const unsigned int a_numVertices,
+    const unsigned int a_cacheSize = C_VERTEX_CACHE_SIZE);
+
+//@}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -0,0 +1,596 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Brandon Sieu, Glenn Skelton
+    \version   3.2.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "graphics/CTessellationCache.h"
+//------------------------------------------------------------------------------
+#include "math/CMaths.h"
+#include "shaders/CShader.h"
+#ifdef C_USE_OPENGL
+#include "graphics/COpenGLHeaders.h"
+#endif
+//------------------------------------------------------------------------------
+#include <cmath>
+#include <map>
+#include <mutex>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// GENERAL CONSTANTS
+//------------------------------------------------------------------------------
+//! Floats per vertex of a tessellation: position, normal and texture coordinate.
+const int C_TESSELLATION_VERTEX_FLOATS = 8;
+
+//! Number of tessellations no object uses that the cache keeps before deleting them.
+const unsigned int C_TESSELLATION_MAX_UNUSED = 32;
+
+//------------------------------------------------------------------------------
+
+//! Tessellations of the cache by key.
+static std::map<cTessellationKey, cTessellation*>& getTessellations()
+{
+    static std::map<cTessellationKey, cTessellation*> tessellations;
+    return (tessellations);
+}
+
+//! Lock of the cache, objects may be released from any thread.
+static std::mutex& getTessellationLock()
+{
+    static std::mutex lock;
+    return (lock);
+}
+
+
+//==============================================================================
+/*!
+    Constructor of cTessellation. The triangles of the shape are generated
+    here, the OpenGL buffers when the tessellation is first rendered.
+
+    \param  a_key  Shape, size and resolution to tessellate.
+*/
+//==============================================================================
+cTessellation::cTessellation(const cTessellationKey& a_key)
+{
+    m_key = a_key;
+    m_numIndices = 0;
+    m_vertexBuffer = 0;
+    m_indexBuffer = 0;
+    m_numUsers = 0;
+
+    switch (m_key.m_shape)
+    {
+        case C_TESSELLATION_CYLINDER:
+            buildCylinder(m_key.m_size[0], m_key.m_size[1], m_key.m_size[2], m_key.m_resolution);
+            break;
+
+        case C_TESSELLATION_SPHERE:
+            buildSphere(m_key.m_size[0], m_key.m_resolution);
+            break;
+
+        case C_TESSELLATION_TORUS:
+            buildTorus(m_key.m_size[0], m_key.m_size[1], m_key.m_resolution);
+            break;
+    }
+
+    m_numIndices = (unsigned int)(m_indices.size());
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cTessellation.
+*/
+//==============================================================================
+cTessellation::~cTessellation()
+{
+}
+
+
+//==============================================================================
+/*!
+    This method adds a vertex to the tessellation.
+
+    \param  a_x   X coordinate of the position.
+    \param  a_y   Y coordinate of the position.
+    \param  a_z   Z coordinate of the position.
+    \param  a_nx  X coordinate of the normal.
+    \param  a_ny  Y coordinate of the normal.
+    \param  a_nz  Z coordinate of the normal.
+    \param  a_s   First texture coordinate.
+    \param  a_t   Second texture coordinate.
+*/
+//==============================================================================
+void cTessellation::addVertex(const double a_x, const double a_y, const double a_z,
+                              const double a_nx, const double a_ny, const double a_nz,
+                              const double a_s, const double a_t)
+{
+    m_vertices.push_back((float)a_x);
+    m_vertices.push_back((float)a_y);
+    m_vertices.push_back((float)a_z);
+    m_vertices.push_back((float)a_nx);
+    m_vertices.push_back((float)a_ny);
+    m_vertices.push_back((float)a_nz);
+    m_vertices.push_back((float)a_s);
+    m_vertices.push_back((float)a_t);
+}
+
+
+//==============================================================================
+/*!
+    This method generates the triangles of a cylinder standing on the origin
+    along the z axis, closed at both ends. Vertices, normals and texture
+    coordinates are laid out as __gluCylinder()__ and __gluDisk()__ lay them
+    out, so textures map onto the cylinder as they did.
+
+    \param  a_baseRadius  Radius at z = 0.
+    \param  a_topRadius   Radius at z = __a_height__.
+    \param  a_height      Height of the cylinder.
+    \param  a_resolution  Number of slices around and stacks along the cylinder.
+*/
+//==============================================================================
+void cTessellation::buildCylinder(const double a_baseRadius,
+                                  const double a_topRadius,
+                                  const double a_height,
+                                  const unsigned int a_resolution)
+{
+    unsigned int slices = cMax(a_resolution, (unsigned int)3);
+    unsigned int stacks = cMax(a_resolution, (unsigned int)1);
+
+    // the normals lean along the axis by the slope of the side
+    double deltaRadius = a_baseRadius - a_topRadius;
+    double length = sqrt(deltaRadius * deltaRadius + a_height * a_height);
+    double zNormal = (length > 0.0) ? deltaRadius / length : 0.0;
+    double xyNormal = (length > 0.0) ? a_height / length : 1.0;
+
+    m_vertices.reserve(((slices + 1) * (stacks + 1) + 2 * (slices + 2)) * C_TESSELLATION_VERTEX_FLOATS);
+    m_indices.reserve(6 * slices * stacks + 6 * slices);
+
+    // side
+    for (unsigned int j=0; j<=stacks; j++)
+    {
+        double t = (double)j / (double)stacks;
+        double radius = a_baseRadius + t * (a_topRadius - a_baseRadius);
+        for (unsigned int i=0; i<=slices; i++)
+        {
+            double angle = C_TWO_PI * (double)i / (double)slices;
+            double s = sin(angle);
+            double c = cos(angle);
+            addVertex(radius * s, radius * c, t * a_height, xyNormal * s, xyNormal * c, zNormal, 1.0 - (double)i / (double)slices, t);
+        }
+    }
+    for (unsigned int j=0; j<stacks; j++)
+    {
+        for (unsigned int i=0; i<slices; i++)
+        {
+            unsigned int a = j * (slices + 1) + i;
+            unsigned int b = a + slices + 1;
+            m_indices.push_back(a);
+            m_indices.push_back(b);
+            m_indices.push_back(a + 1);
+            m_indices.push_back(a + 1);
+            m_indices.push_back(b);
+            m_indices.push_back(b + 1);
+        }
+    }
+
+    // bottom and top disks, as triangle fans around their centre
+    for (int end=0; end<2; end++)
+    {
+        double radius = (end == 0) ? a_baseRadius : a_topRadius;
+        double z = (end == 0) ? 0.0 : a_height;
+        double nz = (end == 0) ? -1.0 : 1.0;
+        if (radius <= 0.0) continue;
+
+        unsigned int centre = (unsigned int)(m_vertices.size() / C_TESSELLATION_VERTEX_FLOATS);
+        addVertex(0.0, 0.0, z, 0.0, 0.0, nz, 0.5, 0.5);
+        for (unsigned int i=0; i<=slices; i++)
+        {
+            double angle = C_TWO_PI * (double)i / (double)slices;
+            double s = sin(angle);
+            double c = cos(angle);
+            addVertex(radius * s, radius * c, z, 0.0, 0.0, nz, 0.5 + 0.5 * s, 0.5 + 0.5 * c);
+        }
+        for (unsigned int i=0; i<slices; i++)
+        {
+            // the slices turn clockwise seen from +z, so the winding faces the disk along its normal
+            m_indices.push_back(centre);
+            m_indices.push_back((end == 0) ? centre + 1 + i : centre + 2 + i);
+            m_indices.push_back((end == 0) ? centre + 2 + i : centre + 1 + i);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method generates the triangles of a sphere centred on the origin,
+    laid out as __gluSphere()__ lays them out.
+
+    \param  a_radius      Radius of the sphere.
+    \param  a_resolution  Number of slices around and stacks along the sphere.
+*/
+//==============================================================================
+void cTessellation::buildSphere(const double a_radius,
+                                const unsigned int a_resolution)
+{
+    unsigned int slices = cMax(a_resolution, (unsigned int)3);
+    unsigned int stacks = cMax(a_resolution, (unsigned int)2);
+
+    m_vertices.reserve((slices + 1) * (stacks + 1) * C_TESSELLATION_VERTEX_FLOATS);
+    m_indices.reserve(6 * slices * stacks);
+
+    for (unsigned int j=0; j<=stacks; j++)
+    {
+        double rho = C_PI * (double)j / (double)stacks;
+        double sinRho = sin(rho);
+        double cosRho = cos(rho);
+        for (unsigned int i=0; i<=slices; i++)
+        {
+            double theta = C_TWO_PI * (double)i / (double)slices;
+            double nx = sin(theta) * sinRho;
+            double ny = cos(theta) * sinRho;
+            addVertex(a_radius * nx, a_radius * ny, a_radius * cosRho, nx, ny, cosRho,
+                      1.0 - (double)i / (double)slices, 1.0 - (double)j / (double)stacks);
+        }
+    }
+    for (unsigned int j=0; j<stacks; j++)
+    {
+        for (unsigned int i=0; i<slices; i++)
+        {
+            unsigned int a = j * (slices + 1) + i;
+            unsigned int b = a + slices + 1;
+            m_indices.push_back(a);
+            m_indices.push_back(a + 1);
+            m_indices.push_back(b);
+            m_indices.push_back(a + 1);
+            m_indices.push_back(b + 1);
+            m_indices.push_back(b);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method generates the triangles of a torus around the z axis, laid out
+    as __cDrawSolidTorus()__ lays them out. The torus has no texture
+    coordinates.
+
+    \param  a_innerRadius  Radius of the tube.
+    \param  a_outerRadius  Distance from the centre of the torus to the centre of the tube.
+    \param  a_resolution   Number of sides around the tube and rings around the torus.
+*/
+//==============================================================================
+void cTessellation::buildTorus(const double a_innerRadius,
+                               const double a_outerRadius,
+                               const unsigned int a_resolution)
+{
+    unsigned int sides = cMax(a_resolution, (unsigned int)1) + 1;
+    unsigned int rings = cMax(a_resolution, (unsigned int)1) + 1;
+
+    m_vertices.reserve(sides * rings * C_TESSELLATION_VERTEX_FLOATS);
+    m_indices.reserve(6 * (sides - 1) * (rings - 1));
+
+    double dpsi =  C_TWO_PI / (double)(rings - 1);
+    double dphi = -C_TWO_PI / (double)(sides - 1);
+    for (unsigned int j=0; j<rings; j++)
+    {
+        double cpsi = cos(j * dpsi);
+        double spsi = sin(j * dpsi);
+        for (unsigned int i=0; i<sides; i++)
+        {
+            double cphi = cos(i * dphi);
+            double sphi = sin(i * dphi);
+            addVertex(cpsi * (a_outerRadius + cphi * a_innerRadius),
+                      spsi * (a_outerRadius + cphi * a_innerRadius),
+                      sphi * a_innerRadius,
+                      cpsi * cphi, spsi * cphi, sphi,
+                      0.0, 0.0);
+        }
+    }
+    for (unsigned int i=0; i<sides-1; i++)
+    {
+        for (unsigned int j=0; j<rings-1; j++)
+        {
+            unsigned int a = j * sides + i;
+            unsigned int b = a + sides;
+            m_indices.push_back(a);
+            m_indices.push_back(a + 1);
+            m_indices.push_back(b + 1);
+            m_indices.push_back(a);
+            m_indices.push_back(b + 1);
+            m_indices.push_back(b);
+        }
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method renders the tessellation using OpenGL, uploading it into
+    vertex buffers the first time. The vertices are bound both to the fixed
+    pipeline arrays and to the attributes of the CHAI3D shaders.
+
+    \param  a_useTexCoords  If __true__, texture coordinates are rendered.
+*/
+//==============================================================================
+void cTessellation::render(const bool a_useTexCoords)
+{
+#ifdef C_USE_OPENGL
+    // create buffers first time
+    if (m_vertexBuffer == 0)
+    {
+        glGenBuffers(1, &m_vertexBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(float), &(m_vertices[0]), GL_STATIC_DRAW);
+
+        glGenBuffers(1, &m_indexBuffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned int), &(m_indices[0]), GL_STATIC_DRAW);
+
+        // the graphic card holds the tessellation from now on
+        std::vector<float>().swap(m_vertices);
+        std::vector<unsigned int>().swap(m_indices);
+    }
+
+    GLsizei stride = C_TESSELLATION_VERTEX_FLOATS * sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, stride, (void*)0);
+    glEnableVertexAttribArray(C_VB_POSITION);
+    glVertexAttribPointer(C_VB_POSITION, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glNormalPointer(GL_FLOAT, stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(C_VB_NORMAL);
+    glVertexAttribPointer(C_VB_NORMAL, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+
+    if (a_useTexCoords)
+    {
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glTexCoordPointer(2, GL_FLOAT, stride, (void*)(6 * sizeof(float)));
+        glEnableVertexAttribArray(C_VB_TEXCOORD);
+        glVertexAttribPointer(C_VB_TEXCOORD, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+    }
+
+    // render triangles
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    glDrawElements(GL_TRIANGLES, m_numIndices, GL_UNSIGNED_INT, (void*)0);
+
+    // restore OpenGL settings
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableVertexAttribArray(C_VB_POSITION);
+    glDisableVertexAttribArray(C_VB_NORMAL);
+    if (a_useTexCoords)
+    {
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableVertexAttribArray(C_VB_TEXCOORD);
+    }
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method deletes the OpenGL buffers of the tessellation. It must be
+    called from the rendering thread.
+*/
+//==============================================================================
+void cTessellation::deleteBuffers()
+{
+#ifdef C_USE_OPENGL
+    if (m_vertexBuffer != 0)
+    {
+        glDeleteBuffers(1, &m_vertexBuffer);
+        glDeleteBuffers(1, &m_indexBuffer);
+    }
+#endif
+    m_vertexBuffer = 0;
+    m_indexBuffer = 0;
+}
+
+
+//==============================================================================
+/*!
+    This method returns the tessellation of a shape. An object keeps the
+    tessellation it last rendered and passes it back in every time it is
+    rendered, so the cache is only searched when the object changes size or
+    resolution. In that case the previous tessellation is released. Must be
+    called from the rendering thread.
+
+    \param  a_current  Tessellation the object rendered last, or __nullptr__.
+    \param  a_key      Shape, size and resolution to render.
+
+    \return Tessellation of __a_key__, to be passed in again next time.
+*/
+//==============================================================================
+cTessellation* cTessellationCache::acquire(cTessellation* a_current,
+                                           const cTessellationKey& a_key)
+{
+    if ((a_current != nullptr) && (a_current->m_key == a_key))
+    {
+        return (a_current);
+    }
+
+    std::lock_guard<std::mutex> lock(getTessellationLock());
+    std::map<cTessellationKey, cTessellation*>& tessellations = getTessellations();
+
+    if ((a_current != nullptr) && (a_current->m_numUsers > 0))
+    {
+        a_current->m_numUsers--;
+    }
+
+    // delete tessellations nobody uses once there are too many of them, the
+    // ones an object flips between stay cached until then
+    unsigned int numUnused = 0;
+    for (auto it = tessellations.begin(); it != tessellations.end(); ++it)
+    {
+        if (it->second->m_numUsers == 0) numUnused++;
+    }
+    if (numUnused > C_TESSELLATION_MAX_UNUSED)
+    {
+        for (auto it = tessellations.begin(); it != tessellations.end();)
+        {
+            if ((it->second->m_numUsers == 0) && !(it->first == a_key))
+            {
+                it->second->deleteBuffers();
+                delete (it->second);
+                it = tessellations.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // find or generate the tessellation
+    cTessellation*& tessellation = tessellations[a_key];
+    if (tessellation == nullptr)
+    {
+        tessellation = new cTessellation(a_key);
+    }
+    tessellation->m_numUsers++;
+
+    return (tessellation);
+}
+
+
+//==============================================================================
+/*!
+    This method tells the cache an object no longer renders a tessellation,
+    typically because the object is being deleted. It may be called from any
+    thread, the buffers are deleted later from the rendering thread.
+
+    \param  a_tessellation  Tessellation returned by acquire(), or __nullptr__.
+*/
+//==============================================================================
+void cTessellationCache::release(cTessellation* a_tessellation)
+{
+    if (a_tessellation == nullptr) return;
+
+    std::lock_guard<std::mutex> lock(getTessellationLock());
+    if (a_tessellation->m_numUsers > 0)
+    {
+        a_tessellation->m_numUsers--;
+    }
+}
+
+
+//==============================================================================
+/*!
+    This method selects the resolution of a shape from the size it is
+    projected to on screen, so that each segment of its outline spans about
+    C_TESSELLATION_PIXELS_PER_SEGMENT pixels. It reads the current OpenGL
+    matrices and viewport, so it must be called while the object is being
+    rendered. Resolutions are rounded up to multiples of
+    C_TESSELLATION_RESOLUTION_STEP.
+
+    \param  a_radius         Radius of the outline of the shape in its own frame.
+    \param  a_maxResolution  Resolution of the shape when seen up close.
+
+    \return Resolution between C_TESSELLATION_MIN_RESOLUTION and __a_maxResolution__.
+*/
+//==============================================================================
+unsigned int cTessellationCache::selectResolution(const double a_radius,
+                                                  const unsigned int a_maxResolution)
+{
+    if (a_maxResolution <= C_TESSELLATION_MIN_RESOLUTION) return (a_maxResolution);
+
+#ifdef C_USE_OPENGL
+    GLdouble modelview[16];
+    GLdouble projection[16];
+    GLint viewport[4];
+    glGetDoublev(GL_MODELVIEW_MATRIX, modelview);
+    glGetDoublev(GL_PROJECTION_MATRIX, projection);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    // radius in the eye frame, the object may be scaled by its parents
+    double scale = sqrt(modelview[0] * modelview[0] + modelview[1] * modelview[1] + modelview[2] * modelview[2]);
+    double radius = scale * a_radius;
+
+    // radius in pixels, perspective projections shrink it with the distance to the camera
+    double pixels = radius * projection[5] * 0.5 * (double)viewport[3];
+    if (projection[15] == 0.0)
+    {
+        double depth = -modelview[14];
+        if (depth <= radius) return (a_maxResolution);
+        pixels = pixels / depth;
+    }
+
+    double segments = C_TWO_PI * fabs(pixels) / C_TESSELLATION_PIXELS_PER_SEGMENT;
+    unsigned int resolution = (unsigned int)(ceil(segments / (double)C_TESSELLATION_RESOLUTION_STEP)) * C_TESSELLATION_RESOLUTION_STEP;
+
+    if (segments >= (double)a_maxResolution) return (a_maxResolution);
+    return (cClamp(resolution, C_TESSELLATION_MIN_RESOLUTION, a_maxResolution));
+#else
+    return (a_maxResolution);
+#endif
+}
+
+
+//==============================================================================
+/*!
+    This method returns the number of tessellations in the cache, used or not.
+
+    \return Number of tessellations.
+*/
+//==============================================================================
+unsigned int cTessellationCache::getNumTessellations()
+{
+    std::lock_guard<std::mutex> lock(getTessellationLock());
+    return ((unsigned int)getTessellations().size());
+}
+
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,302 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Brandon Sieu, Glenn Skelton
+    \version   3.2.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CTessellationCacheH
+#define CTessellationCacheH
+//------------------------------------------------------------------------------
+#include "system/CGlobals.h"
+//------------------------------------------------------------------------------
+#include <vector>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CTessellationCache.h
+    \ingroup    graphics
+
+    \brief
+    Implements a cache of tessellated shapes stored in vertex buffers.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// GENERAL CONSTANTS
+//------------------------------------------------------------------------------
+//! Lowest resolution the level of detail selects.
+const unsigned int C_TESSELLATION_MIN_RESOLUTION = 8;
+
+//! Resolutions selected by the level of detail are multiples of this step, which bounds the number of cached tessellations of a shape.
+const unsigned int C_TESSELLATION_RESOLUTION_STEP = 4;
+
+//! Length in pixels of a segment of the outline of a shape, as the level of detail aims for.
+const double C_TESSELLATION_PIXELS_PER_SEGMENT = 6.0;
+
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    \brief
+    Shapes the tessellation cache can generate.
+*/
+//==============================================================================
+enum cTessellationShape
+{
+    C_TESSELLATION_CYLINDER,
+    C_TESSELLATION_SPHERE,
+    C_TESSELLATION_TORUS
+};
+
+
+//==============================================================================
+/*!
+    \struct     cTessellationKey
+    \ingroup    graphics
+
+    \brief
+    This structure identifies a tessellation by its shape, size and resolution.
+
+    \details
+    The sizes are, for a cylinder, its base radius, top radius and height, for
+    a sphere, its radius and for a torus, its inner and outer radii. Unused
+    sizes are zero.
+*/
+//==============================================================================
+struct cTessellationKey
+{
+    //! Constructor of cTessellationKey.
+    cTessellationKey(const cTessellationShape a_shape = C_TESSELLATION_SPHERE,
+                     const double a_size0 = 0.0,
+                     const double a_size1 = 0.0,
+                     const double a_size2 = 0.0,
+                     const unsigned int a_resolution = 0)
+    {
+        m_shape = a_shape;
+        m_size[0] = a_size0;
+        m_size[1] = a_size1;
+        m_size[2] = a_size2;
+        m_resolution = a_resolution;
+    }
+
+    //! Operator that tells if two keys name the same tessellation.
+    bool operator==(const cTessellationKey& a_key) const
+    {
+        return ((m_shape == a_key.m_shape) &&
+                (m_size[0] == a_key.m_size[0]) &&
+                (m_size[1] == a_key.m_size[1]) &&
+                (m_size[2] == a_key.m_size[2]) &&
+                (m_resolution == a_key.m_resolution));
+    }
+
+    //! Operator that orders keys in the cache.
+    bool operator<(const cTessellationKey& a_key) const
+    {
+        if (m_shape != a_key.m_shape) return (m_shape < a_key.m_shape);
+        if (m_resolution != a_key.m_resolution) return (m_resolution < a_key.m_resolution);
+        for (int i=0; i<3; i++)
+        {
+            if (m_size[i] != a_key.m_size[i]) return (m_size[i] < a_key.m_size[i]);
+        }
+        return (false);
+    }
+
+    //! Shape.
+    cTessellationShape m_shape;
+
+    //! Sizes of the shape.
+    double m_size[3];
+
+    //! Number of segments around and along the shape.
+    unsigned int m_resolution;
+};
+
+
+//==============================================================================
+/*!
+    \class      cTessellation
+    \ingroup    graphics
+
+    \brief
+    This class holds one tessellated shape.
+
+    \details
+    __cTessellation__ stores the triangles of a shape as an interleaved array
+    of positions, normals and texture coordinates with an index array. Both
+    are copied into OpenGL buffers the first time the tessellation is
+    rendered. Tessellations are created and shared by __cTessellationCache__.
+*/
+//==============================================================================
+class cTessellation
+{
+    friend class cTessellationCache;
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the key of the tessellation.
+    const cTessellationKey& getKey() const { return (m_key); }
+
+    //! This method returns the number of triangles of the tessellation.
+    unsigned int getNumTriangles() const { return (m_numIndices / 3); }
+
+    //! This method renders the tessellation using OpenGL.
+    void render(const bool a_useTexCoords);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Constructor of cTessellation.
+    cTessellation(const cTessellationKey& a_key);
+
+    //! Destructor of cTessellation.
+    ~cTessellation();
+
+    //! This method adds a vertex to the tessellation.
+    void addVertex(const double a_x, const double a_y, const double a_z,
+                   const double a_nx, const double a_ny, const double a_nz,
+                   const double a_s, const double a_t);
+
+    //! This method generates the triangles of a cylinder.
+    void buildCylinder(const double a_baseRadius, const double a_topRadius, const double a_height, const unsigned int a_resolution);
+
+    //! This method generates the triangles of a sphere.
+    void buildSphere(const double a_radius, const unsigned int a_resolution);
+
+    //! This method generates the triangles of a torus.
+    void buildTorus(const double a_innerRadius, const double a_outerRadius, const unsigned int a_resolution);
+
+    //! This method deletes the OpenGL buffers.
+    void deleteBuffers();
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Key of the tessellation.
+    cTessellationKey m_key;
+
+    //! Position, normal and texture coordinate of each vertex, released once uploaded.
+    std::vector<float> m_vertices;
+
+    //! Three vertex indices per triangle, released once uploaded.
+    std::vector<unsigned int> m_indices;
+
+    //! Number of indices.
+    unsigned int m_numIndices;
+
+    //! OpenGL buffer of the vertices, 0 until uploaded.
+    unsigned int m_vertexBuffer;
+
+    //! OpenGL buffer of the indices, 0 until uploaded.
+    unsigned int m_indexBuffer;
+
+    //! Number of objects rendering the tessellation.
+    unsigned int m_numUsers;
+};
+
+
+//==============================================================================
+/*!
+    \class      cTessellationCache
+    \ingroup    graphics
+
+    \brief
+    This class implements a cache of tessellated shapes shared by all objects.
+
+    \details
+    __cTessellationCache__ generates the triangles of a cylinder, sphere or
+    torus once for each size and resolution and keeps them in OpenGL vertex
+    buffers, so shapes no longer tessellate themselves every time they are
+    rendered and shapes of the same size share one set of buffers. Objects
+    hold the tessellation they last rendered and only request another when
+    their size or resolution changes. Tessellations nobody uses any more are
+    deleted the next time the cache is asked for one, from the rendering
+    thread.\n
+
+    selectResolution() implements a level of detail, picking the resolution of
+    a shape from the size it is projected to on screen.
+*/
+//==============================================================================
+class cTessellationCache
+{
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method returns the tessellation of a key, reusing __a_current__ if it already matches.
+    static cTessellation* acquire(cTessellation* a_current, const cTessellationKey& a_key);
+
+    //! This method tells the cache an object stopped using a tessellation.
+    static void release(cTessellation* a_tessellation);
+
+    //! This method returns the resolution of a shape of a given radius drawn with the current OpenGL matrices.
+    static unsigned int selectResolution(const double a_radius, const unsigned int a_maxResolution);
+
+    //! This method returns the number of tessellations in the cache.
+    static unsigned int getNumTessellations();
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -45,6 +45,7 @@
 #ifndef CVertexArrayH
 #define CVertexArrayH
 //------------------------------------------------------------------------------
+#include "math/CMaths.h"
 #include "math/CVector3d.h"
 #include "math/CMatrix3d.h"
 #include "graphics/CColor.h"
@@ -52,6 +53,7 @@
 //------------------------------------------------------------------------------
 #include <vector>
 #include <list>
+#include <cstring>
 //------------------------------------------------------------------------------
 namespace chai3d {
 //------------------------------------------------------------------------------
@@ -128,6 +130,13 @@ typedef std::shared_ptr<cVertexArray> cVertexArrayPtr;
     The properties of each vertex can be modified by calling the appropriate 
     methods and by passing the vertex index as argument with the associated
     data. \n
+
+    By default, each property is sent to the graphic card in its own double
+    precision buffer. When \ref setUseInterleavedBuffer() is enabled, the
+    properties are instead interleaved into a single buffer of 32-bit floats,
+    with normals, tangents and bitangents packed into 10 bits per component
+    and colors into 8 bits per component. Only the properties allocated by
+    this array are included.
 */
 //==============================================================================
 class cVertexArray
@@ -149,6 +158,7 @@ public:
     //--------------------------------------------------------------------------
     cVertexArray(const cVertexArrayOptions& a_options)
     {
+        m_interleavedBuffer = (GLuint)(-1);
         clear();
         m_useNormalData     = a_options.m_useNormalData;
         m_useTexCoordData   = a_options.m_useTexCoordData;
@@ -170,6 +180,14 @@ public:
         m_colorBuffer       = (GLuint)(-1);
         m_tangentBuffer     = (GLuint)(-1);
         m_bitangentBuffer   = (GLuint)(-1);
+        m_useInterleavedBuffer      = false;
+        m_interleavedPacked         = false;
+        m_interleavedStride         = 0;
+        m_interleavedNormalOffset   = 0;
+        m_interleavedTexCoordOffset = 0;
+        m_interleavedColorOffset    = 0;
+        m_interleavedTangentOffset  = 0;
+        m_interleavedBitangentOffset = 0;
     }
 
 
@@ -178,7 +196,10 @@ public:
         Destructor of cVertexArray.
     */
     //--------------------------------------------------------------------------
-    ~cVertexArray() {};
+    ~cVertexArray()
+    {
+        releaseInterleavedBuffer();
+    }
 
 
     //--------------------------------------------------------------------------
@@ -219,7 +240,9 @@ public:
 
     //--------------------------------------------------------------------------
     /*!
-        This method clears all vertex data.
+        This method clears all vertex data. The interleaved OpenGL buffer is
+        deleted too, so once it has been rendered the array must be cleared
+        from the rendering thread.
      */
     //--------------------------------------------------------------------------
     inline void clear()
@@ -234,6 +257,7 @@ public:
         m_userData.clear();
         m_numVertices = 0;
         m_flagBufferResize = true;
+        releaseInterleavedBuffer();
     }
 
 
@@ -269,6 +293,7 @@ public:
         vertexArray->m_useBitangentData = m_useBitangentData;
         vertexArray->m_useUserData = m_useUserData;
         vertexArray->m_numVertices = m_numVertices;
+        vertexArray->m_useInterleavedBuffer = m_useInterleavedBuffer;
 
         // return new vertex array
         return (vertexArray);
@@ -848,6 +873,48 @@ public:
     }
 
 
+    //--------------------------------------------------------------------------
+    /*!
+        This method enables or disables the interleaved OpenGL buffer. If
+        enabled, the allocated properties of the vertices are sent to the
+        graphic card in a single buffer of 32-bit floats, with packed normals,
+        tangents, bitangents and colors, instead of one double precision buffer
+        per property. Disabling it deletes the interleaved buffer, so it must
+        then be done from the rendering thread.
+
+        \param  a_useInterleavedBuffer  If __true__ then the interleaved buffer is used.
+    */
+    //--------------------------------------------------------------------------
+    inline void setUseInterleavedBuffer(const bool a_useInterleavedBuffer)
+    {
+        if (a_useInterleavedBuffer != m_useInterleavedBuffer)
+        {
+            m_useInterleavedBuffer = a_useInterleavedBuffer;
+            m_flagBufferResize = true;
+
+            // the separate buffers are used again
+            if (!m_useInterleavedBuffer)
+            {
+                releaseInterleavedBuffer();
+            }
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method returns __true__ if the interleaved OpenGL buffer is used,
+        __false__ otherwise.
+
+        \return __true__ if the interleaved buffer is used, __false__ otherwise.
+    */
+    //--------------------------------------------------------------------------
+    inline bool getUseInterleavedBuffer() const
+    {
+        return (m_useInterleavedBuffer);
+    }
+
+
     //--------------------------------------------------------------------------
     /*!
         This method allocates or updates all OpenGL buffers.
@@ -856,6 +923,13 @@ public:
     inline void renderInitialize()
     { 
 #ifdef C_USE_OPENGL
+        // render from a single interleaved buffer if enabled
+        if (m_useInterleavedBuffer)
+        {
+            renderInitializeInterleaved();
+            return;
+        }
+
         // create buffers first time
         if (m_positionBuffer == (GLuint)(-1))
         {
@@ -1207,6 +1281,301 @@ public:
     }
 
 
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method packs a vector whose components lie between -1 and 1 into
+        a signed 2-10-10-10 integer, as read by OpenGL with the
+        GL_INT_2_10_10_10_REV type.
+
+        \param  a_vector  Vector to pack.
+
+        \return Packed vector.
+    */
+    //--------------------------------------------------------------------------
+    static inline unsigned int packInterleavedVector(const cVector3d& a_vector)
+    {
+        unsigned int packed = 0;
+        for (int i=0; i<3; i++)
+        {
+            int value = (int)(floor(cClamp(a_vector(i), -1.0, 1.0) * 511.0 + 0.5));
+            packed |= ((unsigned int)(value) & 0x3ff) << (10 * i);
+        }
+        return (packed);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method packs a color into four unsigned bytes.
+
+        \param  a_color  Color to pack.
+
+        \return Packed color.
+    */
+    //--------------------------------------------------------------------------
+    static inline unsigned int packInterleavedColor(const cColorf& a_color)
+    {
+        unsigned char packed[4];
+        for (int i=0; i<4; i++)
+        {
+            packed[i] = (unsigned char)(floor(cClamp(a_color[i], 0.0f, 1.0f) * 255.0f + 0.5f));
+        }
+        unsigned int result;
+        memcpy(&result, packed, sizeof(result));
+        return (result);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method writes a vector into the interleaved data of a vertex,
+        either packed or as three floats.
+
+        \param  a_data    Interleaved data of the vertex.
+        \param  a_vector  Vector to write.
+        \param  a_packed  If __true__ then the vector is packed.
+    */
+    //--------------------------------------------------------------------------
+    static inline void writeInterleavedVector(unsigned char* a_data,
+                                              const cVector3d& a_vector,
+                                              const bool a_packed)
+    {
+        if (a_packed)
+        {
+            unsigned int packed = packInterleavedVector(a_vector);
+            memcpy(a_data, &packed, sizeof(packed));
+        }
+        else
+        {
+            float values[3] = { (float)a_vector(0), (float)a_vector(1), (float)a_vector(2) };
+            memcpy(a_data, values, sizeof(values));
+        }
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method computes the layout of the interleaved buffer from the
+        allocated properties of the vertices.
+    */
+    //--------------------------------------------------------------------------
+    inline void computeInterleavedLayout()
+    {
+        // packed vectors need OpenGL 3.3 or the matching extension
+        m_interleavedPacked = false;
+#ifdef GLEW_VERSION
+        m_interleavedPacked = (GLEW_VERSION_3_3 || GLEW_ARB_vertex_type_2_10_10_10_rev);
+#endif
+        unsigned int vectorSize = m_interleavedPacked ? sizeof(unsigned int) : 3 * sizeof(float);
+
+        // position
+        m_interleavedStride = 3 * sizeof(float);
+
+        // other properties, if allocated
+        m_interleavedNormalOffset = m_interleavedStride;
+        if (m_useNormalData) { m_interleavedStride += vectorSize; }
+
+        m_interleavedTexCoordOffset = m_interleavedStride;
+        if (m_useTexCoordData) { m_interleavedStride += 3 * sizeof(float); }
+
+        m_interleavedColorOffset = m_interleavedStride;
+        if (m_useColorData) { m_interleavedStride += sizeof(unsigned int); }
+
+        m_interleavedTangentOffset = m_interleavedStride;
+        if (m_useTangentData) { m_interleavedStride += vectorSize; }
+
+        m_interleavedBitangentOffset = m_interleavedStride;
+        if (m_useBitangentData) { m_interleavedStride += vectorSize; }
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method writes the modified properties of all vertices into the
+        interleaved data and clears their modification flags.
+
+        \param  a_all  If __true__ then all properties are written.
+    */
+    //--------------------------------------------------------------------------
+    inline void updateInterleavedData(const bool a_all)
+    {
+        bool position = a_all || m_flagPositionData;
+        bool normal = m_useNormalData && (a_all || m_flagNormalData);
+        bool texCoord = m_useTexCoordData && (a_all || m_flagTexCoordData);
+        bool color = m_useColorData && (a_all || m_flagColorData);
+        bool tangent = m_useTangentData && (a_all || m_flagTangentData);
+        bool bitangent = m_useBitangentData && (a_all || m_flagBitangentData);
+
+        for (unsigned int i=0; i<m_numVertices; i++)
+        {
+            unsigned char* data = &(m_interleavedData[(size_t)i * m_interleavedStride]);
+            if (position)
+            {
+                float values[3] = { (float)m_localPos[i](0), (float)m_localPos[i](1), (float)m_localPos[i](2) };
+                memcpy(data, values, sizeof(values));
+            }
+            if (normal)
+            {
+                writeInterleavedVector(data + m_interleavedNormalOffset, m_normal[i], m_interleavedPacked);
+            }
+            if (texCoord)
+            {
+                float values[3] = { (float)m_texCoord[i](0), (float)m_texCoord[i](1), (float)m_texCoord[i](2) };
+                memcpy(data + m_interleavedTexCoordOffset, values, sizeof(values));
+            }
+            if (color)
+            {
+                unsigned int packed = packInterleavedColor(m_color[i]);
+                memcpy(data + m_interleavedColorOffset, &packed, sizeof(packed));
+            }
+            if (tangent)
+            {
+                writeInterleavedVector(data + m_interleavedTangentOffset, m_tangent[i], m_interleavedPacked);
+            }
+            if (bitangent)
+            {
+                writeInterleavedVector(data + m_interleavedBitangentOffset, m_bitangent[i], m_interleavedPacked);
+            }
+        }
+
+        m_flagPositionData = false;
+        m_flagNormalData = false;
+        m_flagTexCoordData = false;
+        m_flagColorData = false;
+        m_flagTangentData = false;
+        m_flagBitangentData = false;
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method deletes the interleaved OpenGL buffer and its copy. Once
+        created, the buffer must be released while its OpenGL context is
+        current.
+    */
+    //--------------------------------------------------------------------------
+    inline void releaseInterleavedBuffer()
+    {
+#ifdef C_USE_OPENGL
+        if (m_interleavedBuffer != (GLuint)(-1))
+        {
+            glDeleteBuffers(1, &m_interleavedBuffer);
+        }
+#endif
+        m_interleavedBuffer = (GLuint)(-1);
+        std::vector<unsigned char>().swap(m_interleavedData);
+    }
+
+
+    //--------------------------------------------------------------------------
+    /*!
+        This method allocates or updates the interleaved OpenGL buffer and
+        binds it.
+    */
+    //--------------------------------------------------------------------------
+    inline void renderInitializeInterleaved()
+    {
+#ifdef C_USE_OPENGL
+        // create buffer first time
+        if (m_interleavedBuffer == (GLuint)(-1))
+        {
+            glGenBuffers(1, &m_interleavedBuffer);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_interleavedBuffer);
+
+        // resize buffer
+        if (m_flagBufferResize)
+        {
+            computeInterleavedLayout();
+            m_interleavedData.resize((size_t)m_numVertices * m_interleavedStride);
+            updateInterleavedData(true);
+            glBufferData(GL_ARRAY_BUFFER, m_interleavedData.size(), m_interleavedData.empty() ? NULL : &(m_interleavedData[0]), GL_STATIC_DRAW);
+            m_flagBufferResize = false;
+        }
+
+        // update buffer if needed
+        else if (m_flagPositionData || m_flagNormalData || m_flagTexCoordData ||
+                 m_flagColorData || m_flagTangentData || m_flagBitangentData)
+        {
+            updateInterleavedData(false);
+            if (!m_interleavedData.empty())
+            {
+                glBufferSubData(GL_ARRAY_BUFFER, 0, m_interleavedData.size(), &(m_interleavedData[0]));
+            }
+        }
+
+        // bind buffer and set client state
+        GLsizei stride = m_interleavedStride;
+        GLenum vectorType = m_interleavedPacked ? GL_INT_2_10_10_10_REV : GL_FLOAT;
+        GLint vectorSize = m_interleavedPacked ? 4 : 3;
+        GLboolean vectorNormalized = m_interleavedPacked ? GL_TRUE : GL_FALSE;
+
+        glEnableVertexAttribArray(C_VB_POSITION);
+        glVertexAttribPointer(C_VB_POSITION, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        glVertexPointer(3, GL_FLOAT, stride, (void*)0);
+
+        if (m_useNormalData)
+        {
+            glEnableVertexAttribArray(C_VB_NORMAL);
+            glVertexAttribPointer(C_VB_NORMAL, vectorSize, vectorType, vectorNormalized, stride, (void*)(size_t)(m_interleavedNormalOffset));
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_NORMAL);
+        }
+
+        if (m_useTexCoordData)
+        {
+            glEnableVertexAttribArray(C_VB_TEXCOORD);
+            glVertexAttribPointer(C_VB_TEXCOORD, 3, GL_FLOAT, GL_FALSE, stride, (void*)(size_t)(m_interleavedTexCoordOffset));
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_TEXCOORD);
+        }
+
+        if (m_useColorData)
+        {
+            glEnableVertexAttribArray(C_VB_COLOR);
+            glVertexAttribPointer(C_VB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)(size_t)(m_interleavedColorOffset));
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_COLOR);
+        }
+
+        if (m_useTangentData)
+        {
+            glEnableVertexAttribArray(C_VB_TANGENT);
+            glVertexAttribPointer(C_VB_TANGENT, vectorSize, vectorType, vectorNormalized, stride, (void*)(size_t)(m_interleavedTangentOffset));
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_TANGENT);
+        }
+
+        if (m_useBitangentData)
+        {
+            glEnableVertexAttribArray(C_VB_BITANGENT);
+            glVertexAttribPointer(C_VB_BITANGENT, vectorSize, vectorType, vectorNormalized, stride, (void*)(size_t)(m_interleavedBitangentOffset));
+        }
+        else
+        {
+            glDisableVertexAttribArray(C_VB_BITANGENT);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+#endif
+    }
+
+
     //--------------------------------------------------------------------------
     // PUBLIC MEMBERS:
     //--------------------------------------------------------------------------
@@ -1320,6 +1689,43 @@ public:
 
     //! OpenGL Buffer for storing triangle indices.
     GLuint m_bitangentBuffer;
+
+    //! OpenGL Buffer for storing all properties of the vertices interleaved.
+    GLuint m_interleavedBuffer;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS: (INTERLEAVED BUFFER)
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! If __true__ then the vertices are rendered from the interleaved buffer.
+    bool m_useInterleavedBuffer;
+
+    //! If __true__ then normals, tangents and bitangents are packed in the interleaved buffer.
+    bool m_interleavedPacked;
+
+    //! Size in bytes of each vertex in the interleaved buffer.
+    unsigned int m_interleavedStride;
+
+    //! Offset in bytes of the normal in each vertex of the interleaved buffer.
+    unsigned int m_interleavedNormalOffset;
+
+    //! Offset in bytes of the texture coordinate in each vertex of the interleaved buffer.
+    unsigned int m_interleavedTexCoordOffset;
+
+    //! Offset in bytes of the color in each vertex of the interleaved buffer.
+    unsigned int m_interleavedColorOffset;
+
+    //! Offset in bytes of the tangent in each vertex of the interleaved buffer.
+    unsigned int m_interleavedTangentOffset;
+
+    //! Offset in bytes of the bitangent in each vertex of the interleaved buffer.
+    unsigned int m_interleavedBitangentOffset;
+
+    //! Copy of the interleaved buffer, updated where vertex data has been modified.
+    std::vector<unsigned char> m_interleavedData;
 };
 
 //------------------------------------------------------------------------------
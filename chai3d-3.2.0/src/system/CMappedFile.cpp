@@ -0,0 +1,202 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Brandon Sieu, Glenn Skelton
+    \version   3.2.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "system/CMappedFile.h"
+//------------------------------------------------------------------------------
+#if defined(LINUX) || defined(MACOSX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cMappedFile.
+*/
+//==============================================================================
+cMappedFile::cMappedFile()
+{
+    m_open = false;
+    m_data = NULL;
+    m_size = 0;
+
+#if defined(WIN32) | defined(WIN64)
+    m_mapping = NULL;
+#endif
+}
+
+
+//==============================================================================
+/*!
+    Destructor of cMappedFile.
+*/
+//==============================================================================
+cMappedFile::~cMappedFile()
+{
+    close();
+}
+
+
+//==============================================================================
+/*!
+    This method maps a file into memory for reading. Any file mapped
+    previously is released first.
+
+    \param  a_filename  Filename.
+
+    \return __true__ in case of success, __false__ otherwise.
+*/
+//==============================================================================
+bool cMappedFile::open(const std::string& a_filename)
+{
+    close();
+
+#if defined(WIN32) | defined(WIN64)
+    HANDLE file = CreateFileA(a_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) { return (false); }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return (false);
+    }
+    m_size = (size_t)(size.QuadPart);
+
+    // an empty file cannot be mapped
+    if (m_size > 0)
+    {
+        m_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (m_mapping != NULL)
+        {
+            m_data = (const unsigned char*)(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+            if (m_data == NULL)
+            {
+                CloseHandle(m_mapping);
+                m_mapping = NULL;
+            }
+        }
+    }
+
+    // the view keeps the file open
+    CloseHandle(file);
+#endif
+
+#if defined(LINUX) || defined(MACOSX)
+    int file = ::open(a_filename.c_str(), O_RDONLY);
+    if (file < 0) { return (false); }
+
+    struct stat status;
+    if (fstat(file, &status) != 0)
+    {
+        ::close(file);
+        return (false);
+    }
+    m_size = (size_t)(status.st_size);
+
+    // an empty file cannot be mapped
+    if (m_size > 0)
+    {
+        void* data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data != MAP_FAILED)
+        {
+            m_data = (const unsigned char*)(data);
+        }
+    }
+
+    // the mapping keeps the file open
+    ::close(file);
+#endif
+
+    if ((m_size > 0) && (m_data == NULL))
+    {
+        m_size = 0;
+        return (false);
+    }
+
+    m_open = true;
+    return (true);
+}
+
+
+//==============================================================================
+/*!
+    This method releases the mapping of the file, if any.
+*/
+//==============================================================================
+void cMappedFile::close()
+{
+#if defined(WIN32) | defined(WIN64)
+    if (m_data != NULL)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != NULL)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = NULL;
+    }
+#endif
+
+#if defined(LINUX) || defined(MACOSX)
+    if (m_data != NULL)
+    {
+        munmap((void*)(m_data), m_size);
+    }
+#endif
+
+    m_open = false;
+    m_data = NULL;
+    m_size = 0;
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,158 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Brandon Sieu, Glenn Skelton
+    \version   3.2.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CMappedFileH
+#define CMappedFileH
+//------------------------------------------------------------------------------
+#include "system/CGlobals.h"
+#include <string>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CMappedFile.h
+    \ingroup    system
+
+    \brief
+    Implements read-only memory mapped files.
+*/
+//==============================================================================
+
+//==============================================================================
+/*!
+    \class      cMappedFile
+    \ingroup    system
+
+    \brief
+    This class maps a file into memory for reading.
+
+    \details
+    The content of the file is made available as one contiguous block of
+    memory which the operating system pages in from disk on demand, without
+    copying it through a read buffer. The mapping is released when the object
+    is closed or destroyed. An empty file opens successfully with no data.
+*/
+//==============================================================================
+class cMappedFile
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cMappedFile.
+    cMappedFile();
+
+    //! Destructor of cMappedFile.
+    virtual ~cMappedFile();
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method maps a file into memory.
+    bool open(const std::string& a_filename);
+
+    //! This method releases the mapping.
+    void close();
+
+    //! This method returns __true__ if a file is mapped.
+    bool isOpen() const { return (m_open); }
+
+    //! This method returns the content of the file.
+    const unsigned char* getData() const { return (m_data); }
+
+    //! This method returns the size of the file in bytes.
+    size_t getSize() const { return (m_size); }
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! __true__ if a file is mapped.
+    bool m_open;
+
+    //! Content of the file.
+    const unsigned char* m_data;
+
+    //! Size of the file in bytes.
+    size_t m_size;
+
+#if defined(WIN32) | defined(WIN64)
+    //! File mapping handle.
+    HANDLE m_mapping;
+#endif
+
+
+    //--------------------------------------------------------------------------
+    // PRIVATE METHODS:
+    //--------------------------------------------------------------------------
+
+private:
+
+    //! Mapped files cannot be copied.
+    cMappedFile(const cMappedFile&);
+
+    //! Mapped files cannot be copied.
+    cMappedFile& operator=(const cMappedFile&);
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -0,0 +1,279 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Brandon Sieu, Glenn Skelton
+    \version   3.2.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#include "timers/CLatencyHistogram.h"
+//------------------------------------------------------------------------------
+#include <climits>
+#include <cmath>
+#include <cstdio>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    Constructor of cLatencyHistogram.
+*/
+//==============================================================================
+cLatencyHistogram::cLatencyHistogram()
+{
+    reset();
+}
+
+
+//==============================================================================
+/*!
+    This method removes all samples from the histogram. It must not be called
+    while another thread is recording samples.
+*/
+//==============================================================================
+void cLatencyHistogram::reset()
+{
+    for (unsigned int i=0; i<C_LATENCY_BUCKETS; i++)
+    {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sumNs.store(0, std::memory_order_relaxed);
+    m_minNs.store(ULLONG_MAX, std::memory_order_relaxed);
+    m_maxNs.store(0, std::memory_order_relaxed);
+}
+
+
+//==============================================================================
+/*!
+    This method adds a latency to the histogram. Only one thread may record
+    samples into a histogram.
+
+    \param  a_latencySeconds  Latency in seconds. Negative values count as zero.
+*/
+//==============================================================================
+void cLatencyHistogram::record(const double a_latencySeconds)
+{
+    recordNs((a_latencySeconds > 0.0) ? (unsigned long long)(a_latencySeconds * 1e9) : 0);
+}
+
+
+//==============================================================================
+/*!
+    This method adds a latency to the histogram. Only one thread may record
+    samples into a histogram.
+
+    \param  a_latencyNs  Latency in nanoseconds.
+*/
+//==============================================================================
+void cLatencyHistogram::recordNs(const unsigned long long a_latencyNs)
+{
+    unsigned long long ns = a_latencyNs;
+
+    // a single writer, so plain read-modify-write sequences are safe
+    m_buckets[getBucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    m_sumNs.store(m_sumNs.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    if (ns < m_minNs.load(std::memory_order_relaxed)) m_minNs.store(ns, std::memory_order_relaxed);
+    if (ns > m_maxNs.load(std::memory_order_relaxed)) m_maxNs.store(ns, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_release);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the smallest latency recorded.
+
+    \return Latency in seconds, 0 if the histogram is empty.
+*/
+//==============================================================================
+double cLatencyHistogram::getMinSeconds() const
+{
+    if (getCount() == 0) return (0.0);
+    return (m_minNs.load(std::memory_order_relaxed) * 1e-9);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the largest latency recorded.
+
+    \return Latency in seconds, 0 if the histogram is empty.
+*/
+//==============================================================================
+double cLatencyHistogram::getMaxSeconds() const
+{
+    return (m_maxNs.load(std::memory_order_relaxed) * 1e-9);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the mean of the latencies recorded.
+
+    \return Latency in seconds, 0 if the histogram is empty.
+*/
+//==============================================================================
+double cLatencyHistogram::getMeanSeconds() const
+{
+    unsigned long long count = getCount();
+    if (count == 0) return (0.0);
+    return ((double)m_sumNs.load(std::memory_order_relaxed) / (double)count * 1e-9);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the latency below which a given percentage of the
+    samples fall. The value is the middle of the bucket the percentile falls
+    in, clamped to the smallest and largest latencies recorded.
+
+    \param  a_percentile  Percentile between 0 and 100.
+
+    \return Latency in seconds, 0 if the histogram is empty.
+*/
+//==============================================================================
+double cLatencyHistogram::getPercentileSeconds(const double a_percentile) const
+{
+    unsigned long long count = m_count.load(std::memory_order_acquire);
+    if (count == 0) return (0.0);
+
+    double percentile = (a_percentile < 0.0) ? 0.0 : ((a_percentile > 100.0) ? 100.0 : a_percentile);
+    unsigned long long rank = (unsigned long long)ceil(percentile / 100.0 * (double)count);
+    if (rank < 1) rank = 1;
+
+    // walk the buckets until the rank is reached
+    double valueNs = (double)m_maxNs.load(std::memory_order_relaxed);
+    unsigned long long seen = 0;
+    for (unsigned int i=0; i<C_LATENCY_BUCKETS; i++)
+    {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            valueNs = getBucketValue(i);
+            break;
+        }
+    }
+
+    double minNs = (double)m_minNs.load(std::memory_order_relaxed);
+    double maxNs = (double)m_maxNs.load(std::memory_order_relaxed);
+    if (valueNs < minNs) valueNs = minNs;
+    if (valueNs > maxNs) valueNs = maxNs;
+
+    return (valueNs * 1e-9);
+}
+
+
+//==============================================================================
+/*!
+    This method prints the number of samples, the mean and the main
+    percentiles of the latencies in microseconds on a single line.
+
+    \param  a_stream  Stream to print to.
+*/
+//==============================================================================
+void cLatencyHistogram::print(std::ostream& a_stream) const
+{
+    char line[256];
+    snprintf(line, sizeof(line),
+             "%llu samples, mean %.1f us, min %.1f us, p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us",
+             getCount(),
+             getMeanSeconds() * 1e6,
+             getMinSeconds() * 1e6,
+             getPercentileSeconds(50.0) * 1e6,
+             getPercentileSeconds(90.0) * 1e6,
+             getPercentileSeconds(99.0) * 1e6,
+             getPercentileSeconds(99.9) * 1e6,
+             getMaxSeconds() * 1e6);
+    a_stream << line;
+}
+
+
+//==============================================================================
+/*!
+    This method returns the bucket of a latency. Latencies below
+    C_LATENCY_SUB_BUCKETS have a bucket each, above that the leading bits of
+    the latency select one of the C_LATENCY_SUB_BUCKETS buckets of its power
+    of two.
+
+    \param  a_latencyNs  Latency in nanoseconds.
+
+    \return Index of the bucket.
+*/
+//==============================================================================
+unsigned int cLatencyHistogram::getBucket(unsigned long long a_latencyNs)
+{
+    if (a_latencyNs < C_LATENCY_SUB_BUCKETS) return ((unsigned int)a_latencyNs);
+
+    // position of the highest bit set
+    unsigned int msb = 0;
+    while ((a_latencyNs >> (msb + 1)) != 0) msb++;
+
+    // keep the highest bit and the 5 below it
+    unsigned int shift = msb - 5;
+    unsigned int bucket = C_LATENCY_SUB_BUCKETS * (shift + 1) + (unsigned int)((a_latencyNs >> shift) - C_LATENCY_SUB_BUCKETS);
+
+    return ((bucket < C_LATENCY_BUCKETS) ? bucket : C_LATENCY_BUCKETS - 1);
+}
+
+
+//==============================================================================
+/*!
+    This method returns the latency in the middle of a bucket.
+
+    \param  a_bucket  Index of the bucket.
+
+    \return Latency in nanoseconds.
+*/
+//==============================================================================
+double cLatencyHistogram::getBucketValue(unsigned int a_bucket)
+{
+    if (a_bucket < C_LATENCY_SUB_BUCKETS) return ((double)a_bucket);
+
+    unsigned int shift = a_bucket / C_LATENCY_SUB_BUCKETS - 1;
+    double mantissa = C_LATENCY_SUB_BUCKETS + (a_bucket % C_LATENCY_SUB_BUCKETS) + 0.5;
+
+    return (ldexp(mantissa, shift));
+}
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
@@ -0,0 +1,189 @@
+//==============================================================================
+/*
+    Software License Agreement (BSD License)
+    Copyright (c) 2003-2016, CHAI3D.
+    (www.chai3d.org)
+
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without
+    modification, are permitted provided that the following conditions
+    are met:
+
+    * Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+    copyright notice, this list of conditions and the following
+    disclaimer in the documentation and/or other materials provided
+    with the distribution.
+
+    * Neither the name of CHAI3D nor the names of its contributors may
+    be used to endorse or promote products derived from this software
+    without specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+    COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+    CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+    LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+    ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+    POSSIBILITY OF SUCH DAMAGE. 
+
+    \author    <http://www.chai3d.org>
+    \author    Brandon Sieu, Glenn Skelton
+    \version   3.2.0
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+#ifndef CLatencyHistogramH
+#define CLatencyHistogramH
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <ostream>
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+namespace chai3d {
+//------------------------------------------------------------------------------
+
+//==============================================================================
+/*!
+    \file       CLatencyHistogram.h
+    \ingroup    timers
+
+    \brief
+    Implements a histogram of latencies.
+*/
+//==============================================================================
+
+//------------------------------------------------------------------------------
+// GENERAL CONSTANTS
+//------------------------------------------------------------------------------
+//! Number of buckets of each power of two of a latency histogram.
+const unsigned int C_LATENCY_SUB_BUCKETS = 32;
+
+//! Number of buckets of a latency histogram, enough for latencies up to about a minute.
+const unsigned int C_LATENCY_BUCKETS = 1024;
+
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    \class      cLatencyHistogram
+    \ingroup    timers
+
+    \brief
+    This class implements a histogram of latencies.
+
+    \details
+    __cLatencyHistogram__ counts latencies in buckets of constant relative
+    width, in the manner of an HDR histogram. Latencies below
+    C_LATENCY_SUB_BUCKETS nanoseconds get a bucket each, above that every
+    power of two is split into C_LATENCY_SUB_BUCKETS buckets, so any
+    percentile is known to within about 3 percent whatever the range of the
+    latencies, with a fixed amount of memory and a constant cost per sample.\n
+
+    Samples are added by a single thread with record(). The counters are
+    atomic, so the histogram can be read from any other thread while samples
+    are being added.
+*/
+//==============================================================================
+class cLatencyHistogram
+{
+    //--------------------------------------------------------------------------
+    // CONSTRUCTOR & DESTRUCTOR:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! Constructor of cLatencyHistogram.
+    cLatencyHistogram();
+
+    //! Destructor of cLatencyHistogram.
+    virtual ~cLatencyHistogram() {}
+
+
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method removes all samples. It must not be called while samples are being recorded.
+    void reset();
+
+    //! This method adds a latency in seconds to the histogram.
+    void record(const double a_latencySeconds);
+
+    //! This method adds a latency in nanoseconds to the histogram.
+    void recordNs(const unsigned long long a_latencyNs);
+
+    //! This method returns the number of samples.
+    unsigned long long getCount() const { return (m_count.load(std::memory_order_relaxed)); }
+
+    //! This method returns the smallest latency in seconds.
+    double getMinSeconds() const;
+
+    //! This method returns the largest latency in seconds.
+    double getMaxSeconds() const;
+
+    //! This method returns the mean latency in seconds.
+    double getMeanSeconds() const;
+
+    //! This method returns the latency in seconds below which __a_percentile__ percent of the samples fall.
+    double getPercentileSeconds(const double a_percentile) const;
+
+    //! This method prints the count, mean and main percentiles of the latencies on a single line.
+    void print(std::ostream& a_stream) const;
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED METHODS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! This method returns the bucket of a latency in nanoseconds.
+    static unsigned int getBucket(unsigned long long a_latencyNs);
+
+    //! This method returns the latency in nanoseconds in the middle of a bucket.
+    static double getBucketValue(unsigned int a_bucket);
+
+
+    //--------------------------------------------------------------------------
+    // PROTECTED MEMBERS:
+    //--------------------------------------------------------------------------
+
+protected:
+
+    //! Number of samples in each bucket.
+    std::atomic<unsigned long long> m_buckets[C_LATENCY_BUCKETS];
+
+    //! Number of samples.
+    std::atomic<unsigned long long> m_count;
+
+    //! Sum of the latencies in nanoseconds.
+    std::atomic<unsigned long long> m_sumNs;
+
+    //! Smallest latency in nanoseconds.
+    std::atomic<unsigned long long> m_minNs;
+
+    //! Largest latency in nanoseconds.
+    std::atomic<unsigned long long> m_maxNs;
+};
+
+//------------------------------------------------------------------------------
+} // namespace chai3d
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+#endif
+//------------------------------------------------------------------------------
@@ -723,30 +723,28 @@ void cGenericTool::updateFromDevice()
     // retrieve data from haptic device
     //////////////////////////////////////////////////////////////////////
 
-    // temp variables
-    cVector3d devicePos, deviceLinVel, deviceAngVel;
-    cMatrix3d deviceRot;
-    double gripperAngle;
-    double gripperAngVel;
-    unsigned int userSwitches;
+    // temp variable
+    cHapticDeviceState state;
 
     // init temp variable
-    devicePos.zero();
-    deviceLinVel.zero();
-    deviceAngVel.zero();
-    deviceRot.identity();
-    gripperAngle = 0.0;
-    gripperAngVel = 0.0;
-    userSwitches = 0;
+    state.m_position.zero();
+    state.m_rotation.identity();
+    state.m_linearVelocity.zero();
+    state.m_angularVelocity.zero();
+    state.m_gripperAngle = 0.0;
+    state.m_gripperAngularVelocity = 0.0;
+    state.m_userSwitches = 0;
 
     // update position, orientation, linear and angular velocities from device
-    m_hapticDevice->getPosition(devicePos);
-    m_hapticDevice->getRotation(deviceRot);
-    m_hapticDevice->getGripperAngleRad(gripperAngle);
-    m_hapticDevice->getGripperAngularVelocity(gripperAngVel);
-    m_hapticDevice->getLinearVelocity(deviceLinVel);
-    m_hapticDevice->getAngularVelocity(deviceAngVel);
-    m_hapticDevice->getUserSwitches(userSwitches);
+    m_hapticDevice->getState(state);
+
+    const cVector3d& devicePos = state.m_position;
+    const cMatrix3d& deviceRot = state.m_rotation;
+    const cVector3d& deviceLinVel = state.m_linearVelocity;
+    const cVector3d& deviceAngVel = state.m_angularVelocity;
+    double gripperAngle = state.m_gripperAngle;
+    double gripperAngVel = state.m_gripperAngularVelocity;
+    unsigned int userSwitches = state.m_userSwitches;
 
 
     //////////////////////////////////////////////////////////////////////
@@ -58,6 +58,8 @@
 #include <list>
 #include <utility>
 #include <set>
+#include <functional>
+#include <thread>
 //------------------------------------------------------------------------------
 using namespace std;
 //------------------------------------------------------------------------------
@@ -66,6 +68,128 @@ using namespace std;
 namespace chai3d {
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+//! Smallest number of triangles per thread when computing normals on several threads.
+const unsigned int C_MESH_MIN_TRIANGLES_PER_THREAD = 65536;
+
+//------------------------------------------------------------------------------
+
+// splits a_count elements into a_numRanges ranges and runs a_function on each
+// range, the first one on the calling thread
+static void runMeshRanges(const unsigned int a_count,
+                          const unsigned int a_numRanges,
+                          const function<void(unsigned int, unsigned int)>& a_function)
+{
+    vector<thread> threads;
+    for (unsigned int i=1; i<a_numRanges; i++)
+    {
+        unsigned int begin = (unsigned int)(((unsigned long long)(a_count) * i) / a_numRanges);
+        unsigned int end = (unsigned int)(((unsigned long long)(a_count) * (i+1)) / a_numRanges);
+        try
+        {
+            threads.push_back(thread(a_function, begin, end));
+        }
+        catch (...)
+        {
+            // no more threads available
+            a_function(begin, end);
+        }
+    }
+
+    a_function(0, (unsigned int)(a_count / a_numRanges));
+
+    for (unsigned int i=0; i<threads.size(); i++)
+    {
+        threads[i].join();
+    }
+}
+
+//------------------------------------------------------------------------------
+
+// computes the vertex normals of a mesh on several threads. Face normals are
+// computed over ranges of triangles, then each vertex sums the normals of its
+// triangles in order over ranges of vertices, which gives the same normals as
+// summing them triangle after triangle on one thread
+static void computeNormalsInParallel(cVertexArrayPtr a_vertices,
+                                     cTriangleArrayPtr a_triangles,
+                                     const unsigned int a_numRanges)
+{
+    unsigned int numTriangles = a_triangles->getNumElements();
+    unsigned int numVertices = a_vertices->getNumElements();
+    const vector<unsigned int>& indices = a_triangles->m_indices;
+
+    // normal of each triangle, zero if it has no area
+    vector<cVector3d> faceNormals(numTriangles);
+    runMeshRanges(numTriangles, a_numRanges, [&](unsigned int a_begin, unsigned int a_end)
+    {
+        for (unsigned int i=a_begin; i<a_end; i++)
+        {
+            cVector3d vertex0 = a_vertices->getLocalPos(indices[3*i+0]);
+            cVector3d vertex1 = a_vertices->getLocalPos(indices[3*i+1]);
+            cVector3d vertex2 = a_vertices->getLocalPos(indices[3*i+2]);
+
+            cVector3d normal, v01, v02;
+            vertex1.subr(vertex0, v01);
+            vertex2.subr(vertex0, v02);
+            v01.crossr(v02, normal);
+            double length = normal.length();
+            if (length > 0.0)
+            {
+                normal.div(length);
+                faceNormals[i] = normal;
+            }
+            else
+            {
+                faceNormals[i].zero();
+            }
+        }
+    });
+
+    // triangles with an area using each vertex, in order
+    vector<unsigned int> offsets(numVertices + 1, 0);
+    for (unsigned int i=0; i<3*numTriangles; i++)
+    {
+        if (faceNormals[i/3].lengthsq() > 0.0) { offsets[indices[i]+1]++; }
+    }
+    for (unsigned int i=0; i<numVertices; i++)
+    {
+        offsets[i+1] += offsets[i];
+    }
+    vector<unsigned int> adjacency(offsets[numVertices]);
+    vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+    for (unsigned int i=0; i<3*numTriangles; i++)
+    {
+        if (faceNormals[i/3].lengthsq() > 0.0) { adjacency[fill[indices[i]]++] = i/3; }
+    }
+
+    // average the normals of the triangles of each vertex
+    runMeshRanges(numVertices, a_numRanges, [&](unsigned int a_begin, unsigned int a_end)
+    {
+        for (unsigned int i=a_begin; i<a_end; i++)
+        {
+            cVector3d normal(0.0, 0.0, 0.0);
+            for (unsigned int j=offsets[i]; j<offsets[i+1]; j++)
+            {
+                normal.add(faceNormals[adjacency[j]]);
+            }
+            if (normal.length() > 0.000000001)
+            {
+                normal.normalize();
+            }
+            a_vertices->m_normal[i] = normal;
+        }
+    });
+
+    a_vertices->m_flagNormalData = true;
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
 //==============================================================================
 /*!
     Constructor of cMesh.
@@ -488,6 +612,7 @@ void cMesh::clear()
 /*!
     This method computes all surface normals for every vertex in the mesh, by 
     averaging the face normals of the triangle that include each vertex.
+    Meshes of many triangles are split across one thread per processor.
 */
 //==============================================================================
 void cMesh::computeAllNormals()
@@ -496,6 +621,14 @@ void cMesh::computeAllNormals()
     unsigned int numTriangles = m_triangles->getNumElements();
     unsigned int numVertices = m_vertices->getNumElements();
 
+    // large meshes are split across threads
+    unsigned int numRanges = cMin(cMax(thread::hardware_concurrency(), 1u), numTriangles / C_MESH_MIN_TRIANGLES_PER_THREAD);
+    if (numRanges > 1)
+    {
+        computeNormalsInParallel(m_vertices, m_triangles, numRanges);
+        return;
+    }
+
     // initialize all normals to zero
     for (unsigned int i=0; i<numVertices; i++)
     {
@@ -988,6 +1121,262 @@ void cMesh::setEdgeProperties(const double a_lineWidth,
 }
 
 
+//------------------------------------------------------------------------------
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+// vertex indices of the allocated triangles of a mesh, and which triangles they are
+static void getAllocatedTriangles(cTriangleArrayPtr a_triangles,
+                                  vector<unsigned int>& a_indices,
+                                  vector<unsigned int>& a_allocated)
+{
+    unsigned int numTriangles = a_triangles->getNumElements();
+    a_indices.clear();
+    a_allocated.clear();
+    a_indices.reserve(3 * numTriangles);
+    a_allocated.reserve(numTriangles);
+
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        if (a_triangles->getAllocated(i))
+        {
+            a_indices.push_back(a_triangles->getVertexIndex0(i));
+            a_indices.push_back(a_triangles->getVertexIndex1(i));
+            a_indices.push_back(a_triangles->getVertexIndex2(i));
+            a_allocated.push_back(i);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+//------------------------------------------------------------------------------
+
+
+//==============================================================================
+/*!
+    This method merges vertices whose position, normal, texture coordinate,
+    color, tangent and bitangent, as far as the mesh holds them, differ by no
+    more than a tolerance. Each group of merged vertices keeps the data of
+    its first vertex. Without a tolerance, only vertices holding exactly the
+    same data are merged, which leaves the rendered mesh unchanged.
+
+    __IMPORTANT:__ \n
+    Vertex indices change. Any collision detector must be rebuilt afterwards.
+
+    \param  a_tolerance  Largest difference of any value of two merged vertices.
+
+    \return Number of vertices left.
+*/
+//==============================================================================
+unsigned int cMesh::weldVertices(const double a_tolerance)
+{
+    vector<unsigned int> remap;
+    unsigned int numVertices = cComputeVertexWeld(m_vertices, remap, a_tolerance);
+
+    if (numVertices < getNumVertices())
+    {
+        remapVertices(remap, numVertices);
+    }
+
+    return (numVertices);
+}
+
+
+//==============================================================================
+/*!
+    This method reorders the triangles of this mesh so that they reuse the
+    vertices left in the post-transform vertex cache of the graphics card,
+    which lowers the number of vertices it transforms per triangle. Triangles
+    that were removed are dropped from the array.
+
+    __IMPORTANT:__ \n
+    Triangle indices change. Any collision detector must be rebuilt afterwards.
+
+    \param  a_cacheSize  Number of vertices of the cache.
+*/
+//==============================================================================
+void cMesh::optimizeTriangleOrder(const unsigned int a_cacheSize)
+{
+    vector<unsigned int> indices;
+    vector<unsigned int> allocated;
+    getAllocatedTriangles(m_triangles, indices, allocated);
+
+    vector<unsigned int> order;
+    cComputeTriangleOrder(indices, getNumVertices(), order, a_cacheSize);
+
+    // new index of each old triangle, for the edges referring to them
+    vector<unsigned int> triangleRemap(m_triangles->getNumElements(), 0);
+
+    unsigned int numTriangles = (unsigned int)(order.size());
+    for (unsigned int i=0; i<numTriangles; i++)
+    {
+        unsigned int triangle = order[i];
+        m_triangles->m_indices[3*i+0] = indices[3*triangle+0];
+        m_triangles->m_indices[3*i+1] = indices[3*triangle+1];
+        m_triangles->m_indices[3*i+2] = indices[3*triangle+2];
+        triangleRemap[allocated[triangle]] = i;
+    }
+    m_triangles->m_indices.resize(3 * numTriangles);
+    m_triangles->m_allocated.assign(numTriangles, true);
+    m_triangles->m_flagMarkForResize = true;
+
+    for (unsigned int i=0; i<m_edges.size(); i++)
+    {
+        m_edges[i].m_triangle = triangleRemap[m_edges[i].m_triangle];
+    }
+
+    markForUpdate(false);
+}
+
+
+//==============================================================================
+/*!
+    This method reorders the vertices of this mesh in the order its triangles
+    first use them, so that the graphics card fetches them mostly in
+    sequence. Call it after \ref optimizeTriangleOrder().
+
+    __IMPORTANT:__ \n
+    Vertex indices change. Any collision detector must be rebuilt afterwards.
+*/
+//==============================================================================
+void cMesh::optimizeVertexOrder()
+{
+    vector<unsigned int> indices;
+    vector<unsigned int> allocated;
+    getAllocatedTriangles(m_triangles, indices, allocated);
+
+    vector<unsigned int> remap;
+    cComputeVertexFetchOrder(indices, getNumVertices(), remap);
+
+    remapVertices(remap, getNumVertices());
+}
+
+
+//==============================================================================
+/*!
+    This method computes the average cache miss ratio (ACMR) of this mesh,
+    the number of vertices transformed per triangle drawn through a
+    first-in first-out post-transform cache.
+
+    \param  a_cacheSize  Number of vertices of the cache.
+
+    \return Average number of cache misses per triangle.
+*/
+//==============================================================================
+double cMesh::computeACMR(const unsigned int a_cacheSize)
+{
+    vector<unsigned int> indices;
+    vector<unsigned int> allocated;
+    getAllocatedTriangles(m_triangles, indices, allocated);
+
+    return (cComputeACMR(indices, getNumVertices(), a_cacheSize));
+}
+
+
+//==============================================================================
+/*!
+    This method optimizes this mesh for rendering. Vertices are welded, then
+    triangles are reordered for the post-transform vertex cache and vertices
+    in the order triangles use them.
+
+    __IMPORTANT:__ \n
+    Vertex and triangle indices change. Any collision detector must be
+    rebuilt afterwards.
+
+    \param  a_weldTolerance  Largest difference of any value of two welded vertices.
+    \param  a_cacheSize      Number of vertices of the cache.
+
+    \return Number of vertices and cache miss ratio before and after.
+*/
+//==============================================================================
+cMeshOptimizationReport cMesh::optimize(const double a_weldTolerance,
+                                        const unsigned int a_cacheSize)
+{
+    cMeshOptimizationReport report;
+    report.m_numVerticesBefore = getNumVertices();
+    report.m_acmrBefore = computeACMR(a_cacheSize);
+
+    weldVertices(a_weldTolerance);
+    optimizeTriangleOrder(a_cacheSize);
+    optimizeVertexOrder();
+
+    report.m_numVerticesAfter = getNumVertices();
+    report.m_numTriangles = getNumTriangles();
+    report.m_acmrAfter = computeACMR(a_cacheSize);
+
+    return (report);
+}
+
+
+//==============================================================================
+/*!
+    This method moves the data of every vertex to the index given by a remap.
+    When several vertices move to the same index, the first one is kept.
+    Triangles and edges are updated to use the new indices.
+
+    \param  a_remap        New index of every vertex.
+    \param  a_numVertices  Number of vertices after the remap.
+*/
+//==============================================================================
+void cMesh::remapVertices(const vector<unsigned int>& a_remap,
+                          const unsigned int a_numVertices)
+{
+    // keep the old data, then allocate the new array
+    cVertexArrayPtr vertices = m_vertices->copy();
+    m_vertices->clear();
+    if (a_numVertices > 0)
+    {
+        m_vertices->allocateData(a_numVertices,
+                                 vertices->getUseNormalData(),
+                                 vertices->getUseTexCoordData(),
+                                 vertices->getUseColorData(),
+                                 vertices->getUseTangentData(),
+                                 vertices->getUseBitangentData(),
+                                 vertices->getUseUserData());
+    }
+
+    vector<bool> copied(a_numVertices, false);
+    unsigned int numVertices = vertices->getNumElements();
+    for (unsigned int i=0; i<numVertices; i++)
+    {
+        unsigned int j = a_remap[i];
+        if (copied[j]) { continue; }
+        copied[j] = true;
+
+        m_vertices->m_localPos[j] = vertices->m_localPos[i];
+        m_vertices->m_globalPos[j] = vertices->m_globalPos[i];
+        if (vertices->getUseNormalData())       { m_vertices->m_normal[j] = vertices->m_normal[i]; }
+        if (vertices->getUseTexCoordData())     { m_vertices->m_texCoord[j] = vertices->m_texCoord[i]; }
+        if (vertices->getUseColorData())        { m_vertices->m_color[j] = vertices->m_color[i]; }
+        if (vertices->getUseTangentData())      { m_vertices->m_tangent[j] = vertices->m_tangent[i]; }
+        if (vertices->getUseBitangentData())    { m_vertices->m_bitangent[j] = vertices->m_bitangent[i]; }
+        if (vertices->getUseUserData())         { m_vertices->m_userData[j] = vertices->m_userData[i]; }
+    }
+
+    m_vertices->m_flagPositionData = true;
+    m_vertices->m_flagNormalData = vertices->getUseNormalData();
+    m_vertices->m_flagTexCoordData = vertices->getUseTexCoordData();
+    m_vertices->m_flagColorData = vertices->getUseColorData();
+    m_vertices->m_flagTangentData = vertices->getUseTangentData();
+    m_vertices->m_flagBitangentData = vertices->getUseBitangentData();
+    m_vertices->m_flagUserData = vertices->getUseUserData();
+
+    // triangles and edges use the new indices
+    for (unsigned int i=0; i<m_triangles->m_indices.size(); i++)
+    {
+        m_triangles->m_indices[i] = a_remap[m_triangles->m_indices[i]];
+    }
+    for (unsigned int i=0; i<m_edges.size(); i++)
+    {
+        m_edges[i].m_vertex0 = a_remap[m_edges[i].m_vertex0];
+        m_edges[i].m_vertex1 = a_remap[m_edges[i].m_vertex1];
+    }
+
+    markForUpdate(false);
+}
+
+
 //==============================================================================
 /*!
      This method builds a brute Force collision detector for this mesh.
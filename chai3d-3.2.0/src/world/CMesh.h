@@ -55,6 +55,7 @@
 #include "materials/CMaterial.h"
 #include "materials/CTexture2d.h"
 #include "graphics/CColor.h"
+#include "graphics/CMeshOptimizer.h"
 //------------------------------------------------------------------------------
 #include <vector>
 #include <list>
@@ -317,6 +318,29 @@ public:
     virtual cVector3d getCenterOfMass();
 
 
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - OPTIMIZATION:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method merges vertices whose data differ by no more than a tolerance.
+    unsigned int weldVertices(const double a_tolerance = 0.0);
+
+    //! This method reorders triangles to reuse the vertices left in the post-transform vertex cache.
+    void optimizeTriangleOrder(const unsigned int a_cacheSize = C_VERTEX_CACHE_SIZE);
+
+    //! This method reorders vertices in the order triangles first use them.
+    void optimizeVertexOrder();
+
+    //! This method computes the average cache miss ratio of the triangles of this mesh.
+    double computeACMR(const unsigned int a_cacheSize = C_VERTEX_CACHE_SIZE);
+
+    //! This method welds vertices, then reorders triangles and vertices for the vertex cache.
+    cMeshOptimizationReport optimize(const double a_weldTolerance = 0.0,
+        const unsigned int a_cacheSize = C_VERTEX_CACHE_SIZE);
+
+
     //--------------------------------------------------------------------------
     // PROTECTED METHODS - INTERNAL
     //--------------------------------------------------------------------------
@@ -338,6 +362,9 @@ protected:
     //! This method renders all triangles, material and texture properties.
     virtual void renderMesh(cRenderOptions& a_options);
 
+    //! This method moves every vertex to the index given by a remap.
+    void remapVertices(const std::vector<unsigned int>& a_remap, const unsigned int a_numVertices);
+
     //! This method updates the global position of each vertex.
     virtual void updateGlobalPositions(const bool a_frameOnly);
 
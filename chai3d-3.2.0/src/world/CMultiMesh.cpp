@@ -1801,6 +1801,65 @@ void cMultiMesh::clearAllEdges()
 }
 
 
+//==============================================================================
+/*!
+    This method computes the average cache miss ratio (ACMR) of all meshes,
+    the number of vertices transformed per triangle drawn through a
+    first-in first-out post-transform cache.
+
+    \param  a_cacheSize  Number of vertices of the cache.
+
+    \return Average number of cache misses per triangle.
+*/
+//==============================================================================
+double cMultiMesh::computeACMR(const unsigned int a_cacheSize)
+{
+    double misses = 0.0;
+    unsigned int numTriangles = 0;
+
+    vector<cMesh*>::iterator it;
+    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+    {
+        unsigned int meshTriangles = (*it)->getNumTriangles();
+        misses = misses + (*it)->computeACMR(a_cacheSize) * meshTriangles;
+        numTriangles = numTriangles + meshTriangles;
+    }
+
+    return ((numTriangles > 0) ? misses / numTriangles : 0.0);
+}
+
+
+//==============================================================================
+/*!
+    This method optimizes all meshes for rendering. Vertices are welded, then
+    triangles are reordered for the post-transform vertex cache and vertices
+    in the order triangles use them.
+
+    __IMPORTANT:__ \n
+    Vertex and triangle indices change. Any collision detector must be
+    rebuilt afterwards.
+
+    \param  a_weldTolerance  Largest difference of any value of two welded vertices.
+    \param  a_cacheSize      Number of vertices of the cache.
+
+    \return Number of vertices and cache miss ratio of all meshes before and after.
+*/
+//==============================================================================
+cMeshOptimizationReport cMultiMesh::optimize(const double a_weldTolerance,
+                                             const unsigned int a_cacheSize)
+{
+    cMeshOptimizationReport report;
+
+    vector<cMesh*>::iterator it;
+    for (it = m_meshes->begin(); it < m_meshes->end(); it++)
+    {
+        report.add((*it)->optimize(a_weldTolerance, a_cacheSize));
+    }
+
+    return (report);
+}
+
+
 //==============================================================================
 /*!
     This method computes the global position of all vertices.
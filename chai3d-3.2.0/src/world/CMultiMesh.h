@@ -420,6 +420,20 @@ public:
     void scaleXYZ(const double a_scaleX, const double a_scaleY, const double a_scaleZ);
 
 
+    //--------------------------------------------------------------------------
+    // PUBLIC METHODS - OPTIMIZATION:
+    //--------------------------------------------------------------------------
+
+public:
+
+    //! This method computes the average cache miss ratio of the triangles of all meshes.
+    double computeACMR(const unsigned int a_cacheSize = C_VERTEX_CACHE_SIZE);
+
+    //! This method welds vertices, then reorders triangles and vertices of all meshes for the vertex cache.
+    cMeshOptimizationReport optimize(const double a_weldTolerance = 0.0,
+        const unsigned int a_cacheSize = C_VERTEX_CACHE_SIZE);
+
+
     //--------------------------------------------------------------------------
     // PROTECTED METHODS:
     //--------------------------------------------------------------------------
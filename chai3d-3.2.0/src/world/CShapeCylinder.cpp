@@ -89,12 +89,9 @@ cShapeCylinder::cShapeCylinder(const double a_baseRadius,
         m_material = a_material;
     }
 
-    // allocate a new OpenGL quadric object for rendering
-    #ifdef C_USE_OPENGL
-    m_quadric = gluNewQuadric ();
-    #else
-    m_quadric = NULL;
-    #endif
+    // the tessellation is taken from the cache when the cylinder is first rendered
+    m_tessellation = nullptr;
+    m_useLevelOfDetail = false;
 
     // initialize boundary box
     updateBoundaryBox ();
@@ -108,10 +105,8 @@ cShapeCylinder::cShapeCylinder(const double a_baseRadius,
 //==============================================================================.
 cShapeCylinder::~cShapeCylinder()
 {
-    // deallocate OpenGL quadric object used for rendering
-    #ifdef C_USE_OPENGL
-    gluDeleteQuadric(m_quadric);
-    #endif
+    // release tessellation used for rendering
+    cTessellationCache::release(m_tessellation);
 }
 
 
@@ -175,6 +170,7 @@ void cShapeCylinder::copyShapeCylinderProperties(cShapeCylinder* a_obj,
     a_obj->m_baseRadius = m_baseRadius;
     a_obj->m_topRadius = m_topRadius;
     a_obj->m_height = m_height;
+    a_obj->m_useLevelOfDetail = m_useLevelOfDetail;
 }
 
 
@@ -210,38 +206,30 @@ void cShapeCylinder::render(cRenderOptions& a_options)
             m_material->render(a_options);
         }
 
-        // set rendering style
-        gluQuadricDrawStyle (m_quadric, GLU_FILL);
-
-        // set normal-rendering mode
-        gluQuadricNormals (m_quadric, GLU_SMOOTH);
-
         // render texture property if defined
-        if ((m_texture != nullptr) && (m_useTextureMapping))
+        bool useTexture = ((m_texture != nullptr) && (m_useTextureMapping));
+        if (useTexture)
         {
             // activate texture
             m_texture->renderInitialize(a_options);
+        }
 
-            // generate texture coordinates
-            gluQuadricTexture(m_quadric, GL_TRUE);
+        // select resolution
+        unsigned int resolution = 36;
+        if (m_useLevelOfDetail)
+        {
+            resolution = cTessellationCache::selectResolution(cMax3(m_baseRadius, m_topRadius, 0.5 * m_height), resolution);
         }
 
-        // render a cylinder
-        gluCylinder(m_quadric, m_baseRadius, m_topRadius, m_height, 36, 36);
+        // render the closed cylinder, tessellated again only if its size or resolution changed
+        m_tessellation = cTessellationCache::acquire(m_tessellation, cTessellationKey(C_TESSELLATION_CYLINDER, m_baseRadius, m_topRadius, m_height, resolution));
+        m_tessellation->render(useTexture);
 
         // turn off texture rendering
-        if ((m_texture != nullptr) && (m_useTextureMapping))
+        if (useTexture)
         {
             m_texture->renderFinalize(a_options);
         }
-
-        // close the cylinder
-        gluQuadricOrientation (m_quadric, GLU_INSIDE);
-        gluDisk               (m_quadric, 0.0, m_baseRadius, 36, 36);
-        glTranslated          (0.0, 0.0, m_height);
-        gluQuadricOrientation (m_quadric, GLU_OUTSIDE);
-        gluDisk               (m_quadric, 0.0, m_topRadius, 36, 36);
-        glTranslated          (0.0, 0.0, -m_height);
     }
 
 
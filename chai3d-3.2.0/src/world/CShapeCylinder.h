@@ -48,6 +48,7 @@
 #include "world/CGenericObject.h"
 #include "materials/CMaterial.h"
 #include "materials/CTexture2d.h"
+#include "graphics/CTessellationCache.h"
 //------------------------------------------------------------------------------
 #ifdef C_USE_OPENGL
 #ifdef MACOSX
@@ -131,6 +132,12 @@ public:
     //! This method returns the height of the cylinder.
     inline double getHeight() const { return (m_height); }
 
+    //! This method enables or disables the level of detail, which lowers the resolution of the shape when it is small on screen.
+    void setUseLevelOfDetail(const bool a_useLevelOfDetail) { m_useLevelOfDetail = a_useLevelOfDetail; }
+
+    //! This method returns __true__ if the level of detail is enabled.
+    bool getUseLevelOfDetail() const { return (m_useLevelOfDetail); }
+
 
     //--------------------------------------------------------------------------
     // PROTECTED VIRTUAL METHODS:
@@ -188,8 +195,11 @@ protected:
     //! height of cylinder.
     double m_height;
 
-    //! rendering object.
-    GLUquadricObj *m_quadric;
+    //! Cached tessellation the shape was last rendered with.
+    cTessellation* m_tessellation;
+
+    //! If __true__, then the resolution is selected from the size of the shape on screen.
+    bool m_useLevelOfDetail;
 };
 
 //------------------------------------------------------------------------------
@@ -85,12 +85,9 @@ cShapeSphere::cShapeSphere(const double& a_radius,
         m_material = a_material;
     }
 
-    // allocate a new OpenGL quadric object for rendering
-#ifdef C_USE_OPENGL
-    m_quadric = gluNewQuadric();
-#else
-    m_quadric = NULL;
-#endif
+    // the tessellation is taken from the cache when the sphere is first rendered
+    m_tessellation = nullptr;
+    m_useLevelOfDetail = false;
 };
 
 
@@ -101,10 +98,8 @@ cShapeSphere::cShapeSphere(const double& a_radius,
 //==============================================================================.
 cShapeSphere::~cShapeSphere()
 {
-    // deallocate OpenGL quadric object used for rendering
-#ifdef C_USE_OPENGL
-    gluDeleteQuadric(m_quadric);
-#endif
+    // release tessellation used for rendering
+    cTessellationCache::release(m_tessellation);
 }
 
 
@@ -169,6 +164,7 @@ void cShapeSphere::copyShapeSphereProperties(cShapeSphere* a_obj,
 
     // copy properties of cShapeSphere
     a_obj->m_radius = m_radius;
+    a_obj->m_useLevelOfDetail = m_useLevelOfDetail;
 }
 
 
@@ -224,27 +220,27 @@ void cShapeSphere::render(cRenderOptions& a_options)
             m_material->render(a_options);
         }
 
-        // set rendering style
-        gluQuadricDrawStyle (m_quadric, GLU_FILL);
-
-        // set normal-rendering mode
-        gluQuadricNormals (m_quadric, GLU_SMOOTH);
-
         // render texture property if defined
-        if ((m_texture != nullptr) && (m_useTextureMapping))
+        bool useTexture = ((m_texture != nullptr) && (m_useTextureMapping));
+        if (useTexture)
         {
             // activate texture
             m_texture->renderInitialize(a_options);
+        }
 
-            // generate texture coordinates
-            gluQuadricTexture(m_quadric, GL_TRUE);
+        // select resolution
+        unsigned int resolution = 36;
+        if (m_useLevelOfDetail)
+        {
+            resolution = cTessellationCache::selectResolution(m_radius, resolution);
         }
 
-        // render a sphere
-        gluSphere(m_quadric, m_radius, 36, 36);
+        // render a sphere, tessellated again only if its radius or resolution changed
+        m_tessellation = cTessellationCache::acquire(m_tessellation, cTessellationKey(C_TESSELLATION_SPHERE, m_radius, 0.0, 0.0, resolution));
+        m_tessellation->render(useTexture);
 
         // turn off texture rendering
-        if ((m_texture != nullptr) && (m_useTextureMapping))
+        if (useTexture)
         {
             m_texture->renderFinalize(a_options);
         }
@@ -48,6 +48,7 @@
 #include "world/CGenericObject.h"
 #include "materials/CMaterial.h"
 #include "materials/CTexture2d.h"
+#include "graphics/CTessellationCache.h"
 //------------------------------------------------------------------------------
 #ifdef C_USE_OPENGL
 #ifdef MACOSX
@@ -117,6 +118,12 @@ public:
     //! This method returns the radius of the sphere.
     inline double getRadius() const { return (m_radius); }
 
+    //! This method enables or disables the level of detail, which lowers the resolution of the shape when it is small on screen.
+    void setUseLevelOfDetail(const bool a_useLevelOfDetail) { m_useLevelOfDetail = a_useLevelOfDetail; }
+
+    //! This method returns __true__ if the level of detail is enabled.
+    bool getUseLevelOfDetail() const { return (m_useLevelOfDetail); }
+
 
     //--------------------------------------------------------------------------
     // PROTECTED METHODS:
@@ -168,8 +175,11 @@ protected:
     //! Radius of sphere.
     double m_radius;
 
-    //! rendering object.
-    GLUquadricObj *m_quadric;
+    //! Cached tessellation the shape was last rendered with.
+    cTessellation* m_tessellation;
+
+    //! If __true__, then the resolution is selected from the size of the shape on screen.
+    bool m_useLevelOfDetail;
 };
 
 //------------------------------------------------------------------------------
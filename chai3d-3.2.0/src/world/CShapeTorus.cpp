@@ -71,6 +71,10 @@ cShapeTorus::cShapeTorus(const double& a_innerRadius,
     // set resolution of graphical model
     m_resolution = 64;
 
+    // the tessellation is taken from the cache when the torus is first rendered
+    m_tessellation = nullptr;
+    m_useLevelOfDetail = false;
+
     // set material properties
     if (a_material == nullptr)
     {
@@ -88,6 +92,18 @@ cShapeTorus::cShapeTorus(const double& a_innerRadius,
 };
 
 
+//==============================================================================
+/*!
+    Destructor of cShapeTorus.
+*/
+//==============================================================================
+cShapeTorus::~cShapeTorus()
+{
+    // release tessellation used for rendering
+    cTessellationCache::release(m_tessellation);
+}
+
+
 //==============================================================================
 /*!
     This method creates a copy of itself.
@@ -148,6 +164,7 @@ void cShapeTorus::copyShapeTorusProperties(cShapeTorus* a_obj,
     a_obj->m_innerRadius = m_innerRadius;
     a_obj->m_outerRadius = m_outerRadius;
     a_obj->m_resolution = m_resolution;
+    a_obj->m_useLevelOfDetail = m_useLevelOfDetail;
 }
 
 
@@ -221,17 +238,24 @@ void cShapeTorus::render(cRenderOptions& a_options)
             }
         }
 
-        // draw torus
-        if (!m_displayList.render(m_useDisplayList))
+        // select resolution
+        unsigned int resolution = m_resolution;
+        if (m_useLevelOfDetail)
+        {
+            resolution = cTessellationCache::selectResolution(m_outerRadius + m_innerRadius, resolution);
+        }
+
+        // draw torus from a cached tessellation, built again only if its size or resolution changed
+        if (m_useDisplayList)
+        {
+            m_tessellation = cTessellationCache::acquire(m_tessellation, cTessellationKey(C_TESSELLATION_TORUS, m_innerRadius, m_outerRadius, 0.0, resolution));
+            m_tessellation->render(false);
+        }
+
+        // or directly if no retained geometry is requested
+        else
         {
-            // create display list if requested
-            m_displayList.begin(m_useDisplayList);
-
-            // draw object
-            cDrawSolidTorus(m_innerRadius, m_outerRadius, m_resolution, m_resolution);
-            
-            // finalize display list
-            m_displayList.end(true);
+            cDrawSolidTorus(m_innerRadius, m_outerRadius, resolution, resolution);
         }
   
         // turn off texture rendering
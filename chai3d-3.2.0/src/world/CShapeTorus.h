@@ -48,6 +48,7 @@
 #include "materials/CMaterial.h"
 #include "materials/CTexture2d.h"
 #include "world/CGenericObject.h"
+#include "graphics/CTessellationCache.h"
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -72,7 +73,10 @@ namespace chai3d {
     This class implements a 3D shape torus.
 
     \details
-    This class implements a 3D shape torus.
+    This class implements a 3D shape torus. When display lists are enabled
+    (the default), the torus is drawn from a tessellation shared through
+    cTessellationCache instead of a display list of its own. Otherwise it is
+    drawn directly on every render.
 */
 //==============================================================================
 class cShapeTorus : public cGenericObject
@@ -89,7 +93,7 @@ public:
                 cMaterialPtr a_material = cMaterialPtr());
 
     //! Destructor of cShapeTorus.
-    virtual ~cShapeTorus() {};
+    virtual ~cShapeTorus();
 
 
     //--------------------------------------------------------------------------
@@ -114,6 +118,12 @@ public:
     //! This method returns the outer radius of the torus.
     inline double getOuterRadius() const { return (m_outerRadius); }
 
+    //! This method enables or disables the level of detail, which lowers the resolution of the shape when it is small on screen.
+    void setUseLevelOfDetail(const bool a_useLevelOfDetail) { m_useLevelOfDetail = a_useLevelOfDetail; }
+
+    //! This method returns __true__ if the level of detail is enabled.
+    bool getUseLevelOfDetail() const { return (m_useLevelOfDetail); }
+
 
     //--------------------------------------------------------------------------
     // PROTECTED VIRTUAL METHODS:
@@ -170,6 +180,12 @@ protected:
 
     //! Resolution of the graphical model.
     unsigned int m_resolution;
+
+    //! Cached tessellation the shape was last rendered with.
+    cTessellation* m_tessellation;
+
+    //! If __true__, then the resolution is selected from the size of the shape on screen.
+    bool m_useLevelOfDetail;
 };
 
 //------------------------------------------------------------------------------